@@ -15,6 +15,8 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <algorithm>
+
 #include "FpsMeter.hxx"
 
 using namespace std::chrono;
@@ -33,6 +35,10 @@ void FpsMeter::reset(uInt32 garbageFrameLimit)
   myFps = 0;
   myGarbageFrameCounter = 0;
   myGarbageFrameLimit = garbageFrameLimit;
+
+  myCurrentFrameTimes.fill(0);
+  myFrameTimesOffset = 0;
+  myFrameTimesCount = 0;
 }
 
 void FpsMeter::render(uInt32 frameCount)
@@ -71,3 +77,39 @@ float FpsMeter::fps() const
 {
   return myFps;
 }
+
+void FpsMeter::addStageTime(Stage stage, double seconds)
+{
+  myCurrentFrameTimes[static_cast<uInt32>(stage)] += static_cast<float>(seconds * 1000);
+}
+
+void FpsMeter::commitFrameTimes()
+{
+  myFrameTimes[(myFrameTimesOffset + myFrameTimesCount) % FRAME_TIMES_SIZE] = myCurrentFrameTimes;
+
+  if (myFrameTimesCount < FRAME_TIMES_SIZE) myFrameTimesCount++;
+  else myFrameTimesOffset = (myFrameTimesOffset + 1) % FRAME_TIMES_SIZE;
+
+  myCurrentFrameTimes.fill(0);
+}
+
+float FpsMeter::frameTime(uInt32 frame, Stage stage) const
+{
+  if (frame >= myFrameTimesCount) return 0;
+
+  return myFrameTimes[(myFrameTimesOffset + frame) % FRAME_TIMES_SIZE][static_cast<uInt32>(stage)];
+}
+
+float FpsMeter::stagePercentile(Stage stage, uInt32 percentile) const
+{
+  if (myFrameTimesCount == 0) return 0;
+
+  std::array<float, FRAME_TIMES_SIZE> samples;
+  for (uInt32 i = 0; i < myFrameTimesCount; ++i)
+    samples[i] = myFrameTimes[i][static_cast<uInt32>(stage)];
+
+  const uInt32 n = std::min(myFrameTimesCount - 1, (myFrameTimesCount * percentile) / 100);
+  std::nth_element(samples.begin(), samples.begin() + n, samples.begin() + myFrameTimesCount);
+
+  return samples[n];
+}
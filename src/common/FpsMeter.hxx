@@ -18,12 +18,25 @@
 #ifndef FPS_METER_HXX
 #define FPS_METER_HXX
 
+#include <array>
 #include <chrono>
 
 #include "bspf.hxx"
 
 class FpsMeter
 {
+  public:
+
+    // Host-side phases of a main loop iteration, used for the frame time
+    // breakdown. Emulation and audio run on their own threads and may
+    // overlap with conversion and presentation.
+    enum class Stage: uInt8 {
+      emulation, conversion, present, audio, runAhead, idle, numStages
+    };
+
+    static constexpr uInt32 NUM_STAGES = static_cast<uInt32>(Stage::numStages);
+    static constexpr uInt32 FRAME_TIMES_SIZE = 240;
+
   public:
 
     explicit FpsMeter(uInt32 queueSize);
@@ -34,6 +47,17 @@ class FpsMeter
 
     float fps() const;
 
+    void addStageTime(Stage stage, double seconds);
+
+    void commitFrameTimes();
+
+    uInt32 numFrameTimes() const { return myFrameTimesCount; }
+
+    // Stage time in ms, frame 0 is the oldest retained sample
+    float frameTime(uInt32 frame, Stage stage) const;
+
+    float stagePercentile(Stage stage, uInt32 percentile) const;
+
   private:
 
     struct entry {
@@ -54,6 +78,11 @@ class FpsMeter
 
     float myFps;
 
+    std::array<float, NUM_STAGES> myCurrentFrameTimes;
+    std::array<std::array<float, NUM_STAGES>, FRAME_TIMES_SIZE> myFrameTimes;
+    uInt32 myFrameTimesOffset;
+    uInt32 myFrameTimesCount;
+
   private:
 
     FpsMeter(const FpsMeter&) = delete;
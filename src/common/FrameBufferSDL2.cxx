@@ -392,3 +392,18 @@ void FrameBufferSDL2::clear()
   invalidate();
   renderToScreen();
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 FrameBufferSDL2::refreshRate() const
+{
+  ASSERT_MAIN_THREAD;
+
+  const int displayIndex = myWindow ? SDL_GetWindowDisplayIndex(myWindow) : 0;
+  SDL_DisplayMode mode;
+
+  if(displayIndex >= 0 && SDL_GetCurrentDisplayMode(displayIndex, &mode) == 0 &&
+     mode.refresh_rate > 0)
+    return mode.refresh_rate;
+
+  return 0;
+}
@@ -102,6 +102,11 @@ class FrameBufferSDL2 : public FrameBuffer
     */
     void clear() override;
 
+    /**
+      Answers the refresh rate of the display showing the window
+    */
+    uInt32 refreshRate() const override;
+
   protected:
     //////////////////////////////////////////////////////////////////////
     // The following are derived from protected methods in FrameBuffer.hxx
@@ -0,0 +1,152 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <algorithm>
+#include <limits>
+
+#include "Console.hxx"
+#include "Control.hxx"
+#include "DispatchResult.hxx"
+#include "Switches.hxx"
+#include "TIA.hxx"
+#include "Tracer.hxx"
+
+#include "InputLog.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+InputLog::InputLog()
+  : myPortBytes(0),
+    myReplayPos(0),
+    myReplaying(false),
+    myRewindCycles(std::numeric_limits<uInt64>::max())
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void InputLog::replay(Console& console, uInt64 cycles)
+{
+  TRACE_SCOPE("InputLog::replay");
+
+  TIA& tia = console.tia();
+
+  // Entries up to the current cycles are already part of the loaded state
+  myReplayPos = std::upper_bound(myEntries.cbegin(), myEntries.cend(), tia.cycles(),
+    [](uInt64 c, const Entry& entry) { return c < entry.cycles; }) - myEntries.cbegin();
+  myReplaying = true;
+
+  while(tia.cycles() < cycles)
+  {
+    // Stop exactly where the ports were updated originally; emulation
+    // always halts at the same instruction boundaries
+    uInt64 next = cycles;
+    if(myReplayPos < myEntries.size())
+      next = std::min(next, myEntries[myReplayPos].cycles);
+
+    if(next > tia.cycles())
+    {
+      const uInt64 startCycles = tia.cycles();
+      DispatchResult result;
+
+      tia.update(result, next - startCycles);
+      if(result.getStatus() != DispatchResult::Status::ok || tia.cycles() == startCycles)
+        break;
+    }
+
+    // Apply all entries reached so far
+    console.riot().update();
+  }
+
+  myReplaying = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void InputLog::prune(uInt64 cycles)
+{
+  while(!myEntries.empty() && myEntries.front().cycles < cycles)
+  {
+    myPortBytes -= myEntries.front().ports.size();
+    myEntries.pop_front();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void InputLog::clear()
+{
+  myEntries.clear();
+  myPortBytes = 0;
+  myRewindCycles = std::numeric_limits<uInt64>::max();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool InputLog::replayPorts(const ConsoleIO& console, uInt64 cycles)
+{
+  if(!myReplaying)
+    return false;
+
+  // Apply the latest entry up to now; without one, the ports stay unchanged
+  size_t pos = myReplayPos;
+  while(pos < myEntries.size() && myEntries[pos].cycles <= cycles)
+    ++pos;
+
+  if(pos != myReplayPos)
+  {
+    myReplayPos = pos;
+
+    const ByteArray& ports = myEntries[pos - 1].ports;
+    myBuffer.rewind();
+    myBuffer.putByteArray(ports.data(), uInt32(ports.size()));
+    console.leftController().load(myBuffer);
+    console.rightController().load(myBuffer);
+    console.switches().load(myBuffer);
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void InputLog::recordPorts(const ConsoleIO& console, uInt64 cycles)
+{
+  // Discard all entries of a timeline which has been left
+  const uInt64 lastCycles = std::min(cycles, myRewindCycles);
+  while(!myEntries.empty() && myEntries.back().cycles > lastCycles)
+  {
+    myPortBytes -= myEntries.back().ports.size();
+    myEntries.pop_back();
+  }
+  myRewindCycles = std::numeric_limits<uInt64>::max();
+
+  myBuffer.rewind();
+  if(!console.leftController().save(myBuffer) ||
+     !console.rightController().save(myBuffer) ||
+     !console.switches().save(myBuffer))
+    return;
+
+  // Only changes need to be logged
+  const size_t size = myBuffer.size();
+  if(!myEntries.empty() && myEntries.back().ports.size() == size &&
+     std::equal(myEntries.back().ports.cbegin(), myEntries.back().ports.cend(), myBuffer.data()))
+    return;
+
+  if(myEntries.empty() || myEntries.back().cycles != cycles)
+    myEntries.emplace_back();
+
+  Entry& entry = myEntries.back();
+  myPortBytes += size;
+  myPortBytes -= entry.ports.size();
+  entry.cycles = cycles;
+  entry.ports.assign(myBuffer.data(), myBuffer.data() + size);
+}
@@ -0,0 +1,115 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef INPUT_LOG_HXX
+#define INPUT_LOG_HXX
+
+class Console;
+
+#include <deque>
+
+#include "M6532.hxx"
+#include "Serializer.hxx"
+#include "bspf.hxx"
+
+/**
+  This class logs the state of the controllers and console switches each
+  time it changes, and replays it while re-emulating from an earlier save
+  state.  Together with the save state, this reproduces every frame in
+  between deterministically, since all other emulation state (including
+  the random generator) is part of the save state.  The logged controller
+  state is the one of their save states, i.e. the pins plus the internal
+  state of controllers which change it while the game accesses them
+  (mice, trackballs and the MindLink).
+
+  Entries are kept in order of their cycles.  Whenever the ports are
+  updated at an earlier time than the latest entry (e.g. after a rewind),
+  all later entries are discarded first.
+*/
+class InputLog : public M6532::PortHandler
+{
+  public:
+    InputLog();
+    ~InputLog() override = default;
+
+  public:
+    /**
+      Re-emulate from the current state up to the given cycles, applying
+      the logged port states on the way.
+
+      @param console  The console to re-emulate
+      @param cycles   The cycles to stop at
+    */
+    void replay(Console& console, uInt64 cycles);
+
+    /**
+      Discard all entries after the given cycles once the ports are updated
+      again; until then, these entries can still be replayed.
+    */
+    void rewindTo(uInt64 cycles) { myRewindCycles = cycles; }
+
+    /**
+      Discard all entries which are no longer needed for replaying from
+      save states at or after the given cycles.
+    */
+    void prune(uInt64 cycles);
+
+    /**
+      Discard all entries.
+    */
+    void clear();
+
+    /**
+      Number of bytes currently used by the log.
+    */
+    size_t size() const { return myEntries.size() * sizeof(Entry) + myPortBytes; }
+
+  public:
+    /** M6532::PortHandler */
+    bool replayPorts(const ConsoleIO& console, uInt64 cycles) override;
+    void recordPorts(const ConsoleIO& console, uInt64 cycles) override;
+
+  private:
+    struct Entry {
+      uInt64 cycles;
+      ByteArray ports;  // saved state of both controllers and the switches
+    };
+
+    std::deque<Entry> myEntries;
+
+    // Total size of the saved port states of all entries
+    size_t myPortBytes;
+
+    // While replaying, the next entry to be applied
+    size_t myReplayPos;
+    bool myReplaying;
+
+    // Entries after these cycles are discarded on the next update
+    uInt64 myRewindCycles;
+
+    // Scratch buffer for saving/loading the ports
+    Serializer myBuffer;
+
+  private:
+    // Following constructors and assignment operators not supported
+    InputLog(const InputLog&) = delete;
+    InputLog(InputLog&&) = delete;
+    InputLog& operator=(const InputLog&) = delete;
+    InputLog& operator=(InputLog&&) = delete;
+};
+
+#endif
@@ -543,14 +543,21 @@ bool PhysicalKeyboardHandler::handleAltEvent(StellaKey key, StellaMod mod, bool
           myOSystem.console().toggleJitter();
           break;
 
-        case KBDK_L:
-          myOSystem.frameBuffer().toggleFrameStats();
+        case KBDK_L:  // Alt-l toggles frame stats, Shift-Alt-l the frame time breakdown
+          if(StellaModTest::isShift(mod))
+            myOSystem.frameBuffer().toggleFrameTimes();
+          else
+            myOSystem.frameBuffer().toggleFrameStats();
           break;
 
         case KBDK_T:  // Alt-t toggles Time Machine
           myOSystem.state().toggleTimeMachine();
           break;
 
+        case KBDK_F:  // Alt-f toggles turbo mode
+          myHandler.handleEvent(Event::TurboMode, pressed);
+          break;
+
     #ifdef PNG_SUPPORT
         case KBDK_S:
           myOSystem.png().toggleContinuousSnapshots(StellaModTest::isShift(mod));
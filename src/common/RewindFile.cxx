@@ -0,0 +1,275 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "Serializer.hxx"
+
+#include "RewindFile.hxx"
+
+#define FILE_HEADER "06000002timemachine"
+
+using std::ios;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RewindFile::RewindFile()
+  : myEnd(0)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindFile::open(const string& filename, const string& md5, bool resume)
+{
+  myFilename = filename;
+  myMD5 = md5;
+  myIndex.clear();
+
+  if(resume && readIndex())
+  {
+    // New states overwrite the old index, so the file is invalid until
+    // it is closed again
+    myStream.open(filename, ios::in | ios::out | ios::binary);
+    if(myStream.is_open() && writeHeader(myStream, 0, 0))
+      return true;
+
+    myIndex.clear();
+    myStream.close();
+    myStream.clear();
+  }
+
+  // Start anew
+  myStream.open(filename, ios::in | ios::out | ios::binary | ios::trunc);
+  if(!myStream.is_open() || !writeHeader(myStream, 0, 0))
+  {
+    myStream.close();
+    return false;
+  }
+  myEnd = uInt64(myStream.tellp());
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindFile::close(const vector<Entry>& index)
+{
+  if(!myStream.is_open())
+    return;
+
+  Serializer out;
+  out.putInt(uInt32(index.size()));
+  for(const Entry& entry: index)
+  {
+    out.putLong(entry.keyframe.offset);
+    out.putInt(entry.keyframe.size);
+    out.putLong(entry.delta.offset);
+    out.putInt(entry.delta.size);
+    out.putInt(entry.size);
+    out.putInt(entry.keyframeDistance);
+    out.putLong(entry.keyframeCycles);
+    out.putLong(entry.cycles);
+    out.putString(entry.message);
+    out.putInt(uInt32(entry.thumbnail.size()));
+    out.putByteArray(entry.thumbnail.data(), uInt32(entry.thumbnail.size()));
+  }
+
+  const Blob blob = append(out.data(), uInt32(out.size()));
+  if(blob.offset)
+    writeHeader(myStream, blob.offset, blob.size);
+
+  myStream.close();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RewindFile::Blob RewindFile::append(const uInt8* data, uInt32 size)
+{
+  Blob blob;
+
+  myStream.seekp(myEnd);
+  myStream.write(reinterpret_cast<const char*>(data), size);
+  if(myStream)
+  {
+    blob.offset = myEnd;
+    blob.size = size;
+    myEnd += size;
+  }
+  else
+    myStream.clear();
+
+  return blob;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindFile::read(const Blob& blob, uInt8* data)
+{
+  if(blob.offset == 0 || blob.offset + blob.size > myEnd)
+    return false;
+
+  myStream.seekg(blob.offset);
+  myStream.read(reinterpret_cast<char*>(data), blob.size);
+  if(myStream)
+    return true;
+
+  myStream.clear();
+  return false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindFile::compact(vector<Blob>& blobs)
+{
+  const string filename = myFilename + ".tmp";
+  vector<Blob> compacted(blobs.size());
+
+  // Copy the states to a new file first, so nothing is lost on errors
+  ofstream out(filename, ios::binary | ios::trunc);
+  bool ok = out.is_open() && writeHeader(out, 0, 0);
+  uInt64 end = ok ? uInt64(out.tellp()) : 0;
+
+  for(size_t i = 0; ok && i < blobs.size(); ++i)
+  {
+    myBuffer.resize(blobs[i].size);
+    ok = read(blobs[i], myBuffer.data());
+    out.write(reinterpret_cast<const char*>(myBuffer.data()), blobs[i].size);
+
+    compacted[i].offset = end;
+    compacted[i].size = blobs[i].size;
+    end += blobs[i].size;
+  }
+  ok = ok && out;
+  out.close();
+
+  if(!ok)
+  {
+    std::remove(filename.c_str());
+    return false;
+  }
+
+  // Replace the file; renaming over an existing file fails on some systems,
+  // so there the original is moved out of the way first, and only deleted
+  // once the new file is in place
+  myStream.close();
+  bool replaced = std::rename(filename.c_str(), myFilename.c_str()) == 0;
+  if(!replaced)
+  {
+    const string backup = myFilename + ".bak";
+    std::remove(backup.c_str());
+    if(std::rename(myFilename.c_str(), backup.c_str()) == 0)
+    {
+      replaced = std::rename(filename.c_str(), myFilename.c_str()) == 0;
+      if(replaced)
+        std::remove(backup.c_str());
+      else
+        std::rename(backup.c_str(), myFilename.c_str());
+    }
+  }
+  if(!replaced)
+    std::remove(filename.c_str());
+
+  myStream.clear();
+  myStream.open(myFilename, ios::in | ios::out | ios::binary);
+  if(!myStream.is_open() || !replaced)
+    return false;
+
+  blobs = std::move(compacted);
+  myEnd = end;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindFile::readIndex()
+{
+  try
+  {
+    // The header has a fixed size for a given MD5
+    Serializer expected;
+    createHeader(expected, 0, 0);
+
+    ByteArray data(expected.size());
+    ifstream in(myFilename, ios::binary);
+    in.read(reinterpret_cast<char*>(data.data()), data.size());
+    if(!in)
+      return false;
+
+    Serializer header(static_cast<const uInt8*>(data.data()), data.size());
+    if(header.getString() != FILE_HEADER || header.getString() != myMD5)
+      return false;
+
+    const uInt64 indexOffset = header.getLong();
+    const uInt32 indexSize = header.getInt();
+    if(indexOffset == 0)
+      return false;
+
+    data.resize(indexSize);
+    in.seekg(indexOffset);
+    in.read(reinterpret_cast<char*>(data.data()), indexSize);
+    if(!in)
+      return false;
+
+    Serializer index(static_cast<const uInt8*>(data.data()), data.size());
+    const uInt32 count = index.getInt();
+    myIndex.resize(count);
+    for(Entry& entry: myIndex)
+    {
+      entry.keyframe.offset = index.getLong();
+      entry.keyframe.size = index.getInt();
+      entry.delta.offset = index.getLong();
+      entry.delta.size = index.getInt();
+      entry.size = index.getInt();
+      entry.keyframeDistance = index.getInt();
+      entry.keyframeCycles = index.getLong();
+      entry.cycles = index.getLong();
+      entry.message = index.getString();
+      const uInt32 thumbnailSize = index.getInt();
+      if(thumbnailSize > indexSize)
+        throw runtime_error("RewindFile: invalid index");
+      entry.thumbnail.resize(thumbnailSize);
+      index.getByteArray(entry.thumbnail.data(), thumbnailSize);
+
+      if(entry.keyframe.offset == 0 || entry.keyframe.offset + entry.keyframe.size > indexOffset ||
+         entry.delta.offset + entry.delta.size > indexOffset)
+        throw runtime_error("RewindFile: invalid index");
+    }
+    myEnd = indexOffset;
+  }
+  catch(...)
+  {
+    myIndex.clear();
+    return false;
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindFile::createHeader(Serializer& header, uInt64 indexOffset, uInt32 indexSize) const
+{
+  header.putString(FILE_HEADER);
+  header.putString(myMD5);
+  header.putLong(indexOffset);
+  header.putInt(indexSize);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindFile::writeHeader(ostream& out, uInt64 indexOffset, uInt32 indexSize) const
+{
+  Serializer header;
+  createHeader(header, indexOffset, indexSize);
+
+  out.seekp(0);
+  out.write(reinterpret_cast<const char*>(header.data()), header.size());
+  out.flush();
+
+  return bool(out);
+}
@@ -0,0 +1,164 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef REWIND_FILE_HXX
+#define REWIND_FILE_HXX
+
+class Serializer;
+
+#include "bspf.hxx"
+
+/**
+  This class keeps the Time Machine states of a ROM on disk, so that they
+  survive the session.
+
+  The file starts with a header (format, ROM MD5 and location of the
+  index), followed by the encoded states (keyframes and deltas), which are
+  appended one by one while the emulation runs.  When the file is closed,
+  an index of all states still in use is appended, and the header is
+  updated to point to it.  Until then, the header points to no index, so
+  an incomplete file is never restored.  The index also holds the small
+  thumbnails of the states, which thus need not be decoded to be shown.
+
+  Opening a file only reads its index; the states themselves are read on
+  demand.  The data of states which have been removed stays in the file
+  until it is compacted.
+*/
+class RewindFile
+{
+  public:
+    // Location of an encoded state in the file (offset 0 if not stored)
+    struct Blob {
+      uInt64 offset;
+      uInt32 size;
+
+      Blob() : offset(0), size(0) { }
+    };
+
+    // Index entry of a state
+    struct Entry {
+      Blob keyframe;            // full save state this one is based on
+      Blob delta;               // difference to the keyframe (none for keyframes)
+      uInt32 size;              // size of the decoded save state
+      uInt32 keyframeDistance;  // number of states since the keyframe
+      uInt64 keyframeCycles;    // cycles of the keyframe
+      uInt64 cycles;            // cycles since emulation started
+      string message;           // describes save state origin
+      ByteArray thumbnail;      // downscaled frame shown in the timeline
+
+      Entry() : size(0), keyframeDistance(0), keyframeCycles(0), cycles(0) { }
+    };
+
+    RewindFile();
+    ~RewindFile() = default;
+
+  public:
+    /**
+      Open the file for the ROM with the given MD5.  When resuming, the
+      index of the previous session is read (see index()); otherwise, or
+      if the file is not valid for the ROM, it is started anew.
+
+      @param filename  The name of the file
+      @param md5       The MD5 of the ROM
+      @param resume    Whether to read the index of the previous session
+
+      @return  False if the file can't be opened or created
+    */
+    bool open(const string& filename, const string& md5, bool resume);
+
+    /**
+      Write the index of the given states, and close the file.
+
+      @param index  The states still in use
+    */
+    void close(const vector<Entry>& index);
+
+    /**
+      The index of the previous session, if the file was resumed.
+    */
+    const vector<Entry>& index() const { return myIndex; }
+
+    /**
+      Append an encoded state.
+
+      @return  The location of the data (offset 0 on errors)
+    */
+    Blob append(const uInt8* data, uInt32 size);
+
+    /**
+      Read an encoded state.
+
+      @param blob  The location of the data
+      @param data  Receives the data (blob.size bytes)
+
+      @return  False on errors
+    */
+    bool read(const Blob& blob, uInt8* data);
+
+    /**
+      Rewrite the file with the given states only, dropping the data of all
+      others.  The locations are updated in place.
+
+      @return  False on errors; the file is unchanged then
+    */
+    bool compact(vector<Blob>& blobs);
+
+    /**
+      The current size of the file.
+    */
+    uInt64 size() const { return myEnd; }
+
+  private:
+    /**
+      Read the header and index of an existing file.
+    */
+    bool readIndex();
+
+    /**
+      Create the header (pointing to the given index).
+    */
+    void createHeader(Serializer& header, uInt64 indexOffset, uInt32 indexSize) const;
+
+    /**
+      Write the header (pointing to the given index) to the given stream.
+    */
+    bool writeHeader(ostream& out, uInt64 indexOffset, uInt32 indexSize) const;
+
+  private:
+    // The file and its MD5
+    string myFilename;
+    string myMD5;
+    fstream myStream;
+
+    // End of the data written so far
+    uInt64 myEnd;
+
+    // The index of the previous session
+    vector<Entry> myIndex;
+
+    // Scratch buffer for copying states
+    ByteArray myBuffer;
+
+  private:
+    // Following constructors and assignment operators not supported
+    RewindFile(const RewindFile&) = delete;
+    RewindFile(RewindFile&&) = delete;
+    RewindFile& operator=(const RewindFile&) = delete;
+    RewindFile& operator=(RewindFile&&) = delete;
+};
+
+#endif
@@ -16,33 +16,90 @@
 //============================================================================
 
 #include <cmath>
+#include <map>
 
+#include "Console.hxx"
+#include "M6532.hxx"
 #include "OSystem.hxx"
 #include "Serializer.hxx"
 #include "StateManager.hxx"
 #include "TIA.hxx"
 #include "EventHandler.hxx"
+#include "Tracer.hxx"
 
 #include "RewindManager.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 RewindManager::RewindManager(OSystem& system, StateManager& statemgr)
   : myOSystem(system),
-    myStateManager(statemgr)
+    myStateManager(statemgr),
+    myUseInputLog(false),
+    myQueueHead(0),
+    myQueueTail(0),
+    myQuit(false),
+    myLastAddCycles(0),
+    myHasLastAdd(false),
+    myKeyframeCycles(0),
+    myHasKeyframe(false),
+    myLogHorizon(0),
+    myPersist(false),
+    myCompactSize(0)
 {
   setup();
+
+  myThread = std::thread(&RewindManager::threadMain, this);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RewindManager::~RewindManager()
+{
+  {
+    std::lock_guard<std::mutex> lock(myQueueMutex);
+    myQuit = true;
+  }
+  myQueueCondition.notify_all();
+
+  myThread.join();
+
+  if(myFile)
+    myFile->close(fileIndex());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void RewindManager::setup()
 {
+  auto lock = lockStates();
+
   myLastTimeMachineAdd = false;
 
   const string& prefix = myOSystem.settings().getBool("dev.settings") ? "dev." : "plr.";
 
   mySize = myOSystem.settings().getInt(prefix + "tm.size");
   if(mySize != myStateList.capacity())
-    resize(mySize);
+  {
+    myStateList.resize(mySize);
+    updateLastAdd();
+  }
+
+  // States depending on the input log can't be kept when switching modes
+  const bool useInputLog = myOSystem.settings().getBool(prefix + "tm.replay");
+  if(useInputLog != myUseInputLog)
+  {
+    myUseInputLog = useInputLog;
+    myStateList.clear();
+    myInputLog.clear();
+    updateLastAdd();
+    attachInputLog();
+  }
+
+  // Stop keeping the states on disk right away, but only start doing so
+  // with the next ROM
+  myPersist = myOSystem.settings().getBool(prefix + "tm.persist");
+  if(!myPersist && myFile)
+  {
+    readAllStates();
+    closeFile();
+  }
 
   myUncompressed = myOSystem.settings().getInt(prefix + "tm.uncompressed");
 
@@ -93,11 +150,14 @@ void RewindManager::setup()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool RewindManager::addState(const string& message, bool timeMachine)
 {
+  TRACE_SCOPE("RewindManager::addState");
+
+  const uInt64 cycles = myOSystem.console().tia().cycles();
+
   // only check for Time Machine states, ignore for debugger
-  if(timeMachine && myStateList.currentIsValid())
+  if(timeMachine && myHasLastAdd)
   {
     // check if the current state has the right interval from the last state
-    RewindState& lastState = myStateList.current();
     uInt32 interval = myInterval;
 
     // adjust frame timed intervals to actual scanlines (vs 262)
@@ -108,44 +168,461 @@ bool RewindManager::addState(const string& message, bool timeMachine)
       interval = interval * scanlines / 262;
     }
 
-    if(myOSystem.console().tia().cycles() - lastState.cycles < interval)
+    if(cycles - myLastAddCycles < interval)
       return false;
   }
 
-  // Remove all future states
-  myStateList.removeToLast();
+  // When replaying input, only a keyframe every now and then is needed in full
+  const bool replay = myUseInputLog && timeMachine && myHasKeyframe &&
+                      cycles - myKeyframeCycles < REPLAY_CYCLES;
 
-  // Make sure we never run out of space
-  if(myStateList.full())
-    compressStates();
+  uInt32 tail;
+  {
+    std::unique_lock<std::mutex> lock(myQueueMutex);
 
-  // Add new state at the end of the list (queue adds at end)
-  // This updates the 'current' iterator inside the list
-  myStateList.addLast();
-  RewindState& state = myStateList.current();
-  Serializer& s = state.data;
+    if(myQueueTail - myQueueHead == QUEUE_SIZE)
+    {
+      // Never stall the emulation for a Time Machine state; it will simply
+      // be taken a frame later
+      if(timeMachine)
+        return false;
+
+      myQueueCondition.wait(lock, [this] { return myQueueTail - myQueueHead < QUEUE_SIZE; });
+    }
+    tail = myQueueTail;
+  }
+
+  // The buffer at the tail is not touched by the background thread until
+  // the tail is advanced past it
+  PendingState& pending = myQueue[tail % QUEUE_SIZE];
+  Serializer& s = pending.data;
 
   s.rewind();  // rewind Serializer internal buffers
-  if(myStateManager.saveState(s) && myOSystem.console().tia().saveDisplay(s))
+  if(!replay)
+  {
+    if(!myStateManager.saveState(s) || !myOSystem.console().tia().saveDisplay(s))
+      return false;
+
+    myKeyframeCycles = cycles;
+    myHasKeyframe = true;
+  }
+
+  // Replayed states need a thumbnail as well, so take it from the screen
+  scaleThumbnail(myOSystem.console().tia().frameBuffer(),
+                 myOSystem.console().tia().height(), pending.thumbnail);
+
+  pending.message = message;
+  pending.cycles = cycles;
+  pending.replay = replay;
+
+  {
+    std::lock_guard<std::mutex> lock(myQueueMutex);
+    ++myQueueTail;
+  }
+  myQueueCondition.notify_all();
+
+  myLastAddCycles = cycles;
+  myHasLastAdd = true;
+  myLastTimeMachineAdd = timeMachine;
+
+  if(myUseInputLog)
+    myInputLog.prune(myLogHorizon);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::threadMain()
+{
+  Tracer::instance().setThreadName("rewind");
+
+  std::unique_lock<std::mutex> lock(myQueueMutex);
+
+  while(true)
+  {
+    myQueueCondition.wait(lock, [this] {
+      return myQuit || myQueueHead != myQueueTail || myClosingFile;
+    });
+
+    if(myClosingFile)
+    {
+      // The file is only released once it is closed, so it can't be
+      // opened again before
+      lock.unlock();
+      myClosingFile->close(myClosingIndex);
+      lock.lock();
+
+      myClosingFile.reset();
+      myClosingIndex.clear();
+      myQueueCondition.notify_all();
+      continue;
+    }
+    if(myQuit)
+      return;
+
+    const PendingState& pending = myQueue[myQueueHead % QUEUE_SIZE];
+
+    lock.unlock();
+    insertState(pending);
+    lock.lock();
+
+    // Release the buffer, and wake up anyone waiting for it or for the
+    // queue to drain
+    ++myQueueHead;
+    myQueueCondition.notify_all();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::insertState(const PendingState& pending)
+{
+  TRACE_SCOPE("RewindManager::insertState");
+
+  const Serializer& s = pending.data;
+
+  // While snapshots are pending, nobody else changes the list, so it is only
+  // locked while its structure changes, and not while the state is encoded
+  // and written to the file
+  shared_ptr<ByteArray> keyframe;
+  RewindFile::Blob keyframeBlob;
+  uInt32 keyframeDistance = 0;
+  uInt64 keyframeCycles = pending.cycles;
+  {
+    auto lock = lockList();
+
+    // Remove all future states
+    myStateList.removeToLast();
+
+    // A replayed state is based on the keyframe of the previous one, which
+    // must exist (the snapshot after any change of the list is a keyframe)
+    if(pending.replay && (myStateList.empty() || !myStateList.last()->keyframe))
+      return;
+
+    // Make sure we never run out of space
+    if(myStateList.full())
+      compressStates();
+
+    if(!myStateList.empty() && myStateList.last()->keyframe &&
+       (pending.replay || (!myUseInputLog &&
+        myStateList.last()->keyframeDistance + 1 < KEYFRAME_INTERVAL)))
+    {
+      const RewindState& last = *myStateList.last();
+
+      keyframe = last.keyframe;
+      keyframeBlob = last.keyframeBlob;
+      keyframeDistance = last.keyframeDistance + 1;
+      keyframeCycles = last.keyframeCycles;
+    }
+  }
+
+  // Base the new state on the keyframe of the previous one, if it's close
+  // enough and can be read; otherwise it becomes a keyframe itself
+  if(keyframe && !loadKeyframe(*keyframe, keyframeBlob))
+  {
+    if(pending.replay)
+      return;
+
+    keyframe.reset();
+    keyframeBlob = RewindFile::Blob();
+    keyframeDistance = 0;
+    keyframeCycles = pending.cycles;
+  }
+
+  const uInt32 size = pending.replay ? uInt32(keyframe->size()) : uInt32(s.size());
+
+  if(pending.replay)
+    myDeltaBuffer.clear();
+  else if(keyframe)
+    encodeDelta(*keyframe, s.data(), size, myDeltaBuffer);
+  else
+  {
+    keyframe = make_shared<ByteArray>(s.data(), s.data() + size);
+    myDeltaBuffer.clear();
+  }
+
+  RewindFile::Blob deltaBlob;
+  if(!pending.replay)
+    storeState(*keyframe, myDeltaBuffer, keyframeBlob, deltaBlob);
+
   {
-    state.message = message;
-    state.cycles = myOSystem.console().tia().cycles();
-    myLastTimeMachineAdd = timeMachine;
+    auto lock = lockList();
+
+    // Add new state at the end of the list (queue adds at end)
+    // This updates the 'current' iterator inside the list
+    myStateList.addLast();
+    RewindState& state = myStateList.current();
+
+    // The delta buffer of the recycled state is reused for the next one
+    state.delta.swap(myDeltaBuffer);
+    state.keyframe = keyframe;
+    state.keyframeDistance = keyframeDistance;
+    state.keyframeCycles = keyframeCycles;
+    state.replay = pending.replay;
+    state.keyframeBlob = keyframeBlob;
+    state.deltaBlob = deltaBlob;
+    state.thumbnail = pending.thumbnail;
+    state.size = size;
+    state.message = pending.message;
+    state.cycles = pending.cycles;
+
+    myLogHorizon = myStateList.first()->keyframeCycles;
+  }
+
+  if(myFile && myFile->size() > myCompactSize)
+    compactFile();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::unique_lock<std::mutex> RewindManager::lockStates() const
+{
+  {
+    std::unique_lock<std::mutex> lock(myQueueMutex);
+    myQueueCondition.wait(lock, [this] { return myQueueHead == myQueueTail; });
+  }
+
+  return std::unique_lock<std::mutex>(myListMutex);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::updateLastAdd()
+{
+  myHasLastAdd = myStateList.currentIsValid();
+  if(myHasLastAdd)
+    myLastAddCycles = myStateList.current().cycles;
+
+  // Start with a new keyframe, so replayed states never depend on states
+  // which may have been removed
+  myHasKeyframe = false;
+  myLogHorizon = !myStateList.empty() ? myStateList.first()->keyframeCycles : 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::attachInputLog()
+{
+  if(myOSystem.hasConsole())
+    myOSystem.console().riot().setPortHandler(myUseInputLog ? &myInputLog : nullptr);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::startPersisting(bool resume)
+{
+  auto lock = lockStates();
+  {
+    // The file of the previous session may still be closed in the background
+    std::unique_lock<std::mutex> queueLock(myQueueMutex);
+    myQueueCondition.wait(queueLock, [this] { return !myClosingFile; });
+  }
+
+  if(!myPersist || myFile || !myOSystem.hasConsole() ||
+     myStateManager.mode() != StateManager::Mode::TimeMachine)
+    return;
+
+  const Properties& props = myOSystem.console().properties();
+  myFile = make_unique<RewindFile>();
+  if(!myFile->open(myOSystem.stateDir() + props.get(PropType::Cart_Name) + ".tm",
+                   props.get(PropType::Cart_MD5), resume))
+  {
+    myFile.reset();
+    return;
+  }
+  myCompactSize = myFile->size() * 2 + COMPACT_SLACK;
+
+  // Rebuild the states of the previous session from the index only; their
+  // data is read once it is needed (keyframes are shared by all states
+  // based on them)
+  std::map<uInt64, shared_ptr<ByteArray>> keyframes;
+  for(const RewindFile::Entry& entry: myFile->index())
+  {
+    if(myStateList.full())
+      compressStates();
+
+    myStateList.addLast();
+    RewindState& state = myStateList.current();
+
+    shared_ptr<ByteArray>& keyframe = keyframes[entry.keyframe.offset];
+    if(!keyframe)
+      keyframe = make_shared<ByteArray>();
+
+    state.delta.clear();
+    state.keyframe = keyframe;
+    state.keyframeDistance = entry.keyframeDistance;
+    state.keyframeCycles = entry.keyframeCycles;
+    state.replay = false;
+    state.keyframeBlob = entry.keyframe;
+    state.deltaBlob = entry.delta;
+    state.thumbnail = entry.thumbnail;
+    state.size = entry.size;
+    state.message = entry.message;
+    state.cycles = entry.cycles;
+  }
+
+  // Continue where the previous session ended
+  if(!myStateList.empty() && !loadCurrentState())
+    myStateList.clear();
+  updateLastAdd();
+  myLastTimeMachineAdd = false;
+
+  if(!myStateList.empty())
+    myOSystem.frameBuffer().showMessage("Time Machine resumed (" +
+      std::to_string(myStateList.size()) + " states)");
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::closeFile()
+{
+  vector<RewindFile::Entry> index = fileIndex();
+
+  {
+    std::unique_lock<std::mutex> lock(myQueueMutex);
+    myQueueCondition.wait(lock, [this] { return !myClosingFile; });
+
+    myClosingFile = std::move(myFile);
+    myClosingIndex = std::move(index);
+  }
+  myQueueCondition.notify_all();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<RewindFile::Entry> RewindManager::fileIndex() const
+{
+  vector<RewindFile::Entry> index;
+
+  for(auto it = myStateList.cbegin(); it != myStateList.cend(); ++it)
+  {
+    // States replayed from the input log can't be restored
+    if(it->replay || !it->keyframeBlob.offset ||
+       (!it->delta.empty() && !it->deltaBlob.offset))
+      continue;
+
+    RewindFile::Entry entry;
+    entry.keyframe = it->keyframeBlob;
+    entry.delta = it->deltaBlob;
+    entry.size = it->size;
+    entry.keyframeDistance = it->keyframeDistance;
+    entry.keyframeCycles = it->keyframeCycles;
+    entry.cycles = it->cycles;
+    entry.message = it->message;
+    entry.thumbnail = it->thumbnail;
+    index.push_back(entry);
+  }
+
+  return index;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::storeState(const ByteArray& keyframe, const ByteArray& delta,
+                               RewindFile::Blob& keyframeBlob, RewindFile::Blob& deltaBlob)
+{
+  if(!myFile)
+    return;
+
+  // States based on an earlier keyframe share its data
+  if(!keyframeBlob.offset)
+    keyframeBlob = myFile->append(keyframe.data(), uInt32(keyframe.size()));
+  if(!delta.empty())
+    deltaBlob = myFile->append(delta.data(), uInt32(delta.size()));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::compactFile()
+{
+  TRACE_SCOPE("RewindManager::compactFile");
+
+  // Collect the data still in use (keyframes only once); the file is
+  // rewritten based on this copy, without holding the list
+  vector<RewindFile::Blob> blobs;
+  std::map<uInt64, size_t> blobIndex;
+  const auto collect = [&](const RewindFile::Blob& blob) {
+    if(blob.offset && blobIndex.emplace(blob.offset, blobs.size()).second)
+      blobs.push_back(blob);
+  };
+  {
+    auto lock = lockList();
+    for(auto it = myStateList.cbegin(); it != myStateList.cend(); ++it)
+    {
+      collect(it->keyframeBlob);
+      collect(it->deltaBlob);
+    }
+  }
+
+  if(!myFile->compact(blobs))
+  {
+    // Rather stop keeping the states than letting the file grow forever
+    cerr << "ERROR: RewindManager::compactFile" << endl;
+    readAllStates();
+    myFile.reset();
+    return;
+  }
+
+  // Only swap the new locations in while holding the list
+  const auto relocate = [&](RewindFile::Blob& blob) {
+    if(blob.offset)
+      blob = blobs[blobIndex[blob.offset]];
+  };
+  {
+    auto lock = lockList();
+    for(auto it = myStateList.begin(); it != myStateList.end(); ++it)
+    {
+      relocate(it->keyframeBlob);
+      relocate(it->deltaBlob);
+    }
+  }
+  myCompactSize = myFile->size() * 2 + COMPACT_SLACK;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindManager::loadKeyframe(ByteArray& keyframe, const RewindFile::Blob& blob)
+{
+  // Keyframes of restored states are read on demand; the shared data is
+  // filled in for all states based on it
+  if(!keyframe.empty())
+    return true;
+
+  keyframe.resize(blob.size);
+  if(myFile && myFile->read(blob, keyframe.data()))
     return true;
+
+  keyframe.clear();
+  return false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::readAllStates()
+{
+  for(auto it = myStateList.begin(); it != myStateList.end(); ++it)
+  {
+    loadKeyframe(*it->keyframe, it->keyframeBlob);
+    loadDelta(*it);
   }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindManager::loadDelta(RewindState& state)
+{
+  // Keyframes have no delta; the deltas of restored states are only
+  // located in the file
+  if(!state.delta.empty() || !state.deltaBlob.size)
+    return true;
+
+  state.delta.resize(state.deltaBlob.size);
+  if(myFile && myFile->read(state.deltaBlob, state.delta.data()))
+    return true;
+
+  state.delta.clear();
   return false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 RewindManager::rewindStates(uInt32 numStates)
 {
+  auto lock = lockStates();
   uInt64 startCycles = myOSystem.console().tia().cycles();
   uInt32 i;
   string message;
 
   for(i = 0; i < numStates; ++i)
   {
-    if(!atFirst())
+    if(!myStateList.atFirst())
     {
       if(!myLastTimeMachineAdd)
         // Set internal current iterator to previous state (back in time),
@@ -155,18 +632,17 @@ uInt32 RewindManager::rewindStates(uInt32 numStates)
         // ...except when the last state was added automatically,
         // because that already happened one interval before
         myLastTimeMachineAdd = false;
-
-      RewindState& state = myStateList.current();
-      Serializer& s = state.data;
-      s.rewind();  // rewind Serializer internal buffers
     }
     else
       break;
   }
 
   if(i)
+  {
     // Load the current state and get the message string for the rewind
     message = loadState(startCycles, i);
+    updateLastAdd();
+  }
   else
     message = "Rewind not possible";
 
@@ -178,29 +654,29 @@ uInt32 RewindManager::rewindStates(uInt32 numStates)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 RewindManager::unwindStates(uInt32 numStates)
 {
+  auto lock = lockStates();
   uInt64 startCycles = myOSystem.console().tia().cycles();
   uInt32 i;
   string message;
 
   for(i = 0; i < numStates; ++i)
   {
-    if(!atLast())
+    if(!myStateList.atLast())
     {
       // Set internal current iterator to nextCycles state (forward in time),
       // since we will now process this state
       myStateList.moveToNext();
-
-      RewindState& state = myStateList.current();
-      Serializer& s = state.data;
-      s.rewind();  // rewind Serializer internal buffers
     }
     else
       break;
   }
 
   if(i)
+  {
     // Load the current state and get the message string for the unwind
     message = loadState(startCycles, i);
+    updateLastAdd();
+  }
   else
     message = "Unwind not possible";
 
@@ -218,6 +694,46 @@ uInt32 RewindManager::windStates(uInt32 numStates, bool unwind)
     return rewindStates(numStates);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::resize(uInt32 size)
+{
+  auto lock = lockStates();
+
+  myStateList.resize(size);
+  updateLastAdd();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::clear()
+{
+  auto lock = lockStates();
+
+  if(myFile)
+    closeFile();
+
+  myStateList.clear();
+  myInputLog.clear();
+  updateLastAdd();
+
+  // Called for every new console
+  attachInputLog();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::scaleThumbnail(const uInt8* frame, uInt32 height, ByteArray& thumb)
+{
+  height = BSPF::clamp(height, 1u, TIAConstants::frameBufferHeight);
+  thumb.resize(THUMBNAIL_W * THUMBNAIL_H);
+
+  // Sample the center of each area covered by a thumbnail pixel
+  for(uInt32 y = 0; y < THUMBNAIL_H; ++y)
+  {
+    const uInt8* line = frame + ((y * 2 + 1) * height / (THUMBNAIL_H * 2)) * TIAConstants::H_PIXEL;
+
+    for(uInt32 x = 0; x < THUMBNAIL_W; ++x)
+      thumb[y * THUMBNAIL_W + x] = line[(x * 2 + 1) * TIAConstants::H_PIXEL / (THUMBNAIL_W * 2)];
+  }
+}
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void RewindManager::compressStates()
@@ -256,12 +772,10 @@ void RewindManager::compressStates()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string RewindManager::loadState(Int64 startCycles, uInt32 numStates)
 {
-  RewindState& state = myStateList.current();
-  Serializer& s = state.data;
-
-  myStateManager.loadState(s);
-  myOSystem.console().tia().loadDisplay(s);
+  if(!loadCurrentState())
+    return "Can't load Time Machine state";
 
+  const RewindState& state = myStateList.current();
   Int64 diff = startCycles - state.cycles;
   stringstream message;
 
@@ -275,6 +789,119 @@ string RewindManager::loadState(Int64 startCycles, uInt32 numStates)
   return message.str();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindManager::loadCurrentState()
+{
+  RewindState& state = myStateList.current();
+  Serializer& s = myStateBuffer;
+
+  if(!loadKeyframe(*state.keyframe, state.keyframeBlob) || !loadDelta(state))
+    return false;
+
+  // Reconstruct the full state, and feed it to the console
+  s.rewind();  // rewind Serializer internal buffers
+  if(state.delta.empty())
+    s.putByteArray(state.keyframe->data(), state.size);
+  else
+  {
+    decodeDelta(*state.keyframe, state.delta, state.size, myDecodeBuffer);
+    s.putByteArray(myDecodeBuffer.data(), state.size);
+  }
+
+  myStateManager.loadState(s);
+  myOSystem.console().tia().loadDisplay(s);
+
+  if(state.replay)
+  {
+    TIA& tia = myOSystem.console().tia();
+
+    tia.enableAudioOutput(false);
+    myInputLog.replay(myOSystem.console(), state.cycles);
+    tia.enableAudioOutput(true);
+  }
+  // Input logged from here on replaces the previous future
+  myInputLog.rewindTo(state.cycles);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::encodeDelta(const ByteArray& keyframe, const uInt8* data, uInt32 size,
+                                ByteArray& delta)
+{
+  // Runs of unchanged bytes shorter than this are kept in the literal run
+  constexpr uInt32 MIN_RUN = 4;
+
+  const uInt32 baseSize = uInt32(keyframe.size());
+  const auto unchanged = [&](uInt32 i) { return i < baseSize && data[i] == keyframe[i]; };
+  const auto putVarint = [&](uInt32 value) {
+    while(value >= 0x80)
+    {
+      delta.push_back(uInt8(value | 0x80));
+      value >>= 7;
+    }
+    delta.push_back(uInt8(value));
+  };
+
+  delta.clear();
+  uInt32 i = 0;
+
+  while(i < size)
+  {
+    const uInt32 runStart = i;
+    while(i < size && unchanged(i))  ++i;
+    if(i == size)  break;  // trailing unchanged bytes need not be encoded
+
+    const uInt32 literalStart = i;
+    while(i < size)
+    {
+      if(!unchanged(i))  { ++i; continue; }
+
+      uInt32 run = 0;
+      while(i + run < size && unchanged(i + run))  ++run;
+      if(run >= MIN_RUN || i + run == size)  break;
+      i += run;
+    }
+
+    putVarint(literalStart - runStart);
+    putVarint(i - literalStart);
+    for(uInt32 j = literalStart; j < i; ++j)
+      delta.push_back(j < baseSize ? uInt8(data[j] ^ keyframe[j]) : data[j]);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::decodeDelta(const ByteArray& keyframe, const ByteArray& delta, uInt32 size,
+                                ByteArray& data)
+{
+  const uInt32 baseSize = std::min(uInt32(keyframe.size()), size);
+  size_t pos = 0;
+  const auto getVarint = [&]() {
+    uInt32 value = 0;
+    for(int shift = 0; pos < delta.size(); shift += 7)
+    {
+      const uInt8 b = delta[pos++];
+      value |= uInt32(b & 0x7f) << shift;
+      if(!(b & 0x80))  break;
+    }
+    return value;
+  };
+
+  data.resize(size);
+  std::copy_n(keyframe.data(), baseSize, data.data());
+  std::fill(data.begin() + baseSize, data.end(), 0);
+
+  uInt32 i = 0;
+  while(pos < delta.size())
+  {
+    i += getVarint();
+    const uInt32 literal = getVarint();
+
+    for(uInt32 j = 0; j < literal && i < size && pos < delta.size(); ++j)
+      data[i++] ^= delta[pos++];
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string RewindManager::getUnitString(Int64 cycles)
 {
@@ -310,12 +937,14 @@ string RewindManager::getUnitString(Int64 cycles)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt64 RewindManager::getFirstCycles() const
 {
+  auto lock = lockList();
   return !myStateList.empty() ? myStateList.first()->cycles : 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt64 RewindManager::getCurrentCycles() const
 {
+  auto lock = lockList();
   if(myStateList.currentIsValid())
     return myStateList.current().cycles;
   else
@@ -325,15 +954,32 @@ uInt64 RewindManager::getCurrentCycles() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt64 RewindManager::getLastCycles() const
 {
+  auto lock = lockList();
   return !myStateList.empty() ? myStateList.last()->cycles : 0;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindManager::getThumbnail(uInt32 idx, ByteArray& thumb) const
+{
+  auto lock = lockList();
+
+  auto it = myStateList.cbegin();
+  for(uInt32 i = 0; i < idx && it != myStateList.cend(); ++i)
+    ++it;
+  if(it == myStateList.cend())
+    return false;
+
+  thumb = it->thumbnail;
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 IntArray RewindManager::cyclesList() const
 {
+  auto lock = lockList();
   IntArray arr;
 
-  uInt64 firstCycle = getFirstCycles();
+  uInt64 firstCycle = !myStateList.empty() ? myStateList.first()->cycles : 0;
   for(auto it = myStateList.cbegin(); it != myStateList.cend(); ++it)
     arr.push_back(uInt32(it->cycles - firstCycle));
 
@@ -21,7 +21,16 @@
 class OSystem;
 class StateManager;
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "InputLog.hxx"
 #include "LinkedObjectPool.hxx"
+#include "RewindFile.hxx"
+#include "Serializer.hxx"
 #include "bspf.hxx"
 
 /**
@@ -41,12 +50,45 @@ class StateManager;
   If the list is full, states are either removed at the beginning (compression
   off) or at selective positions (compression on).
 
+  To save memory, only every KEYFRAME_INTERVAL-th state is stored in full.
+  All other states are stored as the XOR difference to their keyframe, with
+  runs of unchanged bytes collapsed, and are decoded when they are loaded.
+  Keyframes are shared by their dependent states, so removing any state
+  from the list never invalidates another one.
+
+  Optionally (tm.replay), only sparse keyframes are stored at all, along with
+  a log of all controller and switch changes.  States in between merely
+  record their cycles, and are reconstructed by loading their keyframe and
+  re-emulating up to them, replaying the logged input.  This trades CPU
+  time for memory, and makes very long horizons practical.
+
+  Adding a state only takes a raw snapshot into one of a few pooled buffers.
+  Encoding the snapshot and inserting it into the list (including pruning
+  of old states) is done on a background thread, so the emulation is never
+  held up by it.  All operations which change the list or load a state wait
+  for pending snapshots first; read-only queries use the list as it is.
+  The background thread only locks the list to link a state that is already
+  encoded and written, so these queries never wait for the disk.
+
+  Optionally (tm.persist), the encoded states are also appended to a file
+  per ROM by the background thread, and an index of them is written there
+  (again in the background) when the ROM is closed.  When the ROM is
+  opened again, only the index is read, the console continues from the
+  last state, and keyframes and deltas are read from the file once they
+  are needed.
+
+  Each state also keeps a small thumbnail of the frame it was taken at,
+  for display in the Time Machine timeline.  It is sampled from the screen
+  when the state is added (so replayed states have one too), and stored
+  in the index of the file along with the state.
+
   @author  Stephen Anthony
 */
 class RewindManager
 {
   public:
     RewindManager(OSystem& system, StateManager& statemgr);
+    ~RewindManager();
 
   public:
     static constexpr int NUM_INTERVALS = 7;
@@ -136,18 +178,32 @@ class RewindManager
     */
     uInt32 windStates(uInt32 numStates, bool unwind);
 
-    bool atFirst() const { return myStateList.atFirst(); }
-    bool atLast() const  { return myStateList.atLast();  }
-    void resize(uInt32 size) { myStateList.resize(size); }
-    void clear() { myStateList.clear(); }
+    bool atFirst() const { auto lock = lockList(); return myStateList.atFirst(); }
+    bool atLast() const  { auto lock = lockList(); return myStateList.atLast();  }
+    void resize(uInt32 size);
+
+    /**
+      Remove all states.  If they are kept on disk, the file is closed
+      (in the background), so the states can be restored later.
+    */
+    void clear();
+
+    /**
+      Start keeping the states of the current console on disk, if enabled
+      (tm.persist).
+
+      @param resume  Restore the states of the previous session, and
+                     continue from the last one
+    */
+    void startPersisting(bool resume);
 
     /**
       Convert the cycles into a unit string.
     */
     string getUnitString(Int64 cycles);
 
-    uInt32 getCurrentIdx() { return myStateList.currentIdx(); }
-    uInt32 getLastIdx() { return myStateList.size(); }
+    uInt32 getCurrentIdx() { auto lock = lockList(); return myStateList.currentIdx(); }
+    uInt32 getLastIdx() { auto lock = lockList(); return myStateList.size(); }
 
     uInt64 getFirstCycles() const;
     uInt64 getCurrentCycles() const;
@@ -159,6 +215,18 @@ class RewindManager
     */
     IntArray cyclesList() const;
 
+    // Size of the thumbnails (in TIA palette indices)
+    static constexpr uInt32 THUMBNAIL_W = 40, THUMBNAIL_H = 26;
+
+    /**
+      Get the thumbnail of a state.
+
+      @param idx    The index of the state in the list
+      @param thumb  Receives THUMBNAIL_W * THUMBNAIL_H palette indices
+      @return       False if there is no such state
+    */
+    bool getThumbnail(uInt32 idx, ByteArray& thumb) const;
+
   private:
     OSystem& myOSystem;
     StateManager& myStateManager;
@@ -170,15 +238,34 @@ class RewindManager
     double myFactor;
     bool   myLastTimeMachineAdd;
 
+    // Number of states between two keyframes (see above)
+    static constexpr uInt32 KEYFRAME_INTERVAL = 30;
+    // Maximum distance between two keyframes when replaying input (~5 seconds),
+    // which limits the re-emulation needed to load a state
+    static constexpr uInt64 REPLAY_CYCLES = 76 * 262 * 60 * 5;
+
+    // Whether states between keyframes are reconstructed from the input log
+    bool myUseInputLog;
+    InputLog myInputLog;
+
     struct RewindState {
-      Serializer data;  // actual save state
+      shared_ptr<ByteArray> keyframe;  // full save state this one is based on
+      ByteArray delta;          // encoded difference to keyframe (empty for keyframes)
+      uInt32 size;              // size of the decoded save state
+      uInt32 keyframeDistance;  // number of states since the keyframe
+      uInt64 keyframeCycles;    // cycles of the keyframe
+      bool replay;              // re-emulate from the keyframe to load this state
+      RewindFile::Blob keyframeBlob;  // location of the keyframe on disk
+      RewindFile::Blob deltaBlob;     // location of the delta on disk
+      ByteArray thumbnail;      // downscaled frame (see getThumbnail())
       string message;   // describes save state origin
       uInt64 cycles;    // cycles since emulation started
 
       // We do nothing on object instantiation or copy
       // The goal of LinkedObjectPool is to not do any allocations at all
-      RewindState() : cycles(0) { }
-      RewindState(const RewindState& rs) : cycles(rs.cycles) { }
+      RewindState() : size(0), keyframeDistance(0), keyframeCycles(0), replay(false), cycles(0) { }
+      RewindState(const RewindState& rs)
+        : size(0), keyframeDistance(0), keyframeCycles(0), replay(false), cycles(rs.cycles) { }
       RewindState& operator= (const RewindState& rs) { cycles = rs.cycles; return *this; }
 
       // Output object info; used for debugging only
@@ -191,6 +278,167 @@ class RewindManager
     // frequent (de)-allocations)
     Common::LinkedObjectPool<RewindState> myStateList;
 
+    // Scratch buffers for loading and decoding states
+    Serializer myStateBuffer;
+    ByteArray myDecodeBuffer;
+    // Scratch buffer for encoding states (background thread only)
+    ByteArray myDeltaBuffer;
+
+    // A raw snapshot waiting to be added to the list by the background thread
+    struct PendingState {
+      Serializer data;  // empty when the state is replayed from the input log
+      ByteArray thumbnail;
+      string message;
+      uInt64 cycles;
+      bool replay;
+
+      PendingState() : cycles(0), replay(false) { }
+    };
+
+    // Number of snapshots which can be pending at the same time; if all
+    // are in use, further Time Machine states are skipped until one is free
+    static constexpr uInt32 QUEUE_SIZE = 4;
+
+    std::array<PendingState, QUEUE_SIZE> myQueue;
+    uInt32 myQueueHead;  // next snapshot to be added (counts up, wraps)
+    uInt32 myQueueTail;  // next free snapshot buffer (counts up, wraps)
+    bool myQuit;
+
+    // Cycles of the most recent snapshot, for the Time Machine interval check
+    uInt64 myLastAddCycles;
+    bool myHasLastAdd;
+
+    // Cycles of the most recent full snapshot, when replaying input
+    uInt64 myKeyframeCycles;
+    bool myHasKeyframe;
+
+    // Input log entries before these cycles are no longer needed
+    std::atomic<uInt64> myLogHorizon;
+
+    // Whether states are kept on disk across sessions
+    bool myPersist;
+    // The file the states are appended to, if any
+    unique_ptr<RewindFile> myFile;
+    // The file size at which it is compacted next
+    uInt64 myCompactSize;
+    // Minimum amount of removed states' data before a file is compacted
+    static constexpr uInt64 COMPACT_SLACK = 4 * 1024 * 1024;
+
+    // A file to be closed by the background thread, along with its index
+    unique_ptr<RewindFile> myClosingFile;
+    vector<RewindFile::Entry> myClosingIndex;
+
+    // Guards the queue indices and the closing file,
+    // and wakes up the background thread or anyone waiting for the queue
+    // to drain
+    mutable std::mutex myQueueMutex;
+    mutable std::condition_variable myQueueCondition;
+    // Guards the state list; while snapshots are pending, only the
+    // background thread changes it, and only holds it to change the links
+    // of the list and the locations of the states in the file
+    mutable std::mutex myListMutex;
+
+    std::thread myThread;
+
+    /**
+      Wait until all pending snapshots have been added to the list, and
+      return a lock on the list.
+    */
+    std::unique_lock<std::mutex> lockStates() const;
+
+    /**
+      Return a lock on the list as it is, for read-only access which doesn't
+      need the pending snapshots.
+    */
+    std::unique_lock<std::mutex> lockList() const {
+      return std::unique_lock<std::mutex>(myListMutex);
+    }
+
+    /**
+      The background thread, which adds pending snapshots to the list.
+    */
+    void threadMain();
+
+    /**
+      Encode a snapshot (and write it to the file), then add it at the end
+      of the list.
+    */
+    void insertState(const PendingState& pending);
+
+    /**
+      Resynchronize the snapshots with the current state after the list
+      has been changed.
+    */
+    void updateLastAdd();
+
+    /**
+      Log (or stop logging) the input of the current console.
+    */
+    void attachInputLog();
+
+    /**
+      Hand the file over to the background thread, which writes the index
+      of all states stored in it and closes it.
+    */
+    void closeFile();
+
+    /**
+      Get the index of all states stored in the file.
+    */
+    vector<RewindFile::Entry> fileIndex() const;
+
+    /**
+      Write the data of a new state to the file, if not done yet.
+
+      @param keyframe      The keyframe the state is based on
+      @param delta         The encoded difference to the keyframe, if any
+      @param keyframeBlob  The location of the keyframe; set if it is written
+      @param deltaBlob     Receives the location of the delta
+    */
+    void storeState(const ByteArray& keyframe, const ByteArray& delta,
+                    RewindFile::Blob& keyframeBlob, RewindFile::Blob& deltaBlob);
+
+    /**
+      Rewrite the file without the data of removed states.  The list is only
+      locked to take a copy of the locations in use, and to swap in the new
+      ones.
+    */
+    void compactFile();
+
+    /**
+      Make sure a keyframe is available, reading it from the file if
+      necessary.
+
+      @param keyframe  The (shared) keyframe data, filled in when it is read
+      @param blob      The location of the keyframe in the file
+
+      @return  False if the keyframe can't be read
+    */
+    bool loadKeyframe(ByteArray& keyframe, const RewindFile::Blob& blob);
+
+    /**
+      Make sure the delta of the state is available, reading it from the
+      file if necessary.
+
+      @return  False if the delta can't be read
+    */
+    bool loadDelta(RewindState& state);
+
+    /**
+      Read the data of all states which is only in the file so far, before
+      the file is given up.
+    */
+    void readAllStates();
+
+    /**
+      Scale a frame down to a thumbnail.
+
+      @param frame   The frame, as TIA palette indices
+      @param height  The number of visible scanlines of the frame
+      @param thumb   Receives the thumbnail
+    */
+    static void scaleThumbnail(const uInt8* frame, uInt32 height, ByteArray& thumb);
+
     /**
       Remove a save state from the list
     */
@@ -203,6 +451,27 @@ class RewindManager
     */
     string loadState(Int64 startCycles, uInt32 numStates);
 
+    /**
+      Load the current state into the console.
+
+      @return  False if the state can't be reconstructed
+    */
+    bool loadCurrentState();
+
+    /**
+      Encode the difference between a state and its keyframe as alternating
+      runs of unchanged bytes and XOR'ed literal bytes (both sizes as varints).
+      Bytes beyond the end of the keyframe are XOR'ed with zero.
+    */
+    static void encodeDelta(const ByteArray& keyframe, const uInt8* data, uInt32 size,
+                            ByteArray& delta);
+
+    /**
+      Reconstruct a state of the given size from its keyframe and delta.
+    */
+    static void decodeDelta(const ByteArray& keyframe, const ByteArray& delta, uInt32 size,
+                            ByteArray& data);
+
   private:
     // Following constructors and assignment operators not supported
     RewindManager() = delete;
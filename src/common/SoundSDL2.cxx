@@ -20,6 +20,7 @@
 #include <sstream>
 #include <cassert>
 #include <cmath>
+#include <chrono>
 
 #include "SDL_lib.hxx"
 #include "Logger.hxx"
@@ -35,6 +36,7 @@
 #include "audio/SimpleResampler.hxx"
 #include "audio/LanczosResampler.hxx"
 #include "StaggeredLogger.hxx"
+#include "Tracer.hxx"
 
 #include "ThreadDebugging.hxx"
 
@@ -48,7 +50,8 @@ SoundSDL2::SoundSDL2(OSystem& osystem, AudioSettings& audioSettings)
     myEmulationTiming(nullptr),
     myCurrentFragment(nullptr),
     myUnderrun(false),
-    myAudioSettings(audioSettings)
+    myAudioSettings(audioSettings),
+    myCallbackTime(0)
 {
   ASSERT_MAIN_THREAD;
 
@@ -187,6 +190,11 @@ bool SoundSDL2::mute(bool state)
   if(myIsInitializedFlag)
     SDL_PauseAudioDevice(myDevice, state ? 1 : 0);
 
+  // Nobody drains the queue while muted (e.g. in turbo mode), so overflows
+  // are expected and shouldn't be logged
+  if(myAudioQueue)
+    myAudioQueue->ignoreOverflows(state || !myAudioSettings.enabled());
+
   return oldstate;
 }
 
@@ -355,12 +363,25 @@ void SoundSDL2::initResampler()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void SoundSDL2::callback(void* udata, uInt8* stream, int len)
 {
+  TRACE_SCOPE("SoundSDL2::callback");
+  Tracer::instance().setThreadName("audio");
+
   SoundSDL2* self = static_cast<SoundSDL2*>(udata);
+  const auto startTime = std::chrono::high_resolution_clock::now();
 
   if (self->myAudioQueue)
     self->processFragment(reinterpret_cast<float*>(stream), len >> 2);
   else
     SDL_memset(stream, 0, len);
+
+  self->myCallbackTime += std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double SoundSDL2::consumeCallbackTime()
+{
+  return static_cast<double>(myCallbackTime.exchange(0)) / 1e9;
 }
 
 #endif  // SOUND_SUPPORT
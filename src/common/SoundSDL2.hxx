@@ -25,6 +25,8 @@ class AudioQueue;
 class EmulationTiming;
 class AudioSettings;
 
+#include <atomic>
+
 #include "SDL_lib.hxx"
 
 #include "bspf.hxx"
@@ -108,6 +110,11 @@ class SoundSDL2 : public Sound
     */
     string about() const override;
 
+    /**
+      Returns the time spent in the audio callback since the last call.
+    */
+    double consumeCallbackTime() override;
+
   protected:
     /**
       Invoked by the sound callback to process the next sound fragment.
@@ -155,6 +162,9 @@ class SoundSDL2 : public Sound
 
     string myAboutString;
 
+    // Time spent in the audio callback (in ns), written on the audio thread
+    std::atomic<uInt64> myCallbackTime;
+
   private:
     // Callback function invoked by the SDL Audio library when it needs data
     static void callback(void* udata, uInt8* stream, int len);
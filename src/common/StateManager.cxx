@@ -18,23 +18,29 @@
 #include "OSystem.hxx"
 #include "Settings.hxx"
 #include "Console.hxx"
+#include "EventHandler.hxx"
 #include "Cart.hxx"
 #include "Control.hxx"
 #include "Switches.hxx"
 #include "System.hxx"
 #include "Serializable.hxx"
 #include "RewindManager.hxx"
+#include "TIA.hxx"
 
 #include "StateManager.hxx"
 
-#define STATE_HEADER "06000003state"
-// #define MOVIE_HEADER "03030000movie"
+#define STATE_HEADER "06000004state"
+#define MOVIE_HEADER "06000004movie"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 StateManager::StateManager(OSystem& osystem)
   : myOSystem(osystem),
     myCurrentSlot(0),
-    myActiveMode(Mode::Off)
+    myActiveMode(Mode::Off),
+    myMovieFrames(0),
+    myMovieEnded(false),
+    myMovieLatchedOnVsync(false),
+    myMovieTurbo(false)
 {
   myRewindManager = make_unique<RewindManager>(myOSystem, *this);
   reset();
@@ -45,92 +51,15 @@ StateManager::~StateManager()
 {
 }
 
-#if 0
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void StateManager::toggleRecordMode()
+void StateManager::toggleTimeMachine()
 {
-  if(myActiveMode != kMovieRecordMode)  // Turn on movie record mode
+  if(movieActive())
   {
-    myActiveMode = kOffMode;
-
-    string moviefile = /*myOSystem.baseDir() +*/ "test.inp";
-    if(myMovieWriter.isOpen())
-      myMovieWriter.close();
-    if(!myMovieWriter.open(moviefile))
-      return false;
-
-    // Prepend the ROM md5 so this state file only works with that ROM
-    myMovieWriter.putString(myOSystem.console().properties().get(Cartridge_MD5));
-
-    if(!myOSystem.console().save(myMovieWriter))
-      return false;
-
-    // Save controller types for this ROM
-    // We need to check this, since some controllers save more state than
-    // normal, and those states files wouldn't be compatible with normal
-    // controllers.
-    myMovieWriter.putString(
-      myOSystem.console().controller(Controller::Jack::Left).name());
-    myMovieWriter.putString(
-      myOSystem.console().controller(Controller::Jack::Right).name());
-
-    // If we get this far, we're really in movie record mode
-    myActiveMode = kMovieRecordMode;
+    myOSystem.frameBuffer().showMessage("Time Machine not available during movie");
+    return;
   }
-  else  // Turn off movie record mode
-  {
-    myActiveMode = kOffMode;
-    myMovieWriter.close();
-    return false;
-  }
-
-  return myActiveMode == kMovieRecordMode;
-////////////////////////////////////////////////////////
-// FIXME - For now, I'm going to use this to activate movie playback
-  // Close the writer, since we're about to re-open in read mode
-  myMovieWriter.close();
-
-  if(myActiveMode != kMoviePlaybackMode)  // Turn on movie playback mode
-  {
-    myActiveMode = kOffMode;
-
-    string moviefile = /*myOSystem.baseDir() + */ "test.inp";
-    if(myMovieReader.isOpen())
-      myMovieReader.close();
-    if(!myMovieReader.open(moviefile))
-      return false;
-
-    // Check the ROM md5
-    if(myMovieReader.getString() !=
-       myOSystem.console().properties().get(Cartridge_MD5))
-      return false;
-
-    if(!myOSystem.console().load(myMovieReader))
-      return false;
 
-    // Check controller types
-    const string& left  = myMovieReader.getString();
-    const string& right = myMovieReader.getString();
-
-    if(left != myOSystem.console().controller(Controller::Jack::Left).name() ||
-       right != myOSystem.console().controller(Controller::Jack::Right).name())
-      return false;
-
-    // If we get this far, we're really in movie record mode
-    myActiveMode = kMoviePlaybackMode;
-  }
-  else  // Turn off movie playback mode
-  {
-    myActiveMode = kOffMode;
-    myMovieReader.close();
-    return false;
-  }
-}
-#endif
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void StateManager::toggleTimeMachine()
-{
   bool devSettings = myOSystem.settings().getBool("dev.settings");
 
   myActiveMode = myActiveMode == Mode::TimeMachine ? Mode::Off : Mode::TimeMachine;
@@ -173,6 +102,265 @@ bool StateManager::windStates(uInt32 numStates, bool unwind)
   return r.windStates(numStates, unwind);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::startMovieRecording(const string& filename)
+{
+  stopMovie();
+  if(!myOSystem.hasConsole())
+    return false;
+
+  Console& console = myOSystem.console();
+  unique_ptr<Serializer> movie = make_unique<Serializer>(filename);
+  bool success = false;
+
+  if(*movie)
+  {
+    try
+    {
+      // The ROM and controller types must match for playback, since some
+      // controllers save more state than others
+      movie->putString(MOVIE_HEADER);
+      movie->putString(console.properties().get(PropType::Cart_MD5));
+      movie->putString(console.leftController().name());
+      movie->putString(console.rightController().name());
+
+      success = saveState(*movie);
+    }
+    catch(...)
+    {
+      success = false;
+    }
+  }
+  if(!success)
+  {
+    myOSystem.frameBuffer().showMessage("Can't record movie to " + filename);
+    return false;
+  }
+
+  myMovie = std::move(movie);
+  startMovie(Mode::MovieRecord);
+  myOSystem.frameBuffer().showMessage("Movie recording started");
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::startMoviePlayback(const string& filename)
+{
+  stopMovie();
+  if(!myOSystem.hasConsole())
+    return false;
+
+  Console& console = myOSystem.console();
+  unique_ptr<Serializer> movie = make_unique<Serializer>(filename, true);
+  string error;
+
+  if(*movie)
+  {
+    try
+    {
+      if(movie->getString() != MOVIE_HEADER)
+        error = "Incompatible movie file " + filename;
+      else if(movie->getString() != console.properties().get(PropType::Cart_MD5))
+        error = "Movie was recorded with a different ROM";
+      else if(movie->getString() != console.leftController().name() ||
+              movie->getString() != console.rightController().name())
+        error = "Movie was recorded with different controllers";
+      else if(!loadState(*movie))
+        error = "Can't load movie " + filename;
+      else
+      {
+        // The frames are read completely, so that the emulation thread
+        // never accesses the file
+        myMovieData.rewind();
+        try
+        {
+          for(;;)
+            myMovieData.putByte(movie->getByte());
+        }
+        catch(...)
+        {
+        }
+      }
+    }
+    catch(...)
+    {
+      error = "Can't load movie " + filename;
+    }
+  }
+  else
+    error = "Can't open movie " + filename;
+
+  if(error != "")
+  {
+    myOSystem.frameBuffer().showMessage(error);
+    return false;
+  }
+
+  myMovie = std::move(movie);
+  startMovie(Mode::MoviePlayback);
+  myOSystem.frameBuffer().showMessage("Movie playback started");
+
+  if(myOSystem.settings().getBool("movieturbo") && !myOSystem.turboEnabled())
+  {
+    myOSystem.enableTurbo(true);
+    myMovieTurbo = myOSystem.turboEnabled();
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::startMovie(Mode mode)
+{
+  TIA& tia = myOSystem.console().tia();
+
+  myActiveMode = mode;
+  myMovieFrames = 0;
+  myMovieEnded = false;
+  myMovieLastPorts.clear();
+  myMovieData.rewind();
+
+  // Controllers and switches are only updated at the start of each frame
+  // (see EventHandler::poll())
+  myMovieLatchedOnVsync = tia.inputLatchOnVsync();
+  tia.setInputLatchOnVsync(true);
+  myOSystem.console().riot().setPortHandler(this);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::stopMovie()
+{
+  if(!movieActive())
+    return;
+
+  ostringstream buf;
+  if(myActiveMode == Mode::MovieRecord)
+  {
+    flushMovie();
+    try
+    {
+      myMovie->putByte(MOVIE_END);
+    }
+    catch(...)
+    {
+    }
+    buf << "Movie recording stopped (" << myMovieFrames << " frames)";
+  }
+  else
+    buf << "Movie playback stopped (" << myMovieFrames << " frames)";
+
+  if(myMovieTurbo)
+    myOSystem.enableTurbo(false);
+
+  myOSystem.console().tia().setInputLatchOnVsync(myMovieLatchedOnVsync);
+  myOSystem.console().riot().setPortHandler(nullptr);
+
+  // Also resumes the Time Machine, if enabled
+  reset();
+  myRewindManager->startPersisting(false);
+
+  myOSystem.frameBuffer().showMessage(buf.str());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::replayPorts(const ConsoleIO& console, uInt64)
+{
+  // Take over the mouse motion collected since the last frame (which
+  // isn't used during playback)
+  myOSystem.eventHandler().latchMouseMotion();
+
+  if(myActiveMode != Mode::MoviePlayback)
+    return false;
+
+  // After the end of the movie, the ports stay as they are until the
+  // playback is stopped
+  if(myMovieEnded)
+    return true;
+
+  try
+  {
+    const uInt8 marker = myMovieData.getByte();
+
+    if(marker == MOVIE_CHANGED)
+    {
+      myMovieLastPorts.resize(myMovieData.getByte());
+      myMovieData.getByteArray(myMovieLastPorts.data(), uInt32(myMovieLastPorts.size()));
+
+      Serializer& s = myMoviePorts;
+      s.rewind();
+      s.putByteArray(myMovieLastPorts.data(), uInt32(myMovieLastPorts.size()));
+      console.leftController().load(s);
+      console.rightController().load(s);
+      console.switches().load(s);
+    }
+    else if(marker != MOVIE_UNCHANGED)
+      myMovieEnded = true;
+  }
+  catch(...)
+  {
+    myMovieEnded = true;
+  }
+
+  if(!myMovieEnded)
+    ++myMovieFrames;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::recordPorts(const ConsoleIO& console, uInt64)
+{
+  if(myActiveMode != Mode::MovieRecord || myMovieEnded)
+    return;
+
+  Serializer& s = myMoviePorts;
+  s.rewind();
+  if(!console.leftController().save(s) || !console.rightController().save(s) ||
+     !console.switches().save(s))
+    return;
+
+  // The frames are written to the file by the main thread (see flushMovie())
+  std::lock_guard<std::mutex> lock(myMovieMutex);
+
+  // Only write the controllers and switches when they have changed
+  const uInt32 size = uInt32(s.size());
+  if(size == myMovieLastPorts.size() &&
+     std::equal(myMovieLastPorts.cbegin(), myMovieLastPorts.cend(), s.data()))
+    myMovieData.putByte(MOVIE_UNCHANGED);
+  else
+  {
+    myMovieData.putByte(MOVIE_CHANGED);
+    myMovieData.putByte(uInt8(size));
+    myMovieData.putByteArray(s.data(), size);
+    myMovieLastPorts.assign(s.data(), s.data() + size);
+  }
+  ++myMovieFrames;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::flushMovie()
+{
+  // Only the frames are copied while the emulation thread is held off
+  {
+    std::lock_guard<std::mutex> lock(myMovieMutex);
+
+    myMovieFlush.assign(myMovieData.data(), myMovieData.data() + myMovieData.size());
+    myMovieData.rewind();
+  }
+  if(myMovieFlush.empty())
+    return;
+
+  try
+  {
+    myMovie->putByteArray(myMovieFlush.data(), uInt32(myMovieFlush.size()));
+  }
+  catch(...)
+  {
+    myMovieEnded = true;
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StateManager::update()
 {
@@ -182,19 +370,15 @@ void StateManager::update()
       myRewindManager->addState("Time Machine", true);
       break;
 
-#if 0
     case Mode::MovieRecord:
-      myOSystem.console().controller(Controller::Jack::Left).save(myMovieWriter);
-      myOSystem.console().controller(Controller::Jack::Right).save(myMovieWriter);
-      myOSystem.console().switches().save(myMovieWriter);
-      break;
-
+      flushMovie();
+      [[fallthrough]];
     case Mode::MoviePlayback:
-      myOSystem.console().controller(Controller::Jack::Left).load(myMovieReader);
-      myOSystem.console().controller(Controller::Jack::Right).load(myMovieReader);
-      myOSystem.console().switches().load(myMovieReader);
+      // The frames themselves are handled at the start of each frame
+      if(myMovieEnded)
+        stopMovie();
       break;
-#endif
+
     default:
       break;
   }
@@ -203,6 +387,12 @@ void StateManager::update()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StateManager::loadState(int slot)
 {
+  if(movieActive())
+  {
+    myOSystem.frameBuffer().showMessage("State loading not available during movie");
+    return;
+  }
+
   if(myOSystem.hasConsole())
   {
     if(slot < 0) slot = myCurrentSlot;
@@ -364,26 +554,11 @@ bool StateManager::saveState(Serializer& out)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StateManager::reset()
 {
+  // A movie never survives a new console (or its end)
+  myMovie.reset();
+  myMovieTurbo = false;
+
   myRewindManager->clear();
   myActiveMode = myOSystem.settings().getBool(
     myOSystem.settings().getBool("dev.settings") ? "dev.timemachine" : "plr.timemachine") ? Mode::TimeMachine : Mode::Off;
-
-#if 0
-  myCurrentSlot = 0;
-
-  switch(myActiveMode)
-  {
-    case kMovieRecordMode:
-      myMovieWriter.close();
-      break;
-
-    case kMoviePlaybackMode:
-      myMovieReader.close();
-      break;
-
-    default:
-      break;
-  }
-  myActiveMode = kOffMode;
-#endif
 }
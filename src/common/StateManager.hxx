@@ -21,6 +21,10 @@
 class OSystem;
 class RewindManager;
 
+#include <atomic>
+#include <mutex>
+
+#include "M6532.hxx"
 #include "Serializer.hxx"
 
 /**
@@ -28,9 +32,14 @@ class RewindManager;
   States can be loaded or saved here, as well as recorded, rewound, and later
   played back.
 
+  Movies start with a save state of the console, followed by the state of
+  the controllers and console switches for every frame.  While a movie is
+  recorded or played back, input is only passed to the console at the start
+  of each frame, so playback reproduces the recording exactly.
+
   @author  Stephen Anthony
 */
-class StateManager
+class StateManager : public M6532::PortHandler
 {
   public:
     enum class Mode {
@@ -44,7 +53,7 @@ class StateManager
       Create a new statemananger class.
     */
     explicit StateManager(OSystem& osystem);
-    ~StateManager();
+    ~StateManager() override;
 
   public:
     /**
@@ -52,12 +61,34 @@ class StateManager
     */
     Mode mode() const { return myActiveMode; }
 
-#if 0
     /**
-      Toggle movie recording mode (FIXME - currently disabled)
+      Start recording a movie of the current console into the given file.
+
+      @param filename  The movie file to write
+      @return  False if the movie could not be started
     */
-    void toggleRecordMode();
-#endif
+    bool startMovieRecording(const string& filename);
+
+    /**
+      Start playing back a movie of the current ROM from the given file.
+      If the 'movieturbo' setting is enabled, it is played back in turbo mode.
+
+      @param filename  The movie file to read
+      @return  False if the movie could not be started
+    */
+    bool startMoviePlayback(const string& filename);
+
+    /**
+      Stop recording or playing back the current movie.
+    */
+    void stopMovie();
+
+    /**
+      Answers whether a movie is being recorded or played back.
+    */
+    bool movieActive() const {
+      return myActiveMode == Mode::MovieRecord || myActiveMode == Mode::MoviePlayback;
+    }
 
     /**
       Toggle state rewind recording mode; this uses the RewindManager
@@ -69,7 +100,7 @@ class StateManager
       Sets state rewind recording mode; this uses the RewindManager
       for its functionality.
     */
-    void setRewindMode(Mode mode) { myActiveMode = mode; }
+    void setRewindMode(Mode mode) { if(!movieActive()) myActiveMode = mode; }
 
     /**
       Optionally adds one extra state when entering the Time Machine dialog;
@@ -151,6 +182,22 @@ class StateManager
     */
     RewindManager& rewindManager() const { return *myRewindManager; }
 
+  public:
+    /** M6532::PortHandler, used for movies */
+    bool replayPorts(const ConsoleIO& console, uInt64 cycles) override;
+    void recordPorts(const ConsoleIO& console, uInt64 cycles) override;
+
+  private:
+    /**
+      Start recording or playing back the movie opened as myMovie.
+    */
+    void startMovie(Mode mode);
+
+    /**
+      Write the frames recorded so far to the movie file.
+    */
+    void flushMovie();
+
   private:
     // The parent OSystem object
     OSystem& myOSystem;
@@ -164,9 +211,32 @@ class StateManager
     // MD5 of the currently active ROM (either in movie or rewind mode)
     string myMD5;
 
-    // Serializer classes used to save/load the eventstream
-    Serializer myMovieWriter;
-    Serializer myMovieReader;
+    // Markers preceding each frame of a movie
+    static constexpr uInt8
+      MOVIE_UNCHANGED = 0,  // controllers and switches are unchanged
+      MOVIE_CHANGED = 1,    // followed by size and state of controllers and switches
+      MOVIE_END = 2;
+
+    // The movie file being recorded or played back; it is only accessed
+    // by the main thread
+    unique_ptr<Serializer> myMovie;
+    // The frames recorded by the emulation thread and not yet written to
+    // the file (guarded by the mutex), or all frames to be played back,
+    // and the frames being written
+    Serializer myMovieData;
+    std::mutex myMovieMutex;
+    ByteArray myMovieFlush;
+    // The state of controllers and switches, and of the previous frame
+    Serializer myMoviePorts;
+    ByteArray myMovieLastPorts;
+    // Number of frames recorded/played back
+    std::atomic<uInt32> myMovieFrames;
+    // Set (on the emulation thread) when the movie ends or fails
+    std::atomic<bool> myMovieEnded;
+    // TIA input latching before the movie started
+    bool myMovieLatchedOnVsync;
+    // Whether turbo mode was enabled for playback
+    bool myMovieTurbo;
 
     // Stored savestates to be later rewound
     unique_ptr<RewindManager> myRewindManager;
@@ -0,0 +1,148 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <fstream>
+#include <iomanip>
+
+#include "Tracer.hxx"
+
+using namespace std::chrono;
+
+std::atomic<bool> Tracer::ourEnabled(false);
+time_point<steady_clock> Tracer::ourEpoch;
+
+// Returns the buffer of a thread to the tracer when the thread exits
+struct ThreadBufferHolder {
+  Tracer::ThreadBuffer* buffer = nullptr;
+
+  ~ThreadBufferHolder() { if (buffer) Tracer::instance().releaseBuffer(buffer); }
+};
+
+namespace {
+  thread_local ThreadBufferHolder threadBufferHolder;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Tracer& Tracer::instance()
+{
+  static Tracer tracerInstance;
+
+  return tracerInstance;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 Tracer::now()
+{
+  return duration_cast<nanoseconds>(steady_clock::now() - ourEpoch).count();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Tracer::start()
+{
+  ourEpoch = steady_clock::now();
+  ourEnabled = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Tracer::setThreadName(const char* name)
+{
+  if (enabled()) threadBuffer()->threadName = name;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Tracer::record(const char* name, uInt64 start, uInt64 end)
+{
+  ThreadBuffer* buffer = threadBuffer();
+
+  // Only the owning thread writes, so a relaxed load is sufficient; the
+  // release store publishes the event to dump()
+  const uInt32 size = buffer->size.load(std::memory_order_relaxed);
+  if (size >= BUFFER_SIZE) return;
+
+  buffer->events[size] = Event{name, start, end - start};
+  buffer->size.store(size + 1, std::memory_order_release);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Tracer::ThreadBuffer* Tracer::threadBuffer()
+{
+  if (threadBufferHolder.buffer) return threadBufferHolder.buffer;
+
+  std::lock_guard<std::mutex> lock(myMutex);
+
+  if (!myFreeBuffers.empty()) {
+    threadBufferHolder.buffer = myFreeBuffers.back();
+    myFreeBuffers.pop_back();
+  } else {
+    myBuffers.push_back(make_unique<ThreadBuffer>());
+
+    ThreadBuffer* buffer = myBuffers.back().get();
+    buffer->tid = static_cast<uInt32>(myBuffers.size());
+    buffer->threadName = nullptr;
+    buffer->events = make_unique<Event[]>(BUFFER_SIZE);
+    buffer->size = 0;
+
+    threadBufferHolder.buffer = buffer;
+  }
+
+  return threadBufferHolder.buffer;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Tracer::releaseBuffer(ThreadBuffer* buffer)
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+
+  myFreeBuffers.push_back(buffer);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Tracer::dump(const string& filename)
+{
+  std::ofstream out(filename);
+  if (!out) return false;
+
+  std::lock_guard<std::mutex> lock(myMutex);
+  bool first = true;
+
+  out << "{\"traceEvents\":[\n" << std::fixed << std::setprecision(3);
+
+  for (const auto& buffer: myBuffers) {
+    const char* threadName = buffer->threadName;
+
+    if (threadName) {
+      out << (first ? "" : ",\n")
+          << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+          << ",\"args\":{\"name\":\"" << threadName << "\"}}";
+      first = false;
+    }
+
+    const uInt32 size = buffer->size.load(std::memory_order_acquire);
+    for (uInt32 i = 0; i < size; ++i) {
+      const Event& event = buffer->events[i];
+
+      out << (first ? "" : ",\n")
+          << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+          << ",\"ts\":" << event.start / 1000. << ",\"dur\":" << event.duration / 1000. << "}";
+      first = false;
+    }
+  }
+
+  out << "\n]}\n";
+
+  return out.good();
+}
@@ -0,0 +1,140 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef TRACER_HXX
+#define TRACER_HXX
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+#include "bspf.hxx"
+
+/**
+  Records scoped begin/end events of host-side phases (emulation, rendering,
+  audio, ...) and writes them as Chrome trace JSON, which can be loaded into
+  chrome://tracing or Perfetto to visualize stalls between threads.
+
+  Tracing is switched on at runtime (see the 'trace' option). Each thread
+  appends into its own fixed size buffer without locking; buffers of exited
+  threads are recycled, so short-lived workers share a few trace lanes.
+*/
+class Tracer
+{
+  public:
+
+    class Scope
+    {
+      public:
+
+        explicit Scope(const char* name)
+          : myName(Tracer::enabled() ? name : nullptr),
+            myStart(myName ? Tracer::now() : 0) { }
+
+        ~Scope() { if (myName) Tracer::instance().record(myName, myStart, Tracer::now()); }
+
+      private:
+
+        const char* myName;
+        uInt64 myStart;
+
+      private:
+
+        Scope(const Scope&) = delete;
+        Scope(Scope&&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        Scope& operator=(Scope&&) = delete;
+    };
+
+  public:
+
+    static Tracer& instance();
+
+    static bool enabled() { return ourEnabled.load(std::memory_order_relaxed); }
+
+    // Nanoseconds since tracing was started
+    static uInt64 now();
+
+    void start();
+
+    /**
+      Name the lane of the calling thread; only has an effect while tracing.
+      The name must be a string literal (or otherwise outlive the tracer).
+    */
+    void setThreadName(const char* name);
+
+    void record(const char* name, uInt64 start, uInt64 end);
+
+    /**
+      Write all events recorded so far to the given file.
+
+      @return  False if the file couldn't be written
+    */
+    bool dump(const string& filename);
+
+  public:
+
+    struct Event {
+      const char* name;
+      uInt64 start;
+      uInt64 duration;
+    };
+
+    struct ThreadBuffer {
+      uInt32 tid;
+      std::atomic<const char*> threadName;
+      unique_ptr<Event[]> events;
+      std::atomic<uInt32> size;
+    };
+
+    // Events per thread buffer; any further events are dropped
+    static constexpr uInt32 BUFFER_SIZE = 1 << 18;
+
+  private:
+
+    Tracer() = default;
+
+    ThreadBuffer* threadBuffer();
+
+    void releaseBuffer(ThreadBuffer* buffer);
+
+  private:
+
+    static std::atomic<bool> ourEnabled;
+    static std::chrono::time_point<std::chrono::steady_clock> ourEpoch;
+
+    // Guards buffer allocation and recycling only, never event recording
+    std::mutex myMutex;
+
+    vector<unique_ptr<ThreadBuffer>> myBuffers;
+    vector<ThreadBuffer*> myFreeBuffers;
+
+    friend struct ThreadBufferHolder;
+
+  private:
+
+    Tracer(const Tracer&) = delete;
+    Tracer(Tracer&&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+    Tracer& operator=(Tracer&&) = delete;
+};
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+#define TRACE_SCOPE(name) Tracer::Scope TRACE_CONCAT(traceScope, __LINE__)(name)
+
+#endif // TRACER_HXX
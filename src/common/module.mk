@@ -14,6 +14,7 @@ MODULE_OBJS := \
 	src/common/PKeyboardHandler.o \
 	src/common/PNGLibrary.o \
 	src/common/RewindManager.o \
+	src/common/RewindFile.o \
 	src/common/SoundSDL2.o \
 	src/common/StateManager.o \
 	src/common/TimerManager.o \
@@ -21,6 +22,8 @@ MODULE_OBJS := \
 	src/common/AudioQueue.o \
 	src/common/AudioSettings.o \
 	src/common/FpsMeter.o \
+	src/common/InputLog.o \
+	src/common/Tracer.o \
 	src/common/ThreadDebugging.o \
 	src/common/StaggeredLogger.o \
 	src/common/repository/KeyValueRepositoryConfigfile.o
@@ -17,6 +17,7 @@
 
 #include <thread>
 #include "AtariNTSC.hxx"
+#include "Tracer.hxx"
 
 // blitter related
 #ifndef restrict
@@ -117,6 +118,8 @@ void AtariNTSC::renderThread(const uInt8* atari_in, const uInt32 in_width,
   const uInt32 in_height, const uInt32 numThreads, const uInt32 threadNum,
   void* rgb_out, const uInt32 out_pitch)
 {
+  TRACE_SCOPE("AtariNTSC::renderThread");
+
   // Adapt parameters to thread number
   const uInt32 yStart = in_height * threadNum / numThreads;
   const uInt32 yEnd = in_height * (threadNum + 1) / numThreads;
@@ -188,6 +191,8 @@ void AtariNTSC::renderWithPhosphorThread(const uInt8* atari_in, const uInt32 in_
   const uInt32 in_height, const uInt32 numThreads, const uInt32 threadNum,
   uInt32* rgb_in, void* rgb_out, const uInt32 out_pitch)
 {
+  TRACE_SCOPE("AtariNTSC::renderWithPhosphorThread");
+
   // Adapt parameters to thread number
   const uInt32 yStart = in_height * threadNum / numThreads;
   const uInt32 yEnd = in_height * (threadNum + 1) / numThreads;
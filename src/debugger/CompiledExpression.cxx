@@ -0,0 +1,394 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "Debugger.hxx"
+#include "CompiledExpression.hxx"
+
+namespace {
+  // Zero-page RAM of the RIOT and all its mirrors
+  inline bool isRAM(uInt16 address)
+  {
+    return (address & 0x1280) == 0x0080;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Expression::compile(CompiledExpression& program) const
+{
+  // Nodes without a specialised implementation may depend on anything
+  program.emitCall(*this, CompiledExpression::DEP_MEMORY);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CompiledExpression::CompiledExpression(Expression* exp)
+  : myExpression(exp),
+    myRoot(nullptr),
+    myDependencies(DEP_NONE),
+    myIsCacheable(false),
+    myCachedValue(0),
+    myCacheGeneration(0),
+    myCacheValid(false)
+{
+  myExpression->compile(*this);
+
+  // Now that the nodes don't move anymore, link them
+  for(uInt32 i = 0; i < myNodes.size(); ++i)
+  {
+    myNodes[i].lhs = myInfo[i].lhs >= 0 ? &myNodes[myInfo[i].lhs] : nullptr;
+    myNodes[i].rhs = myInfo[i].rhs >= 0 ? &myNodes[myInfo[i].rhs] : nullptr;
+  }
+  myRoot = &myNodes[myOperands.back()];
+
+  myInfo.clear();
+  myInfo.shrink_to_fit();
+  myOperands.clear();
+  myOperands.shrink_to_fit();
+
+  // Only RAM is tracked for changes while the CPU is running, everything
+  // else may change with each instruction
+  myIsCacheable = (myDependencies & ~DEP_RAM) == 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CompiledExpression::Node&
+CompiledExpression::addNode(Function eval, uInt32 operands, bool isBoolean)
+{
+  NodeInfo info = { -1, -1, false, isBoolean };
+  if(operands == 2)
+  {
+    info.rhs = Int32(myOperands.back());  myOperands.pop_back();
+  }
+  if(operands >= 1)
+  {
+    info.lhs = Int32(myOperands.back());  myOperands.pop_back();
+  }
+  myOperands.push_back(uInt32(myNodes.size()));
+  myInfo.push_back(info);
+
+  Node node;
+  node.eval = eval;
+  node.lhs = node.rhs = nullptr;
+  node.value = 0;
+  node.call = nullptr;
+  myNodes.push_back(node);
+
+  return myNodes.back();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompiledExpression::removeNode()
+{
+  myNodes.pop_back();
+  myInfo.pop_back();
+  myOperands.pop_back();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompiledExpression::emitConst(Int32 value)
+{
+  addNode(evalConst, 0).value = value;
+  myInfo.back().isConst = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompiledExpression::emitCall(const Expression& exp, uInt8 dependencies)
+{
+  myDependencies |= dependencies;
+  addNode(evalCall, 0).call = &exp;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompiledExpression::emitCpu(CpuMethod method)
+{
+  myDependencies |= DEP_CPU;
+  addNode(evalCpu, 0).cpu = method;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompiledExpression::emitTia(TiaMethod method)
+{
+  myDependencies |= DEP_TIA;
+  addNode(evalTia, 0).tia = method;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompiledExpression::emitCart(CartMethod method)
+{
+  myDependencies |= DEP_CART;
+  addNode(evalCart, 0).cart = method;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompiledExpression::emitPeek(bool word)
+{
+  if(operand(0).isConst)
+  {
+    // Dereferencing a constant address, which is the last node
+    Node& node = myNodes.back();
+    uInt16 address = uInt16(node.value);
+    node.eval = word ? evalDPeekConst : evalPeekConst;
+    node.value = address;
+    myInfo.back().isConst = false;
+
+    if(isRAM(address) && (!word || isRAM(address + 1)))
+      myDependencies |= DEP_RAM;
+    else
+      myDependencies |= DEP_MEMORY;
+  }
+  else
+  {
+    myDependencies |= DEP_MEMORY;
+    addNode(word ? evalDPeek : evalPeek, 1);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompiledExpression::emitUnary(Op op)
+{
+  if(operand(0).isConst)
+    myNodes.back().value = unary(op, myNodes.back().value);
+  else if(op != Op::Bool || !operand(0).isBoolean)
+    addNode(unaryFunction(op), 1, op == Op::LogNot || op == Op::Bool);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompiledExpression::emitBinary(Op op)
+{
+  bool isBoolean = op >= Op::Equals && op <= Op::GreaterEquals;
+
+  if(operand(0).isConst && operand(1).isConst)
+  {
+    // Both operands are constant, and the last two nodes
+    Int32 value = binary(op, myNodes[myNodes.size() - 2].value,
+                             myNodes[myNodes.size() - 1].value);
+    removeNode();
+    removeNode();
+    emitConst(value);
+  }
+  else if(operand(0).isConst)
+  {
+    // Only the right side is constant, it becomes part of the operation
+    Int32 value = myNodes.back().value;
+    removeNode();
+    addNode(binaryFunction(op, true), 1, isBoolean).value = value;
+  }
+  else
+    addNode(binaryFunction(op, false), 2, isBoolean);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CompiledExpression::emitLogical(Op op, const Expression& lhs,
+                                     const Expression& rhs)
+{
+  lhs.compile(*this);
+
+  if(operand(0).isConst)
+  {
+    // A constant left side either decides the result by itself, or the
+    // result is the truth value of the right side
+    bool value = myNodes.back().value != 0;
+    if(value == (op == Op::LogOr))
+    {
+      myNodes.back().value = value;
+      return;
+    }
+    removeNode();
+
+    rhs.compile(*this);
+    emitUnary(Op::Bool);
+  }
+  else
+  {
+    rhs.compile(*this);
+    addNode(op == Op::LogAnd ? evalLogAnd : evalLogOr, 2, true);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline Int32 CompiledExpression::unary(Op op, Int32 value)
+{
+  switch(op)
+  {
+    case Op::Neg:     return -value;
+    case Op::BinNot:  return ~value;
+    case Op::LogNot:  return !value;
+    case Op::LoByte:  return 0xff & value;
+    case Op::HiByte:  return 0xff & (value >> 8);
+    case Op::Bool:    return value != 0;
+    default:          return 0;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline Int32 CompiledExpression::binary(Op op, Int32 lhs, Int32 rhs)
+{
+  switch(op)
+  {
+    case Op::Add:           return lhs + rhs;
+    case Op::Sub:           return lhs - rhs;
+    case Op::Mult:          return lhs * rhs;
+    case Op::Div:           return rhs == 0 ? 0 : lhs / rhs;
+    case Op::Mod:           return rhs == 0 ? 0 : lhs % rhs;
+    case Op::BinAnd:        return lhs & rhs;
+    case Op::BinOr:         return lhs | rhs;
+    case Op::BinXor:        return lhs ^ rhs;
+    case Op::ShiftLeft:     return lhs << rhs;
+    case Op::ShiftRight:    return lhs >> rhs;
+    case Op::Equals:        return lhs == rhs;
+    case Op::NotEquals:     return lhs != rhs;
+    case Op::Less:          return lhs < rhs;
+    case Op::LessEquals:    return lhs <= rhs;
+    case Op::Greater:       return lhs > rhs;
+    case Op::GreaterEquals: return lhs >= rhs;
+    case Op::LogAnd:        return lhs && rhs;
+    case Op::LogOr:         return lhs || rhs;
+    default:                return 0;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CompiledExpression::Function CompiledExpression::unaryFunction(Op op)
+{
+  switch(op)
+  {
+    case Op::Neg:     return evalUnary<Op::Neg>;
+    case Op::BinNot:  return evalUnary<Op::BinNot>;
+    case Op::LogNot:  return evalUnary<Op::LogNot>;
+    case Op::LoByte:  return evalUnary<Op::LoByte>;
+    case Op::HiByte:  return evalUnary<Op::HiByte>;
+    default:          return evalUnary<Op::Bool>;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CompiledExpression::Function
+CompiledExpression::binaryFunction(Op op, bool constRight)
+{
+  #define BINARY(OP) \
+    case Op::OP: return constRight ? evalBinaryConst<Op::OP> : evalBinary<Op::OP>
+
+  switch(op)
+  {
+    BINARY(Add);
+    BINARY(Sub);
+    BINARY(Mult);
+    BINARY(Div);
+    BINARY(Mod);
+    BINARY(BinAnd);
+    BINARY(BinOr);
+    BINARY(BinXor);
+    BINARY(ShiftLeft);
+    BINARY(ShiftRight);
+    BINARY(Equals);
+    BINARY(NotEquals);
+    BINARY(Less);
+    BINARY(LessEquals);
+    BINARY(Greater);
+    BINARY(GreaterEquals);
+    default:  return nullptr;  // not a binary operation
+  }
+
+  #undef BINARY
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 CompiledExpression::evalConst(const Node& node)
+{
+  return node.value;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 CompiledExpression::evalPeekConst(const Node& node)
+{
+  return Debugger::debugger().peek(uInt16(node.value));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 CompiledExpression::evalDPeekConst(const Node& node)
+{
+  return Debugger::debugger().dpeekAsInt(node.value);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 CompiledExpression::evalPeek(const Node& node)
+{
+  return Debugger::debugger().peek(uInt16(node.lhs->eval(*node.lhs)));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 CompiledExpression::evalDPeek(const Node& node)
+{
+  return Debugger::debugger().dpeekAsInt(node.lhs->eval(*node.lhs));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 CompiledExpression::evalCpu(const Node& node)
+{
+  return (Debugger::debugger().cpuDebug().*node.cpu)();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 CompiledExpression::evalTia(const Node& node)
+{
+  return (Debugger::debugger().tiaDebug().*node.tia)();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 CompiledExpression::evalCart(const Node& node)
+{
+  return (Debugger::debugger().cartDebug().*node.cart)();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 CompiledExpression::evalCall(const Node& node)
+{
+  return node.call->evaluate();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 CompiledExpression::evalLogAnd(const Node& node)
+{
+  return node.lhs->eval(*node.lhs) && node.rhs->eval(*node.rhs);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 CompiledExpression::evalLogOr(const Node& node)
+{
+  return node.lhs->eval(*node.lhs) || node.rhs->eval(*node.rhs);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<CompiledExpression::Op OP>
+Int32 CompiledExpression::evalUnary(const Node& node)
+{
+  return unary(OP, node.lhs->eval(*node.lhs));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<CompiledExpression::Op OP>
+Int32 CompiledExpression::evalBinary(const Node& node)
+{
+  Int32 lhs = node.lhs->eval(*node.lhs);
+  return binary(OP, lhs, node.rhs->eval(*node.rhs));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<CompiledExpression::Op OP>
+Int32 CompiledExpression::evalBinaryConst(const Node& node)
+{
+  return binary(OP, node.lhs->eval(*node.lhs), node.value);
+}
@@ -0,0 +1,202 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef COMPILED_EXPRESSION_HXX
+#define COMPILED_EXPRESSION_HXX
+
+#include "bspf.hxx"
+#include "CartDebug.hxx"
+#include "CpuDebug.hxx"
+#include "TIADebug.hxx"
+#include "Expression.hxx"
+
+/**
+  This class lowers an expression tree into a chain of closures, which
+  are stored in one block of memory.  Constant subexpressions are folded,
+  and constant right sides become part of their operation.  Conditions
+  which are checked after every instruction (breakif, savestateif and
+  trapif) are evaluated this way.
+
+  The compiler also records which parts of the machine state the value
+  depends on.  Conditions which only read zero-page RAM at constant
+  addresses keep their last value until the CPU writes to RAM.
+*/
+class CompiledExpression
+{
+  public:
+    /**
+      The parts of the machine state an expression depends on
+    */
+    enum Dependency : uInt8 {
+      DEP_NONE   = 0,
+      DEP_RAM    = 1 << 0,  // zero-page RAM at constant addresses
+      DEP_MEMORY = 1 << 1,  // any other memory, or user defined functions
+      DEP_CPU    = 1 << 2,  // CPU registers and cycles
+      DEP_TIA    = 1 << 3,  // TIA state (scanlines, frames, cycles, ...)
+      DEP_CART   = 1 << 4   // cartridge state (bank, last accesses)
+    };
+
+    /**
+      The operations of the expression nodes
+    */
+    enum class Op : uInt8 {
+      // unary operations
+      Neg, BinNot, LogNot, LoByte, HiByte, Bool,
+      // binary operations
+      Add, Sub, Mult, Div, Mod, BinAnd, BinOr, BinXor, ShiftLeft, ShiftRight,
+      Equals, NotEquals, Less, LessEquals, Greater, GreaterEquals,
+      // binary operations which only evaluate their right side if needed
+      LogAnd, LogOr
+    };
+
+  public:
+    /**
+      Take ownership of the given expression tree and compile it.
+    */
+    explicit CompiledExpression(Expression* exp);
+    ~CompiledExpression() = default;
+
+    /**
+      Evaluate the expression.  If the value only depends on zero-page RAM,
+      the last value is returned as long as the given generation is the
+      same as in the last call.
+
+      @param generation  Changes whenever RAM may have been modified
+      @return  The value of the expression
+    */
+    Int32 evaluate(uInt64 generation) const {
+      if(myIsCacheable && myCacheValid && generation == myCacheGeneration)
+        return myCachedValue;
+
+      myCachedValue = myRoot->eval(*myRoot);
+      myCacheGeneration = generation;
+      myCacheValid = true;
+
+      return myCachedValue;
+    }
+
+    /**
+      Answer the parts of the machine state the expression depends on.
+    */
+    uInt8 dependencies() const { return myDependencies; }
+
+    /**
+      Methods used by the expression nodes to generate the closures, in
+      postfix order: the operands of an operation are emitted before it.
+    */
+    void emitConst(Int32 value);
+    void emitCall(const Expression& exp, uInt8 dependencies);
+    void emitCpu(CpuMethod method);
+    void emitTia(TiaMethod method);
+    void emitCart(CartMethod method);
+    void emitPeek(bool word);
+    void emitUnary(Op op);
+    void emitBinary(Op op);
+    void emitLogical(Op op, const Expression& lhs, const Expression& rhs);
+
+  private:
+    struct Node;
+    using Function = Int32 (*)(const Node&);
+
+    struct Node {
+      Function eval;
+      const Node* lhs;
+      const Node* rhs;
+      Int32 value;  // constant, constant address or constant right side
+      union {
+        CpuMethod cpu;
+        TiaMethod tia;
+        CartMethod cart;
+        const Expression* call;
+      };
+    };
+
+    // How the nodes are linked and what is known about them, while compiling
+    struct NodeInfo {
+      Int32 lhs, rhs;  // indices of the operands, or -1
+      bool isConst;    // the node is a constant
+      bool isBoolean;  // the node evaluates to 0 or 1 only
+    };
+
+    /**
+      Append a node, whose operands are the given number of nodes emitted
+      last.  The new node replaces them as an operand for later nodes.
+    */
+    Node& addNode(Function eval, uInt32 operands, bool isBoolean = false);
+
+    /**
+      Remove the last node, which must not have operands.
+    */
+    void removeNode();
+
+    const NodeInfo& operand(uInt32 fromTop) const {
+      return myInfo[myOperands[myOperands.size() - 1 - fromTop]];
+    }
+
+    static Int32 unary(Op op, Int32 value);
+    static Int32 binary(Op op, Int32 lhs, Int32 rhs);
+
+    static Function unaryFunction(Op op);
+    static Function binaryFunction(Op op, bool constRight);
+
+    // Evaluation of the nodes
+    static Int32 evalConst(const Node& node);
+    static Int32 evalPeekConst(const Node& node);
+    static Int32 evalDPeekConst(const Node& node);
+    static Int32 evalPeek(const Node& node);
+    static Int32 evalDPeek(const Node& node);
+    static Int32 evalCpu(const Node& node);
+    static Int32 evalTia(const Node& node);
+    static Int32 evalCart(const Node& node);
+    static Int32 evalCall(const Node& node);
+    static Int32 evalLogAnd(const Node& node);
+    static Int32 evalLogOr(const Node& node);
+    template<Op OP> static Int32 evalUnary(const Node& node);
+    template<Op OP> static Int32 evalBinary(const Node& node);
+    template<Op OP> static Int32 evalBinaryConst(const Node& node);
+
+  private:
+    // The expression the closures were compiled from; nodes which call
+    // expressions refer to its nodes
+    unique_ptr<Expression> myExpression;
+
+    // All nodes, the operands of a node are stored before it
+    vector<Node> myNodes;
+    const Node* myRoot;
+
+    // Only used while compiling: information for each node, and the nodes
+    // which aren't the operand of another node yet
+    vector<NodeInfo> myInfo;
+    vector<uInt32> myOperands;
+
+    uInt8 myDependencies;
+    bool myIsCacheable;
+
+    mutable Int32 myCachedValue;
+    mutable uInt64 myCacheGeneration;
+    mutable bool myCacheValid;
+
+  private:
+    // Following constructors and assignment operators not supported
+    CompiledExpression() = delete;
+    CompiledExpression(const CompiledExpression&) = delete;
+    CompiledExpression(CompiledExpression&&) = delete;
+    CompiledExpression& operator=(const CompiledExpression&) = delete;
+    CompiledExpression& operator=(CompiledExpression&&) = delete;
+};
+
+#endif
@@ -0,0 +1,162 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "Base.hxx"
+#include "CpuProfile.hxx"
+
+using Common::Base;
+
+namespace {
+  // Number of instructions and loops listed in the report
+  constexpr uInt32 HOT_INSTRUCTIONS = 40;
+  constexpr uInt32 HOT_LOOPS = 20;
+
+  string share(uInt64 cycles, uInt64 total)
+  {
+    ostringstream buf;
+    buf << std::fixed << std::setprecision(2) << std::setw(6)
+        << (total ? cycles * 100.0 / total : 0.0) << "%";
+    return buf.str();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CpuProfile::CpuProfile(uInt32 banks)
+  : myCounters(banks + 1)
+{
+  clear();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CpuProfile::clear()
+{
+  for(auto& counters: myCounters)
+    counters.reset();
+  myLoops.clear();
+
+  myScanlineCycles.fill(0);
+  myLastScanline = UINT_MAX;  // the first instruction starts a frame
+  myFrames = 0;
+
+  myCycles = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CpuProfile::Counter* CpuProfile::allocate(uInt32 bank)
+{
+  myCounters[bank] = make_unique<Counter[]>(BANK_SIZE);  // zero-initialized
+
+  return myCounters[bank].get();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CpuProfile::save(const string& filename) const
+{
+  ofstream out(filename);
+  if(!out.is_open())
+    return false;
+
+  // Addresses are shown in the upper 4K, except for code outside of the
+  // cartridge space
+  const auto address = [this](uInt32 bank, uInt32 offset) {
+    return bank == ramBank() ? offset : 0xf000 | offset;
+  };
+
+  struct Hotspot {
+    uInt32 bank, offset;
+    Counter counter;
+  };
+  vector<Hotspot> hotspots;
+  uInt64 instructions = 0;
+
+  for(uInt32 bank = 0; bank < myCounters.size(); ++bank)
+    if(myCounters[bank])
+      for(uInt32 offset = 0; offset < BANK_SIZE; ++offset)
+        if(myCounters[bank][offset].count)
+        {
+          hotspots.push_back({bank, offset, myCounters[bank][offset]});
+          instructions += myCounters[bank][offset].count;
+        }
+
+  out << "; CPU profile: " << instructions << " instructions, " << myCycles
+      << " cycles, " << myFrames << " frames" << endl;
+
+  // Instructions which took the most cycles
+  std::sort(hotspots.begin(), hotspots.end(),
+    [](const Hotspot& a, const Hotspot& b) { return a.counter.cycles > b.counter.cycles; });
+
+  out << endl
+      << "; Hottest instructions" << endl
+      << "; bank   address        count       cycles    share" << endl;
+  for(uInt32 i = 0; i < std::min(uInt32(hotspots.size()), HOT_INSTRUCTIONS); ++i)
+  {
+    const Hotspot& h = hotspots[i];
+    out << std::dec << std::setw(6) << h.bank
+        << "   $" << Base::HEX4 << address(h.bank, h.offset)
+        << std::dec << std::setfill(' ') << std::setw(13) << h.counter.count
+        << std::setw(13) << h.counter.cycles
+        << "  " << share(h.counter.cycles, myCycles) << endl;
+  }
+
+  // Loops which took the most cycles; all instructions inside the address
+  // range of a loop are accounted to it
+  struct Loop {
+    uInt32 bank, start, end;
+    uInt64 iterations, cycles;
+  };
+  vector<Loop> loops;
+
+  for(const auto& l: myLoops)
+  {
+    Loop loop{uInt32(l.first >> 32), uInt32(l.first >> 16) & (BANK_SIZE - 1),
+              uInt32(l.first) & (BANK_SIZE - 1), l.second, 0};
+    if(const Counter* counters = this->counters(loop.bank))
+      for(uInt32 offset = loop.start; offset <= loop.end; ++offset)
+        loop.cycles += counters[offset].cycles;
+    loops.push_back(loop);
+  }
+
+  std::sort(loops.begin(), loops.end(),
+    [](const Loop& a, const Loop& b) { return a.cycles > b.cycles; });
+
+  out << endl
+      << "; Hottest loops" << endl
+      << "; bank   start    end     iterations       cycles    share" << endl;
+  for(uInt32 i = 0; i < std::min(uInt32(loops.size()), HOT_LOOPS); ++i)
+  {
+    const Loop& l = loops[i];
+    out << std::dec << std::setw(6) << l.bank
+        << "   $" << Base::HEX4 << address(l.bank, l.start)
+        << "  $" << Base::HEX4 << address(l.bank, l.end)
+        << std::dec << std::setfill(' ') << std::setw(13) << l.iterations
+        << std::setw(13) << l.cycles
+        << "  " << share(l.cycles, myCycles) << endl;
+  }
+
+  // Cycles per scanline, averaged over all frames
+  const uInt32 frames = std::max(myFrames, 1u);
+
+  out << endl
+      << "; Average cycles per scanline (of 76)" << endl
+      << "; line   cycles" << endl;
+  for(uInt32 line = 0; line < MAX_SCANLINES; ++line)
+    if(myScanlineCycles[line])
+      out << std::dec << std::setw(6) << line << std::fixed << std::setprecision(1)
+          << std::setw(9) << double(myScanlineCycles[line]) / frames << endl;
+
+  return bool(out);
+}
@@ -0,0 +1,153 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef CPU_PROFILE_HXX
+#define CPU_PROFILE_HXX
+
+#include <array>
+#include <unordered_map>
+
+#include "bspf.hxx"
+
+/**
+  Counts how often the instruction at each address of each bank was
+  executed and how many cycles it took, including the penalties for
+  crossing pages (but not the cycles the CPU is halted by WSYNC).  The
+  cycles are also summed up per scanline, and backward branches and jumps
+  are counted as loop iterations.
+
+  The profile is filled by the CPU core while profiling is enabled (see the
+  'profile' debugger command); the ROM disassembly shows the share of
+  the cycles for each instruction.
+*/
+class CpuProfile
+{
+  public:
+    struct Counter {
+      uInt64 count;   // times executed
+      uInt64 cycles;  // cycles taken, including page crossings
+    };
+
+    // Number of addresses per bank
+    static constexpr uInt32 BANK_SIZE = 0x1000;
+
+    // Scanlines beyond this are summed up in the last one
+    static constexpr uInt32 MAX_SCANLINES = 320;
+
+  public:
+    /**
+      Create an empty profile.
+
+      @param banks  The number of banks of the cartridge; code executed
+                    outside of the cartridge space is accounted to an
+                    additional bank
+    */
+    explicit CpuProfile(uInt32 banks);
+    ~CpuProfile() = default;
+
+    /**
+      Account an executed instruction.
+
+      @param bank      The bank the instruction was fetched from
+      @param address   The address of the instruction
+      @param cycles    The cycles it took
+      @param scanline  The scanline it started on
+    */
+    void add(uInt32 bank, uInt16 address, uInt32 cycles, uInt32 scanline) {
+      Counter* counters = myCounters[bank].get();
+      if(!counters)
+        counters = allocate(bank);
+
+      Counter& counter = counters[address & (BANK_SIZE - 1)];
+      ++counter.count;
+      counter.cycles += cycles;
+      myCycles += cycles;
+
+      if(scanline < myLastScanline)  // a new frame has started
+        ++myFrames;
+      myLastScanline = scanline;
+      myScanlineCycles[std::min(scanline, MAX_SCANLINES - 1)] += cycles;
+    }
+
+    /**
+      Account a backward branch or jump, which is the end of a loop.
+
+      @param bank  The bank the branch was executed in
+      @param from  The address of the branch
+      @param to    The address of the start of the loop
+    */
+    void addLoop(uInt32 bank, uInt16 from, uInt16 to) {
+      ++myLoops[(uInt64(bank) << 32) | (uInt32(to) << 16) | from];
+    }
+
+    /**
+      Answer the bank code outside of the cartridge space is accounted to.
+    */
+    uInt32 ramBank() const { return uInt32(myCounters.size()) - 1; }
+
+    /**
+      Answer the counters of the given bank, or nullptr if no instruction
+      of the bank was executed yet.
+    */
+    const Counter* counters(uInt32 bank) const {
+      return bank < myCounters.size() ? myCounters[bank].get() : nullptr;
+    }
+
+    /**
+      Answer the cycles of all instructions accounted so far.
+    */
+    uInt64 cycles() const { return myCycles; }
+
+    /**
+      Remove all counts.
+    */
+    void clear();
+
+    /**
+      Write a report of the hottest instructions and loops, and of the
+      average cycles per scanline, to the given file.
+
+      @return  False if the file couldn't be written
+    */
+    bool save(const string& filename) const;
+
+  private:
+    Counter* allocate(uInt32 bank);
+
+  private:
+    // The counters of each bank, allocated when the bank is first executed
+    vector<unique_ptr<Counter[]>> myCounters;
+
+    // The iterations of each loop, by bank, start and end address
+    std::unordered_map<uInt64, uInt64> myLoops;
+
+    std::array<uInt64, MAX_SCANLINES> myScanlineCycles;
+    uInt32 myLastScanline;
+    uInt32 myFrames;
+
+    uInt64 myCycles;
+
+  private:
+    // Following constructors and assignment operators not supported
+    CpuProfile() = delete;
+    CpuProfile(const CpuProfile&) = delete;
+    CpuProfile(CpuProfile&&) = delete;
+    CpuProfile& operator=(const CpuProfile&) = delete;
+    CpuProfile& operator=(CpuProfile&&) = delete;
+};
+
+#endif
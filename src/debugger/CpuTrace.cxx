@@ -0,0 +1,90 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <fstream>
+
+#include "CpuTrace.hxx"
+
+namespace {
+  constexpr uInt32 HEADER_SIZE = 32;
+  constexpr uInt32 RECORD_SIZE = 16;
+  constexpr uInt16 VERSION = 1;
+
+  // Append a value in little endian byte order
+  template<typename T>
+  void put(uInt8*& out, T value)
+  {
+    for(uInt32 i = 0; i < sizeof(T); ++i)
+      *out++ = uInt8(value >> (i * 8));
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CpuTrace::CpuTrace()
+  : myRecords(make_unique<Record[]>(CAPACITY)),
+    myCount(0),
+    myLastCycles(0)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CpuTrace::save(const string& filename) const
+{
+  const uInt64 records = std::min(myCount, uInt64(CAPACITY));
+  const uInt64 first = myCount - records;
+
+  // The cycle count of the oldest record is reconstructed from the newest
+  // one, going back by the differences between the records
+  uInt64 firstCycles = myLastCycles;
+  for(uInt64 i = myCount - 1; records > 0 && i > first; --i)
+    firstCycles -= uInt32(myRecords[i & (CAPACITY - 1)].cycles -
+                          myRecords[(i - 1) & (CAPACITY - 1)].cycles);
+
+  ByteBuffer buffer = make_unique<uInt8[]>(HEADER_SIZE + records * RECORD_SIZE);
+  uInt8* out = buffer.get();
+
+  *out++ = 'S';  *out++ = 'T';  *out++ = 'C';  *out++ = 'T';
+  put(out, VERSION);
+  put(out, uInt16(RECORD_SIZE));
+  put(out, records);
+  put(out, first);
+  put(out, firstCycles);
+
+  for(uInt64 i = first; i < myCount; ++i)
+  {
+    const Record& r = myRecords[i & (CAPACITY - 1)];
+
+    put(out, r.cycles);
+    put(out, r.pc);
+    put(out, r.bank);
+    put(out, r.scanline);
+    put(out, r.clock);
+    put(out, r.a);
+    put(out, r.x);
+    put(out, r.y);
+    put(out, r.sp);
+    put(out, r.ps);
+  }
+
+  ofstream file(filename, std::ios::binary);
+  if(!file.is_open())
+    return false;
+
+  file.write(reinterpret_cast<const char*>(buffer.get()), out - buffer.get());
+
+  return bool(file);
+}
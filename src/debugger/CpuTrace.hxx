@@ -0,0 +1,117 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef CPU_TRACE_HXX
+#define CPU_TRACE_HXX
+
+#include "bspf.hxx"
+
+/**
+  A fixed size ring of the most recently executed instructions, filled by
+  the CPU core while tracing is enabled (see the 'cputrace' debugger
+  command and commandline option).  Each record holds the CPU state before
+  the instruction was executed, the bank and the TIA beam position.
+
+  The trace is written in a compact binary format, which can be converted
+  to text with the 'cputrace' tool in src/tools.  All values are stored
+  little endian:
+
+    Header (32 bytes)
+      char[4]  magic "STCT"
+      uInt16   format version (1)
+      uInt16   size of a record (16)
+      uInt64   number of records
+      uInt64   number of older records which were overwritten in the ring
+      uInt64   CPU cycle count of the first record
+
+    Record (16 bytes)
+      uInt32   lower 32 bits of the CPU cycle count
+      uInt16   PC
+      uInt16   bank
+      uInt16   scanline
+      uInt8    color clock within the scanline
+      uInt8    A, X, Y, SP and PS
+*/
+class CpuTrace
+{
+  public:
+    struct Record {
+      uInt32 cycles;
+      uInt16 pc;
+      uInt16 bank;
+      uInt16 scanline;
+      uInt8 clock;
+      uInt8 a, x, y, sp, ps;
+    };
+
+    // Number of records kept in the ring (16 MB, about 150 frames)
+    static constexpr uInt32 CAPACITY = 1 << 20;
+
+  public:
+    CpuTrace();
+    ~CpuTrace() = default;
+
+    /**
+      Get the record for the next instruction, overwriting the oldest one
+      once the ring is full.  The cycle count is filled in already.
+
+      @param cycles  The CPU cycle count before the instruction
+    */
+    Record& next(uInt64 cycles) {
+      Record& record = myRecords[myCount++ & (CAPACITY - 1)];
+      record.cycles = uInt32(cycles);
+      myLastCycles = cycles;
+
+      return record;
+    }
+
+    /**
+      Answer the number of instructions recorded since the last clear().
+    */
+    uInt64 size() const { return myCount; }
+
+    /**
+      Remove all records.
+    */
+    void clear() { myCount = 0; }
+
+    /**
+      Write the records in the ring, oldest first, to the given file.
+
+      @return  False if the file couldn't be written
+    */
+    bool save(const string& filename) const;
+
+  private:
+    unique_ptr<Record[]> myRecords;
+
+    // Number of records since the last clear()
+    uInt64 myCount;
+
+    // Full cycle count of the newest record; the records only store the
+    // lower 32 bits
+    uInt64 myLastCycles;
+
+  private:
+    // Following constructors and assignment operators not supported
+    CpuTrace(const CpuTrace&) = delete;
+    CpuTrace(CpuTrace&&) = delete;
+    CpuTrace& operator=(const CpuTrace&) = delete;
+    CpuTrace& operator=(CpuTrace&&) = delete;
+};
+
+#endif
@@ -49,7 +49,10 @@
 
 #include "RomWidget.hxx"
 #include "Expression.hxx"
+#include "CompiledExpression.hxx"
 #include "PackedBitArray.hxx"
+#include "Keyframes.hxx"
+#include "Serializer.hxx"
 #include "YaccParser.hxx"
 
 #include "TIA.hxx"
@@ -65,7 +68,9 @@ Debugger::Debugger(OSystem& osystem, Console& console)
     mySystem(console.system()),
     myDialog(nullptr),
     myWidth(DebuggerDialog::kSmallFontMinW),
-    myHeight(DebuggerDialog::kSmallFontMinH)
+    myHeight(DebuggerDialog::kSmallFontMinH),
+    myKeyframing(false),
+    myReplaying(false)
 {
   // Init parser
   myParser = make_unique<DebuggerParser>(*this, osystem.settings());
@@ -76,6 +81,12 @@ Debugger::Debugger(OSystem& osystem, Console& console)
   myRiotDebug = make_unique<RiotDebug>(*this, myConsole);
   myTiaDebug  = make_unique<TIADebug>(*this, myConsole);
 
+  myKeyframes = make_unique<Keyframes>();
+
+  // Record all executed instructions, if requested on the commandline
+  if(!osystem.settings().getString("cputrace").empty())
+    mySystem.m6502().enableCpuTrace(true);
+
   // Allow access to this object from any class
   // Technically this violates pure OO programming, but since I know
   // there will only be ever one instance of debugger in Stella,
@@ -320,11 +331,50 @@ int Debugger::trace()
     return step();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int Debugger::runUntil(const PackedBitArray* addresses,
+                       const CompiledExpression* condition,
+                       uInt64 maxInstructions, const string& rewindMsg,
+                       uInt64& instructions, string& message)
+{
+  saveOldState();
+
+  uInt64 startCycle = mySystem.cycles();
+  M6502& cpu = mySystem.m6502();
+  message = "";
+
+  unlockSystem();
+  cpu.startRunUntil(addresses, condition, maxInstructions);
+  do
+  {
+    // Run for up to a frame at a time; the CPU stops by itself as soon as
+    // one of the conditions is met
+    DispatchResult result;
+    cpu.execute(76 * 262, result);
+
+    if(result.getStatus() == DispatchResult::Status::debugger)
+    {
+      message = result.getMessage();
+      break;
+    }
+    else if(!result.isSuccess())
+      break;
+  }
+  while(!cpu.runUntilDone());
+  instructions = cpu.stopRunUntil();
+  myOSystem.console().tia().flushLineCache();
+  lockSystem();
+
+  addState(rewindMsg);
+  return int(mySystem.cycles() - startCycle);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Debugger::toggleBreakPoint(uInt16 bp)
 {
   breakPoints().initialize();
   breakPoints().toggle(bp);
+  mySystem.m6502().updateInstrumentation();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -333,6 +383,7 @@ void Debugger::setBreakPoint(uInt16 bp, bool set)
   breakPoints().initialize();
   if(set) breakPoints().set(bp);
   else    breakPoints().clear(bp);
+  mySystem.m6502().updateInstrumentation();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -346,12 +397,14 @@ void Debugger::addReadTrap(uInt16 t)
 {
   readTraps().initialize();
   readTraps().add(t);
+  mySystem.m6502().updateInstrumentation();
 }
 
 void Debugger::addWriteTrap(uInt16 t)
 {
   writeTraps().initialize();
   writeTraps().add(t);
+  mySystem.m6502().updateInstrumentation();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -366,12 +419,14 @@ void Debugger::removeReadTrap(uInt16 t)
 {
   readTraps().initialize();
   readTraps().remove(t);
+  mySystem.m6502().updateInstrumentation();
 }
 
 void Debugger::removeWriteTrap(uInt16 t)
 {
   writeTraps().initialize();
   writeTraps().remove(t);
+  mySystem.m6502().updateInstrumentation();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -566,10 +621,248 @@ uInt16 Debugger::unwindStates(const uInt16 numStates, string& message)
   return windStates(numStates, true, message);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int Debugger::reverseStep(string& message)
+{
+  return reverse(Reverse::step, message);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int Debugger::reverseTrace(string& message)
+{
+  return reverse(Reverse::trace, message);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int Debugger::reverseContinue(string& message)
+{
+  return reverse(Reverse::cont, message);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Debugger::updateKeyframes()
+{
+  const uInt64 cycles = mySystem.cycles();
+
+  if(!myKeyframing || myReplaying || !myKeyframes->due(cycles))
+    return;
+
+  Serializer& state = myKeyframes->add(cycles);
+  if(!myOSystem.state().saveState(state) ||
+     !myOSystem.console().tia().saveDisplay(state))
+    myKeyframes->removeLast();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Debugger::stopsArmed() const
+{
+  return breakPoints().isAnySet() || readTraps().isAnySet() ||
+         writeTraps().isAnySet() || !mySystem.m6502().getCondBreakNames().empty();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int Debugger::reverse(Reverse mode, string& message)
+{
+  const uInt64 startCycles = mySystem.cycles();
+  Int32 keyframe = myKeyframes->find(startCycles);
+  message = "";
+
+  if(keyframe < 0)
+  {
+    message = "no keyframe to go back from";
+    return 0;
+  }
+
+  saveOldState();
+
+  // Keep the current state, in case it isn't reached again
+  Serializer current, expected, replayed;
+  if(!myOSystem.state().saveState(current) ||
+     !myOSystem.console().tia().saveDisplay(current))
+  {
+    message = "unable to save the current state";
+    return 0;
+  }
+  saveFingerprint(expected);
+
+  // Nothing is recorded while replaying; the input is taken from the
+  // current events, not from the Time Machine's input log
+  M6502& cpu = mySystem.m6502();
+  M6532& riot = myConsole.riot();
+  const bool cpuTrace = cpu.cpuTraceEnabled(), cpuProfile = cpu.cpuProfileEnabled();
+  M6532::PortHandler* portHandler = riot.portHandler();
+
+  cpu.enableCpuTrace(false);
+  cpu.enableCpuProfile(false);
+  riot.setPortHandler(nullptr);
+  myReplaying = true;
+  unlockSystem();
+
+  vector<Boundary> boundaries;
+  vector<Hit> hits;
+  uInt64 endCycles = startCycles;
+  Int32 target = -1;  // the boundary to go back to
+  bool reached = true;
+
+  while(reached && target < 0 && keyframe >= 0)
+  {
+    // The replay must end in the same state as the original execution
+    reached = replay(keyframe, endCycles, boundaries, hits);
+    if(reached)
+    {
+      replayed.rewind();
+      saveFingerprint(replayed);
+      reached = replayed.size() == expected.size() &&
+                memcmp(replayed.data(), expected.data(), expected.size()) == 0;
+    }
+    if(!reached)
+      break;
+
+    const Int32 last = Int32(boundaries.size()) - 1;
+    switch(mode)
+    {
+      case Reverse::step:
+        target = last - 1;
+        break;
+
+      case Reverse::trace:
+      {
+        // Coming from an RTS, go back over the whole subroutine to its JSR;
+        // the stack is below the return address while inside of it
+        const uInt8 sp = boundaries[last].sp;
+        target = last - 1;
+        if(boundaries[target].sp == uInt8(sp - 2))
+        {
+          Int32 jsr = target;
+          while(jsr > 0 && boundaries[jsr].sp < sp)
+            --jsr;
+          if(boundaries[jsr].sp == sp && boundaries[jsr + 1].sp == uInt8(sp - 2))
+            target = jsr;
+        }
+        break;
+      }
+
+      case Reverse::cont:
+        // A stop at the end of an older segment is a trap, which was hit
+        // by its last instruction; the current stop doesn't count
+        for(auto hit = hits.rbegin(); hit != hits.rend(); ++hit)
+          if(Int32(hit->boundary) < last || endCycles != startCycles)
+          {
+            target = Int32(hit->boundary);
+            message = hit->message;
+            break;
+          }
+
+        if(target < 0 && keyframe > 0)
+        {
+          // Continue with the previous keyframe, up to the start of this one
+          reached = replay(keyframe, myKeyframes->cycles(keyframe), boundaries, hits);
+          expected.rewind();
+          saveFingerprint(expected);
+          endCycles = myKeyframes->cycles(keyframe);
+        }
+        --keyframe;
+        break;
+    }
+  }
+
+  if(reached && target >= 0)
+  {
+    if(mode == Reverse::cont)
+      ++keyframe;
+    reached = replay(keyframe, boundaries[target].cycles, boundaries, hits);
+  }
+
+  if(!reached || target < 0)
+  {
+    // Back to where we came from
+    current.rewind();
+    myOSystem.state().loadState(current);
+    myOSystem.console().tia().loadDisplay(current);
+
+    if(!reached)
+      message = "the replay differs from the original execution (input changed?)";
+    else
+      message = "no breakpoint or trap hit in the last " +
+                std::to_string(Keyframes::CAPACITY) + " keyframes";
+  }
+
+  // Don't stop again right where we arrived
+  cpu.setLastBreakCycle(mySystem.cycles());
+
+  myReplaying = false;
+  riot.setPortHandler(portHandler);
+  cpu.enableCpuTrace(cpuTrace);
+  cpu.enableCpuProfile(cpuProfile);
+  myOSystem.console().tia().flushLineCache();
+  lockSystem();
+
+  return int(startCycles - mySystem.cycles());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Debugger::replay(uInt32 keyframe, uInt64 cycles,
+                      vector<Boundary>& boundaries, vector<Hit>& hits)
+{
+  M6502& cpu = mySystem.m6502();
+
+  boundaries.clear();
+  hits.clear();
+
+  Serializer& state = myKeyframes->state(keyframe);
+  if(!myOSystem.state().loadState(state) ||
+     !myOSystem.console().tia().loadDisplay(state))
+    return false;
+
+  // Stops at the keyframe itself are recorded as well
+  cpu.setLastBreakCycle(ULLONG_MAX);
+  boundaries.push_back({ mySystem.cycles(), uInt8(myCpuDebug->sp()) });
+
+  while(mySystem.cycles() < cycles)
+  {
+    DispatchResult result;
+    cpu.execute(1, result);
+
+    if(mySystem.cycles() != boundaries.back().cycles)
+      boundaries.push_back({ mySystem.cycles(), uInt8(myCpuDebug->sp()) });
+
+    if(result.getStatus() == DispatchResult::Status::debugger)
+    {
+      ostringstream buf;
+      buf << result.getMessage();
+      if(result.getAddress() > -1)
+        buf << cartDebug().getLabel(result.getAddress(), result.wasReadTrap(), 4);
+      hits.push_back({ uInt32(boundaries.size() - 1), buf.str() });
+    }
+    else if(!result.isSuccess())
+      return false;
+  }
+
+  return mySystem.cycles() == cycles;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Debugger::saveFingerprint(Serializer& out)
+{
+  out.putLong(mySystem.cycles());
+  out.putShort(uInt16(myCpuDebug->pc()));
+  out.putByte(uInt8(myCpuDebug->sp()));
+  out.putByte(uInt8(myCpuDebug->a()));
+  out.putByte(uInt8(myCpuDebug->x()));
+  out.putByte(uInt8(myCpuDebug->y()));
+  out.putByte(uInt8((myCpuDebug->n() << 7) | (myCpuDebug->v() << 6) |
+                    (myCpuDebug->d() << 3) | (myCpuDebug->i() << 2) |
+                    (myCpuDebug->z() << 1) |  myCpuDebug->c()));
+
+  // RIOT RAM, timer and ports
+  myConsole.riot().save(out);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Debugger::clearAllBreakPoints()
 {
   breakPoints().clearAll();
+  mySystem.m6502().updateInstrumentation();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -577,6 +870,7 @@ void Debugger::clearAllTraps()
 {
   readTraps().clearAll();
   writeTraps().clearAll();
+  mySystem.m6502().updateInstrumentation();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -614,6 +908,10 @@ void Debugger::saveOldState(bool clearDirtyPages)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Debugger::addState(string rewindMsg)
 {
+  // Replaying for reverse execution must not change the Time Machine
+  if(myReplaying)
+    return;
+
   // Add another rewind level to the Time Machine buffer
   RewindManager& r = myOSystem.state().rewindManager();
   r.addState(rewindMsg);
@@ -635,6 +933,10 @@ void Debugger::setStartState()
   else
     updateRewindbuttons(r);
 
+  // Until the debugger is left, keyframes for reverse execution are taken
+  myKeyframing = true;
+  updateKeyframes();
+
   // Set the 're-disassemble' flag, but don't do it until the next scheduled time
   myDialog->rom().invalidate(false);
 }
@@ -644,6 +946,14 @@ void Debugger::setQuitState()
 {
   saveOldState();
 
+  // While the emulation can stop again, keyframes are also taken while it
+  // runs, so 'reversecontinue' can go back to the previous stop.  Otherwise
+  // the ones taken so far would be separated from the next debugger
+  // session by a gap.
+  myKeyframing = stopsArmed();
+  if(!myKeyframing)
+    myKeyframes->clear();
+
   // Bus must be unlocked for normal operation when leaving debugger mode
   unlockSystem();
 
@@ -27,6 +27,7 @@ class TiaZoomWidget;
 class EditTextWidget;
 class RomWidget;
 class Expression;
+class CompiledExpression;
 class PackedBitArray;
 class TrapArray;
 class PromptWidget;
@@ -40,6 +41,8 @@ class RiotDebug;
 class TIADebug;
 class DebuggerParser;
 class RewindManager;
+class Keyframes;
+class Serializer;
 
 #include <map>
 
@@ -274,11 +277,45 @@ class Debugger : public DialogContainer
 
     int step();
     int trace();
+
+    /**
+      Run the CPU until one of the given conditions is met (see
+      M6502::startRunUntil()), or a breakpoint or trap is hit.  Like
+      step(), the old state is saved once before and a rewind state is
+      added once after running.
+
+      @param addresses        The addresses to stop at, or nullptr
+      @param condition        The condition to run while, or nullptr
+      @param maxInstructions  The maximum number of instructions, or 0
+      @param rewindMsg        The message for the rewind state
+      @param instructions     Set to the number of instructions executed
+      @param message          Set to the message of the breakpoint or trap
+                              which stopped the run, or empty
+      @return  The number of cycles executed
+    */
+    int runUntil(const PackedBitArray* addresses,
+                 const CompiledExpression* condition, uInt64 maxInstructions,
+                 const string& rewindMsg, uInt64& instructions,
+                 string& message);
     void nextScanline(int lines);
     void nextFrame(int frames);
     uInt16 rewindStates(const uInt16 numStates, string& message);
     uInt16 unwindStates(const uInt16 numStates, string& message);
 
+    /**
+      Go back in time by one instruction (reverseStep()), by one
+      instruction treating a subroutine call as one instruction
+      (reverseTrace()), or to the previous stop at a breakpoint, trap or
+      condition (reverseContinue()).  See reverse() for details.
+
+      @param message  Set to the reason why going back failed, or to the
+                      message of the breakpoint or trap gone back to
+      @return  The number of cycles gone back, or 0 if it failed
+    */
+    int reverseStep(string& message);
+    int reverseTrace(string& message);
+    int reverseContinue(string& message);
+
     void toggleBreakPoint(uInt16 bp);
 
     bool breakPoint(uInt16 bp);
@@ -333,7 +370,67 @@ class Debugger : public DialogContainer
     static BuiltinFunction ourBuiltinFunctions[NUM_BUILTIN_FUNCS];
     static PseudoRegister ourPseudoRegisters[NUM_PSEUDO_REGS];
 
+    // The snapshots for reverse execution; they are taken while the
+    // debugger is active or the emulation can stop at a breakpoint, trap
+    // or condition, but not while replaying from them
+    unique_ptr<Keyframes> myKeyframes;
+    bool myKeyframing;
+    bool myReplaying;
+
+    // The start of an instruction, and a stop of the CPU, during a replay
+    struct Boundary {
+      uInt64 cycles;
+      uInt8 sp;
+    };
+    struct Hit {
+      uInt32 boundary;
+      string message;
+    };
+    enum class Reverse { step, trace, cont };
+
   private:
+    /**
+      Take a keyframe for reverse execution, if one is due.  Called by the
+      CPU each time before it executes.
+    */
+    void updateKeyframes();
+
+    /**
+      Answer whether the emulation can stop at a breakpoint, trap or
+      condition, and thus needs keyframes while it runs.
+    */
+    bool stopsArmed() const;
+
+    /**
+      Go back in time.  The latest keyframe before the current cycles is
+      loaded, and the CPU executes from there one instruction at a time,
+      recording the start of each instruction and each stop at a
+      breakpoint or trap, until it reaches the current cycles again.  Then
+      the keyframe is loaded again, and the CPU executes up to the target.
+      For 'cont', older keyframes are searched as well until a stop is
+      found.
+
+      If the replay doesn't reach the current state again (because the
+      input changed since the keyframe was taken), the current state is
+      restored and going back fails.
+    */
+    int reverse(Reverse mode, string& message);
+
+    /**
+      Load the given keyframe and execute from there until the given
+      cycles, recording the start of each instruction and each stop.
+
+      @return  False if the cycles couldn't be reached exactly
+    */
+    bool replay(uInt32 keyframe, uInt64 cycles,
+                vector<Boundary>& boundaries, vector<Hit>& hits);
+
+    /**
+      Save enough of the current state to tell whether a replay reached
+      the same state again.
+    */
+    void saveFingerprint(Serializer& out);
+
     // rewind/unwind n states
     uInt16 windStates(uInt16 numStates, bool unwind, string& message);
     // update the rewind/unwind button state
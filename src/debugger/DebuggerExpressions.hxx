@@ -18,14 +18,13 @@
 #ifndef DEBUGGER_EXPRESSIONS_HXX
 #define DEBUGGER_EXPRESSIONS_HXX
 
-#include <functional>
-
 #include "bspf.hxx"
 #include "CartDebug.hxx"
 #include "CpuDebug.hxx"
 #include "TIADebug.hxx"
 #include "Debugger.hxx"
 #include "Expression.hxx"
+#include "CompiledExpression.hxx"
 
 /**
   All expressions currently supported by the debugger.
@@ -39,6 +38,10 @@ class BinAndExpression : public Expression
     BinAndExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() & myRHS->evaluate(); }
+    void compile(CompiledExpression& program) const override
+      { myLHS->compile(program);
+        myRHS->compile(program);
+        program.emitBinary(CompiledExpression::Op::BinAnd); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -48,6 +51,9 @@ class BinNotExpression : public Expression
     BinNotExpression(Expression* left) : Expression(left) { }
     Int32 evaluate() const override
       { return ~(myLHS->evaluate()); }
+    void compile(CompiledExpression& program) const override
+      { myLHS->compile(program);
+        program.emitUnary(CompiledExpression::Op::BinNot); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -57,6 +63,10 @@ class BinOrExpression : public Expression
     BinOrExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() | myRHS->evaluate(); }
+    void compile(CompiledExpression& program) const override
+      { myLHS->compile(program);
+        myRHS->compile(program);
+        program.emitBinary(CompiledExpression::Op::BinOr); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -66,6 +76,10 @@ class BinXorExpression : public Expression
     BinXorExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() ^ myRHS->evaluate(); }
+    void compile(CompiledExpression& program) const override
+      { myLHS->compile(program);
+        myRHS->compile(program);
+        program.emitBinary(CompiledExpression::Op::BinXor); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -75,6 +89,9 @@ class ByteDerefExpression : public Expression
     ByteDerefExpression(Expression* left): Expression(left) { }
     Int32 evaluate() const override
       { return Debugger::debugger().peek(myLHS->evaluate()); }
+    void compile(CompiledExpression& program) const override
+      { myLHS->compile(program);
+        program.emitPeek(false); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -84,6 +101,11 @@ class ByteDerefOffsetExpression : public Expression
     ByteDerefOffsetExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return Debugger::debugger().peek(myLHS->evaluate() + myRHS->evaluate()); }
+    void compile(CompiledExpression& program) const override
+      { myLHS->compile(program);
+        myRHS->compile(program);
+        program.emitBinary(CompiledExpression::Op::Add);
+        program.emitPeek(false); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -93,6 +115,8 @@ class ConstExpression : public Expression
     ConstExpression(const int value) : Expression(), myValue(value) { }
     Int32 evaluate() const override
       { return myValue; }
+    void compile(CompiledExpression& program) const override
+      { program.emitConst(myValue); }
 
   private:
     int myValue;
@@ -102,12 +126,14 @@ class ConstExpression : public Expression
 class CpuMethodExpression : public Expression
 {
   public:
-    CpuMethodExpression(CpuMethod method) : Expression(), myMethod(std::mem_fn(method)) { }
+    CpuMethodExpression(CpuMethod method) : Expression(), myMethod(method) { }
     Int32 evaluate() const override
-      { return myMethod(Debugger::debugger().cpuDebug()); }
+      { return (Debugger::debugger().cpuDebug().*myMethod)(); }
+    void compile(CompiledExpression& program) const override
+      { program.emitCpu(myMethod); }
 
   private:
-    std::function<int(const CpuDebug&)> myMethod;
+    CpuMethod myMethod;
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -118,6 +144,10 @@ class DivExpression : public Expression
     Int32 evaluate() const override
       { int denom = myRHS->evaluate();
         return denom == 0 ? 0 : myLHS->evaluate() / denom; }
+    void compile(CompiledExpression& program) const override
+      { myLHS->compile(program);
+        myRHS->compile(program);
+        program.emitBinary(CompiledExpression::Op::Div); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -127,6 +157,10 @@ class EqualsExpression : public Expression
     EqualsExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() == myRHS->evaluate(); }
+    void compile(CompiledExpression& program) const override
+      { myLHS->compile(program);
+        myRHS->compile(program);
+        program.emitBinary(CompiledExpression::Op::Equals); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -136,6 +170,8 @@ class EquateExpression : public Expression
     EquateExpression(const string& label) : Expression(), myLabel(label) { }
     Int32 evaluate() const override
       { return Debugger::debugger().cartDebug().getAddress(myLabel); }
+    void compile(CompiledExpression& program) const override
+      { program.emitCall(*this, CompiledExpression::DEP_NONE); }
 
   private:
     string myLabel;
@@ -148,6 +184,14 @@ class FunctionExpression : public Expression
     FunctionExpression(const string& label) : Expression(), myLabel(label) { }
     Int32 evaluate() const override
       { return Debugger::debugger().getFunction(myLabel).evaluate(); }
+    void compile(CompiledExpression& program) const override
+      { // Built-in functions can't be redefined or deleted, so their
+        // definition can be inlined
+        Debugger& debugger = Debugger::debugger();
+        if(debugger.isBuiltinFunction(myLabel))
+          debugger.getFunction(myLabel).compile(program);
+        else
+          program.emitCall(*this, CompiledExpression::DEP_MEMORY); }
 
   private:
     string myLabel;
@@ -160,6 +204,10 @@ class GreaterEqualsExpression : public Expression
     GreaterEqualsExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() >= myRHS->evaluate(); }
+    void compile(CompiledExpression& program) const override
+      { myLHS->compile(program);
+        myRHS->compile(program);
+        program.emitBinary(CompiledExpression::Op::GreaterEquals); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -169,6 +217,10 @@ class GreaterExpression : public Expression
     GreaterExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() > myRHS->evaluate(); }
+    void compile(CompiledExpression& program) const override
+      { myLHS->compile(program);
+        myRHS->compile(program);
+        program.emitBinary(CompiledExpression::Op::Greater); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -178,6 +230,9 @@ class HiByteExpression : public Expression
     HiByteExpression(Expression* left) : Expression(left) { }
     Int32 evaluate() const override
       { return 0xff & (myLHS->evaluate() >> 8); }
+    void compile(CompiledExpression& program) const override
+      { myLHS->compile(program);
+        program.emitUnary(CompiledExpression::Op::HiByte); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -187,6 +242,10 @@ class LessEqualsExpression : public Expression
     LessEqualsExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() <= myRHS->evaluate(); }
+    void compile(CompiledExpression& program) const override
+      { myLHS->compile(program);
+        myRHS->compile(program);
+        program.emitBinary(CompiledExpression::Op::LessEquals); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -196,6 +255,10 @@ class LessExpression : public Expression
     LessExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() < myRHS->evaluate(); }
+    void compile(CompiledExpression& program) const override
+      { myLHS->compile(program);
+        myRHS->compile(program);
+        program.emitBinary(CompiledExpression::Op::Less); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -205,6 +268,9 @@ class LoByteExpression : public Expression
     LoByteExpression(Expression* left) : Expression(left) { }
     Int32 evaluate() const override
       { return 0xff & myLHS->evaluate(); }
+    void compile(CompiledExpression& program) const override
+      { myLHS->compile(program);
+        program.emitUnary(CompiledExpression::Op::LoByte); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -214,6 +280,8 @@ class LogAndExpression : public Expression
     LogAndExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() && myRHS->evaluate(); }
+    void compile(CompiledExpression& program) const override
+      { program.emitLogical(CompiledExpression::Op::LogAnd, *myLHS, *myRHS); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -223,6 +291,9 @@ class LogNotExpression : public Expression
     LogNotExpression(Expression* left) : Expression(left) { }
     Int32 evaluate() const override
       { return !(myLHS->evaluate()); }
+    void compile(CompiledExpression& program) const override
+      { myLHS->compile(program);
+        program.emitUnary(CompiledExpression::Op::LogNot); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -232,6 +303,8 @@ class LogOrExpression : public Expression
     LogOrExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() || myRHS->evaluate(); }
+    void compile(CompiledExpression& program) const override
+      { program.emitLogical(CompiledExpression::Op::LogOr, *myLHS, *myRHS); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -241,6 +314,10 @@ class MinusExpression : public Expression
     MinusExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() - myRHS->evaluate(); }
+    void compile(CompiledExpression& program) const override
+      { myLHS->compile(program);
+        myRHS->compile(program);
+        program.emitBinary(CompiledExpression::Op::Sub); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -251,6 +328,10 @@ class ModExpression : public Expression
     Int32 evaluate() const override
       { int rhs = myRHS->evaluate();
         return rhs == 0 ? 0 : myLHS->evaluate() % rhs; }
+    void compile(CompiledExpression& program) const override
+      { myLHS->compile(program);
+        myRHS->compile(program);
+        program.emitBinary(CompiledExpression::Op::Mod); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -260,6 +341,10 @@ class MultExpression : public Expression
     MultExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() * myRHS->evaluate(); }
+    void compile(CompiledExpression& program) const override
+      { myLHS->compile(program);
+        myRHS->compile(program);
+        program.emitBinary(CompiledExpression::Op::Mult); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -269,6 +354,10 @@ class NotEqualsExpression : public Expression
     NotEqualsExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() != myRHS->evaluate(); }
+    void compile(CompiledExpression& program) const override
+      { myLHS->compile(program);
+        myRHS->compile(program);
+        program.emitBinary(CompiledExpression::Op::NotEquals); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -278,18 +367,24 @@ class PlusExpression : public Expression
     PlusExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() + myRHS->evaluate(); }
+    void compile(CompiledExpression& program) const override
+      { myLHS->compile(program);
+        myRHS->compile(program);
+        program.emitBinary(CompiledExpression::Op::Add); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 class CartMethodExpression : public Expression
 {
   public:
-    CartMethodExpression(CartMethod method) : Expression(), myMethod(std::mem_fn(method)) { }
+    CartMethodExpression(CartMethod method) : Expression(), myMethod(method) { }
     Int32 evaluate() const override
-      { return myMethod(Debugger::debugger().cartDebug()); }
+      { return (Debugger::debugger().cartDebug().*myMethod)(); }
+    void compile(CompiledExpression& program) const override
+      { program.emitCart(myMethod); }
 
   private:
-    std::function<int(CartDebug&)> myMethod;
+    CartMethod myMethod;
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -299,6 +394,10 @@ class ShiftLeftExpression : public Expression
     ShiftLeftExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() << myRHS->evaluate(); }
+    void compile(CompiledExpression& program) const override
+      { myLHS->compile(program);
+        myRHS->compile(program);
+        program.emitBinary(CompiledExpression::Op::ShiftLeft); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -308,18 +407,24 @@ class ShiftRightExpression : public Expression
     ShiftRightExpression(Expression* left, Expression* right) : Expression(left, right) { }
     Int32 evaluate() const override
       { return myLHS->evaluate() >> myRHS->evaluate(); }
+    void compile(CompiledExpression& program) const override
+      { myLHS->compile(program);
+        myRHS->compile(program);
+        program.emitBinary(CompiledExpression::Op::ShiftRight); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 class TiaMethodExpression : public Expression
 {
   public:
-    TiaMethodExpression(TiaMethod method) : Expression(), myMethod(std::mem_fn(method)) { }
+    TiaMethodExpression(TiaMethod method) : Expression(), myMethod(method) { }
     Int32 evaluate() const override
-      { return myMethod(Debugger::debugger().tiaDebug()); }
+      { return (Debugger::debugger().tiaDebug().*myMethod)(); }
+    void compile(CompiledExpression& program) const override
+      { program.emitTia(myMethod); }
 
   private:
-    std::function<int(const TIADebug&)> myMethod;
+    TiaMethod myMethod;
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -329,6 +434,9 @@ class UnaryMinusExpression : public Expression
     UnaryMinusExpression(Expression* left) : Expression(left) { }
     Int32 evaluate() const override
       { return -(myLHS->evaluate()); }
+    void compile(CompiledExpression& program) const override
+      { myLHS->compile(program);
+        program.emitUnary(CompiledExpression::Op::Neg); }
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -338,6 +446,9 @@ class WordDerefExpression : public Expression
     WordDerefExpression(Expression* left) : Expression(left) { }
     Int32 evaluate() const override
       { return Debugger::debugger().dpeekAsInt(myLHS->evaluate()); }
+    void compile(CompiledExpression& program) const override
+      { myLHS->compile(program);
+        program.emitPeek(true); }
 };
 
 #endif
@@ -29,11 +29,13 @@
 #include "YaccParser.hxx"
 #include "M6502.hxx"
 #include "Expression.hxx"
+#include "CompiledExpression.hxx"
+#include "CpuTrace.hxx"
+#include "CpuProfile.hxx"
 #include "FSNode.hxx"
 #include "Settings.hxx"
 #include "PromptWidget.hxx"
 #include "RomWidget.hxx"
-#include "ProgressDialog.hxx"
 #include "PackedBitArray.hxx"
 #include "TimerManager.hxx"
 #include "Vec.hxx"
@@ -827,6 +829,16 @@ void DebuggerParser::executeClearconfig()
     commandResult << debugger.cartDebug().clearConfig();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "clearprofile"
+void DebuggerParser::executeClearprofile()
+{
+  CpuProfile* profile = debugger.m6502().cpuProfile();
+  if(profile)
+    profile->clear();
+  commandResult << "CPU profile cleared";
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "clearbreaks"
 void DebuggerParser::executeClearsavestateifs()
@@ -892,6 +904,19 @@ void DebuggerParser::executeColortest()
                 << inverse("        ");
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "cputrace"
+void DebuggerParser::executeCputrace()
+{
+  M6502& cpu = debugger.m6502();
+  bool enable = argCount == 0 ? !cpu.cpuTraceEnabled() : args[0] != 0;
+
+  cpu.enableCpuTrace(enable);
+  commandResult << "CPU trace " << (enable ? "enabled" : "disabled");
+  if(cpu.cpuTrace())
+    commandResult << ", " << cpu.cpuTrace()->size() << " instructions recorded";
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "d"
 void DebuggerParser::executeD()
@@ -1583,6 +1608,19 @@ void DebuggerParser::executePrint()
   commandResult << eval();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "profile"
+void DebuggerParser::executeProfile()
+{
+  M6502& cpu = debugger.m6502();
+  bool enable = argCount == 0 ? !cpu.cpuProfileEnabled() : args[0] != 0;
+
+  cpu.enableCpuProfile(enable);
+  commandResult << "CPU profile " << (enable ? "enabled" : "disabled");
+  if(cpu.cpuProfile())
+    commandResult << ", " << cpu.cpuProfile()->cycles() << " cycles profiled";
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "ram"
 void DebuggerParser::executeRam()
@@ -1608,6 +1646,46 @@ void DebuggerParser::executeReset()
   commandResult << "reset system";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// wrapper function for reversestep/reversetrace/reversecontinue commands
+void DebuggerParser::executeReverse(int (Debugger::*reverse)(string&))
+{
+  string message;
+  int cycles = (debugger.*reverse)(message);
+
+  if(cycles > 0)
+  {
+    debugger.rom().invalidate();
+    if(!message.empty())
+      commandResult
+        << message << "stopped at $" << Base::HEX4 << debugger.cpuDebug().pc() << ", ";
+    commandResult << "went back " << dec << cycles << " cycles";
+  }
+  else
+    commandResult << red(message);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "reversecontinue"
+void DebuggerParser::executeReverseContinue()
+{
+  executeReverse(&Debugger::reverseContinue);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "reversestep"
+void DebuggerParser::executeReverseStep()
+{
+  executeReverse(&Debugger::reverseStep);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "reversetrace"
+void DebuggerParser::executeReverseTrace()
+{
+  executeReverse(&Debugger::reverseTrace);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "rewind"
 void DebuggerParser::executeRewind()
@@ -1684,33 +1762,26 @@ void DebuggerParser::executeRunTo()
   const CartDebug& cartdbg = debugger.cartDebug();
   const CartDebug::DisassemblyList& list = cartdbg.disassembly().list;
 
-  uInt32 count = 0, max_iterations = uInt32(list.size());
-
-  // Create a progress dialog box to show the progress searching through the
-  // disassembly, since this may be a time-consuming operation
-  ostringstream buf;
-  buf << "RunTo searching through " << max_iterations << " disassembled instructions";
-  ProgressDialog progress(debugger.baseDialog(), debugger.lfont(), buf.str());
-  progress.setRange(0, max_iterations, 5);
-
-  bool done = false;
-  do {
-    debugger.step();
-
-    // Update romlist to point to current PC
-    int pcline = cartdbg.addressToLine(debugger.cpuDebug().pc());
-    if(pcline >= 0)
-    {
-      const string& next = list[pcline].disasm;
-      done = (BSPF::findIgnoreCase(next, argStrings[0]) != string::npos);
-    }
-    // Update the progress bar
-    progress.setProgress(count);
-  } while(!done && ++count < max_iterations);
+  // Mark all addresses whose disassembly contains the search string, so
+  // that the CPU can check them itself
+  PackedBitArray addresses;
+  for(uInt32 addr = 0; addr <= 0xffff; ++addr)
+  {
+    int line = cartdbg.addressToLine(addr);
+    if(line >= 0 && BSPF::findIgnoreCase(list[line].disasm, argStrings[0]) != string::npos)
+      addresses.set(addr);
+  }
 
-  progress.close();
+  uInt64 count;
+  string message;
+  debugger.runUntil(&addresses, nullptr, std::max<uInt64>(list.size(), 1),
+                    "runto", count, message);
 
-  if(done)
+  if(!message.empty())
+    commandResult
+      << message << "stopped at $" << Base::HEX4 << debugger.cpuDebug().pc()
+      << " after " << dec << count << " instructions";
+  else if(addresses.isSet(debugger.cpuDebug().pc()))
     commandResult
       << "found " << argStrings[0] << " in " << dec << count
       << " disassembled instructions";
@@ -1727,17 +1798,25 @@ void DebuggerParser::executeRunToPc()
   const CartDebug& cartdbg = debugger.cartDebug();
   const CartDebug::DisassemblyList& list = cartdbg.disassembly().list;
 
-  uInt32 count = 0;
-  bool done = false;
-  do {
-    debugger.step();
+  // Mark all addresses which map to the line of the given address
+  PackedBitArray addresses;
+  for(uInt32 addr = 0; addr <= 0xffff; ++addr)
+  {
+    int line = cartdbg.addressToLine(addr);
+    if(line >= 0 && list[line].address == args[0])
+      addresses.set(addr);
+  }
 
-    // Update romlist to point to current PC
-    int pcline = cartdbg.addressToLine(debugger.cpuDebug().pc());
-    done = (pcline >= 0) && (list[pcline].address == args[0]);
-  } while(!done && ++count < list.size());
+  uInt64 count;
+  string message;
+  debugger.runUntil(&addresses, nullptr, std::max<uInt64>(list.size(), 1),
+                    "runtopc", count, message);
 
-  if(done)
+  if(!message.empty())
+    commandResult
+      << message << "stopped at $" << Base::HEX4 << debugger.cpuDebug().pc()
+      << " after " << dec << count << " instructions";
+  else if(addresses.isSet(debugger.cpuDebug().pc()))
     commandResult
       << "set PC to " << Base::HEX4 << args[0] << " in "
       << dec << count << " disassembled instructions";
@@ -1768,6 +1847,30 @@ void DebuggerParser::executeSaveconfig()
   commandResult << debugger.cartDebug().saveConfigFile();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "savecputrace"
+void DebuggerParser::executeSavecputrace()
+{
+  const CpuTrace* trace = debugger.m6502().cpuTrace();
+  if(!trace)
+  {
+    commandResult << red("CPU trace was never enabled");
+    return;
+  }
+
+  // Append 'trace' extension when necessary
+  string file = argStrings[0];
+  if(file.find_last_of('.') == string::npos)
+    file += ".trace";
+
+  FilesystemNode node(debugger.myOSystem.defaultSaveDir() + file);
+  if(trace->save(node.getPath()))
+    commandResult << "saved " << std::min(trace->size(), uInt64(CpuTrace::CAPACITY))
+                  << " instructions to " << node.getShortPath();
+  else
+    commandResult << red("unable to save CPU trace to " + node.getShortPath());
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "savedis"
 void DebuggerParser::executeSavedisassembly()
@@ -1775,6 +1878,29 @@ void DebuggerParser::executeSavedisassembly()
   commandResult << debugger.cartDebug().saveDisassembly();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "saveprofile"
+void DebuggerParser::executeSaveprofile()
+{
+  const CpuProfile* profile = debugger.m6502().cpuProfile();
+  if(!profile)
+  {
+    commandResult << red("CPU profile was never enabled");
+    return;
+  }
+
+  // Append 'txt' extension when necessary
+  string file = argStrings[0];
+  if(file.find_last_of('.') == string::npos)
+    file += ".txt";
+
+  FilesystemNode node(debugger.myOSystem.defaultSaveDir() + file);
+  if(profile->save(node.getPath()))
+    commandResult << "saved CPU profile to " << node.getShortPath();
+  else
+    commandResult << red("unable to save CPU profile to " + node.getShortPath());
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "saverom"
 void DebuggerParser::executeSaverom()
@@ -1866,12 +1992,16 @@ void DebuggerParser::executeStepwhile()
     commandResult << red("invalid expression");
     return;
   }
-  Expression* expr = YaccParser::getResult();
-  int ncycles = 0;
-  do {
-    ncycles += debugger.step();
-  } while (expr->evaluate());
-  commandResult << "executed " << ncycles << " cycles";
+  CompiledExpression expr(YaccParser::getResult());
+
+  uInt64 count;
+  string message;
+  int ncycles = debugger.runUntil(nullptr, &expr, 0, "stepwhile", count, message);
+  if(!message.empty())
+    commandResult
+      << message << "stopped at $" << Base::HEX4 << debugger.cpuDebug().pc()
+      << " after " << dec << count << " instructions, ";
+  commandResult << "executed " << dec << ncycles << " cycles";
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -2304,6 +2434,16 @@ DebuggerParser::Command DebuggerParser::commands[NumCommands] = {
     std::mem_fn(&DebuggerParser::executeClearconfig)
   },
 
+  {
+    "clearprofile",
+    "Clear all counts of the CPU profile",
+    "Example: clearprofile (no parameters)",
+    false,
+    true,
+    { Parameters::ARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executeClearprofile)
+  },
+
   {
     "clearsavestateifs",
     "Clear all savestate points",
@@ -2364,6 +2504,17 @@ DebuggerParser::Command DebuggerParser::commands[NumCommands] = {
     std::mem_fn(&DebuggerParser::executeColortest)
   },
 
+  {
+    "cputrace",
+    "Record executed instructions: on (1), off (0), or toggle (no arg)",
+    "The last 1M instructions are kept, see savecputrace\n"
+    "Example: cputrace, cputrace 1",
+    false,
+    false,
+    { Parameters::ARG_BOOL, Parameters::ARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executeCputrace)
+  },
+
   {
     "d",
     "Decimal Flag: set (0 or 1), or toggle (no arg)",
@@ -2770,6 +2921,17 @@ DebuggerParser::Command DebuggerParser::commands[NumCommands] = {
     std::mem_fn(&DebuggerParser::executePrint)
   },
 
+  {
+    "profile",
+    "Profile instructions: on (1), off (0), or toggle (no arg)",
+    "Counts executions and cycles of each instruction, see saveprofile\n"
+    "Example: profile, profile 1",
+    false,
+    true,
+    { Parameters::ARG_BOOL, Parameters::ARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executeProfile)
+  },
+
   {
     "ram",
     "Show ZP RAM, or set address xx to yy1 [yy2 ...]",
@@ -2790,6 +2952,39 @@ DebuggerParser::Command DebuggerParser::commands[NumCommands] = {
     std::mem_fn(&DebuggerParser::executeReset)
   },
 
+  {
+    "reversecontinue",
+    "Go back to the previous stop at a breakpoint/trap/condition",
+    "Searches about one second back, from the keyframes taken since the "
+    "debugger was entered\nExample: reversecontinue (no parameters)",
+    false,
+    true,
+    { Parameters::ARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executeReverseContinue)
+  },
+
+  {
+    "reversestep",
+    "Go back by one CPU instruction",
+    "Replays from the last keyframe, so it fails if the input changed\n"
+    "Example: reversestep (no parameters)",
+    false,
+    true,
+    { Parameters::ARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executeReverseStep)
+  },
+
+  {
+    "reversetrace",
+    "Go back by one CPU instruction, skipping subroutines",
+    "Coming from an RTS, goes back to the matching JSR\n"
+    "Example: reversetrace (no parameters)",
+    false,
+    true,
+    { Parameters::ARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executeReverseTrace)
+  },
+
   {
     "rewind",
     "Rewind state by one or [xx] steps/traces/scanlines/frames...",
@@ -2892,6 +3087,18 @@ DebuggerParser::Command DebuggerParser::commands[NumCommands] = {
     std::mem_fn(&DebuggerParser::executeSaveconfig)
   },
 
+  {
+    "savecputrace",
+    "Save instructions recorded by cputrace to file xx",
+    "Binary format, convert with the cputrace tool\n"
+    "Example: savecputrace frame.trace\n"
+    "NOTE: saves to default save location",
+    true,
+    false,
+    { Parameters::ARG_FILE, Parameters::ARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executeSavecputrace)
+  },
+
   {
     "savedis",
     "Save Distella disassembly (with default name)",
@@ -2903,6 +3110,18 @@ DebuggerParser::Command DebuggerParser::commands[NumCommands] = {
     std::mem_fn(&DebuggerParser::executeSavedisassembly)
   },
 
+  {
+    "saveprofile",
+    "Save report of the CPU profile to file xx",
+    "Lists hottest instructions and loops, and cycles per scanline\n"
+    "Example: saveprofile kernel.txt\n"
+    "NOTE: saves to default save location",
+    true,
+    false,
+    { Parameters::ARG_FILE, Parameters::ARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executeSaveprofile)
+  },
+
   {
     "saverom",
     "Save (possibly patched) ROM (with default name)",
@@ -88,7 +88,7 @@ class DebuggerParser
     };
 
     // List of commands available
-    static constexpr uInt32 NumCommands = 92;
+    static constexpr uInt32 NumCommands = 100;
     struct Command {
       string cmdString;
       string description;
@@ -147,12 +147,14 @@ class DebuggerParser
     void executeCheat();
     void executeClearbreaks();
     void executeClearconfig();
+    void executeClearprofile();
     void executeClearsavestateifs();
     void executeCleartraps();
     void executeClearwatches();
     void executeCls();
     void executeCode();
     void executeColortest();
+    void executeCputrace();
     void executeD();
     void executeData();
     void executeDebugColors();
@@ -193,8 +195,13 @@ class DebuggerParser
     void executePc();
     void executePGfx();
     void executePrint();
+    void executeProfile();
     void executeRam();
     void executeReset();
+    void executeReverse(int (Debugger::*reverse)(string&));
+    void executeReverseContinue();
+    void executeReverseStep();
+    void executeReverseTrace();
     void executeRewind();
     void executeRiot();
     void executeRom();
@@ -205,7 +212,9 @@ class DebuggerParser
     void executeS();
     void executeSave();
     void executeSaveconfig();
+    void executeSavecputrace();
     void executeSavedisassembly();
+    void executeSaveprofile();
     void executeSaverom();
     void executeSaveses();
     void executeSavesnap();
@@ -18,6 +18,8 @@
 #ifndef EXPRESSION_HXX
 #define EXPRESSION_HXX
 
+class CompiledExpression;
+
 #include "bspf.hxx"
 
 /**
@@ -26,6 +28,9 @@
   returns the result.  When placed in a tree, a collection of such nodes
   can represent complex expression statements.
 
+  Expressions which are evaluated repeatedly (breakif, trapif, etc.)
+  are lowered to a CompiledExpression instead of walking the tree.
+
   @author  Stephen Anthony
 */
 class Expression
@@ -37,6 +42,12 @@ class Expression
 
     virtual Int32 evaluate() const { return 0; }
 
+    /**
+      Append the code for this expression to the given program.  Nodes
+      without a specialised implementation are called through evaluate().
+    */
+    virtual void compile(CompiledExpression& program) const;
+
   protected:
     unique_ptr<Expression> myLHS, myRHS;
 
@@ -0,0 +1,72 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "Serializer.hxx"
+#include "Keyframes.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Keyframes::Keyframes()
+  : myFirst(0),
+    mySize(0)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Keyframes::~Keyframes()
+{
+  // Defined here, where Serializer is a complete type
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Serializer& Keyframes::add(uInt64 cycles)
+{
+  while(mySize > 0 && last().cycles >= cycles)
+    --mySize;
+
+  if(mySize == CAPACITY)
+  {
+    myFirst = (myFirst + 1) % CAPACITY;
+    --mySize;
+  }
+
+  Keyframe& keyframe = at(mySize++);
+  keyframe.cycles = cycles;
+  if(!keyframe.state)
+    keyframe.state = make_unique<Serializer>();
+  keyframe.state->rewind();
+
+  return *keyframe.state;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 Keyframes::find(uInt64 cycles) const
+{
+  for(Int32 index = Int32(mySize) - 1; index >= 0; --index)
+    if(at(index).cycles < cycles)
+      return index;
+
+  return -1;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Serializer& Keyframes::state(uInt32 index)
+{
+  Serializer& state = *at(index).state;
+  state.rewind();
+
+  return state;
+}
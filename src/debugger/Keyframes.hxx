@@ -0,0 +1,120 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef KEYFRAMES_HXX
+#define KEYFRAMES_HXX
+
+class Serializer;
+
+#include <array>
+
+#include "bspf.hxx"
+
+/**
+  The snapshots of the console for reverse execution in the debugger.
+  While the debugger is active, or the emulation can stop at a breakpoint,
+  trap or condition, a keyframe is taken about once per frame, and the last
+  CAPACITY keyframes are kept.  Going back in time loads the
+  latest keyframe before the target, and executes forward from there (see
+  Debugger::reverse()), so the cost of going back is bounded by the
+  interval of the keyframes.
+*/
+class Keyframes
+{
+  public:
+    // Number of keyframes kept (about one second)
+    static constexpr uInt32 CAPACITY = 60;
+
+    // Minimum number of cycles between two keyframes (one frame)
+    static constexpr uInt64 INTERVAL = 76 * 262;
+
+  public:
+    Keyframes();
+    ~Keyframes();
+
+    /**
+      Answer whether a keyframe should be taken at the given cycles; this
+      is also the case if an earlier state was loaded meanwhile.
+    */
+    bool due(uInt64 cycles) const {
+      return mySize == 0 || cycles < last().cycles ||
+             cycles - last().cycles >= INTERVAL;
+    }
+
+    /**
+      Add a keyframe at the given cycles.  The oldest keyframe is replaced
+      once all are in use, and all keyframes at or after the cycles are
+      removed, since they belong to a future which was left by loading an
+      earlier state.
+
+      @return  The serializer to save the state to
+    */
+    Serializer& add(uInt64 cycles);
+
+    /**
+      Remove the newest keyframe (e.g. because its state couldn't be saved).
+    */
+    void removeLast() { --mySize; }
+
+    /**
+      Remove all keyframes (e.g. when leaving the debugger).
+    */
+    void clear() { mySize = 0; }
+
+    /**
+      Answer the index of the latest keyframe before the given cycles, or
+      -1 if there is none.
+    */
+    Int32 find(uInt64 cycles) const;
+
+    /**
+      Answer the cycles of the keyframe with the given index (0 is the
+      oldest one).
+    */
+    uInt64 cycles(uInt32 index) const { return at(index).cycles; }
+
+    /**
+      Answer the state of the keyframe with the given index, ready to be
+      loaded.
+    */
+    Serializer& state(uInt32 index);
+
+  private:
+    struct Keyframe {
+      uInt64 cycles;
+      unique_ptr<Serializer> state;
+    };
+
+    Keyframe& at(uInt32 index) { return myKeyframes[(myFirst + index) % CAPACITY]; }
+    const Keyframe& at(uInt32 index) const { return myKeyframes[(myFirst + index) % CAPACITY]; }
+    const Keyframe& last() const { return at(mySize - 1); }
+
+  private:
+    // A ring of keyframes, the oldest one at myFirst
+    std::array<Keyframe, CAPACITY> myKeyframes;
+    uInt32 myFirst;
+    uInt32 mySize;
+
+  private:
+    // Following constructors and assignment operators not supported
+    Keyframes(const Keyframes&) = delete;
+    Keyframes(Keyframes&&) = delete;
+    Keyframes& operator=(const Keyframes&) = delete;
+    Keyframes& operator=(Keyframes&&) = delete;
+};
+
+#endif
@@ -23,28 +23,66 @@
 class TrapArray
 {
 public:
+  // Size of the blocks the traps are also counted in; matches the size
+  // of a page in the System, so that only pages with traps need checking
+  static constexpr uInt16 BLOCK_SHIFT = 6;
+  static constexpr uInt16 BLOCK_SIZE = 1 << BLOCK_SHIFT;
+
   TrapArray() : myInitialized(false) {}
 
   bool isSet(const uInt16 address) const { return myCount[address]; }
   bool isClear(const uInt16 address) const { return myCount[address] == 0; }
 
-  void add(const uInt16 address) { myCount[address]++; }
-  void remove(const uInt16 address) { myCount[address]--; }
+  // Answer whether any address in the block of the given address is set
+  bool isBlockSet(const uInt16 address) const {
+    return myInitialized && myBlockCount[address >> BLOCK_SHIFT];
+  }
+
+  void add(const uInt16 address) {
+    myCount[address]++;
+    myBlockCount[address >> BLOCK_SHIFT]++;
+  }
+  void remove(const uInt16 address) {
+    if(myCount[address])
+    {
+      myCount[address]--;
+      myBlockCount[address >> BLOCK_SHIFT]--;
+    }
+  }
   //void toggle(uInt16 address) { myCount[address] ? remove(address) : add(address); } // TODO condition
 
   void initialize() { 
     if(!myInitialized)
+    {
       memset(myCount, 0, sizeof(myCount));
+      memset(myBlockCount, 0, sizeof(myBlockCount));
+    }
     myInitialized = true; 
   }
-  void clearAll() { myInitialized = false; memset(myCount, 0, sizeof(myCount)); }
+  void clearAll() {
+    myInitialized = false;
+    memset(myCount, 0, sizeof(myCount));
+    memset(myBlockCount, 0, sizeof(myBlockCount));
+  }
 
   bool isInitialized() const { return myInitialized; }
 
+  // Answer whether any trap is set
+  bool isAnySet() const {
+    if(myInitialized)
+      for(const auto count: myBlockCount)
+        if(count)
+          return true;
+    return false;
+  }
+
 private:
   // The actual counts
   uInt8 myCount[0x10000];
 
+  // The number of traps in each block
+  uInt16 myBlockCount[0x10000 >> BLOCK_SHIFT];
+
   // Indicates whether we should treat this array as initialized
   bool myInitialized;
 
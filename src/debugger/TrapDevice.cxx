@@ -0,0 +1,62 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "System.hxx"
+#include "M6502.hxx"
+#include "TrapDevice.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 TrapDevice::peek(uInt16 address)
+{
+  const System::PageAccess& access = mySystem->getPageAccess(address);
+
+  uInt8 result = access.directPeekBase ?
+    *(access.directPeekBase + (address & System::PAGE_MASK)) :
+    access.device->peek(address);
+
+  myCPU.checkReadTrap(address);
+
+  return result;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TrapDevice::poke(uInt16 address, uInt8 value)
+{
+  const System::PageAccess& access = mySystem->getPageAccess(address);
+
+  bool changed = true;
+  if(access.directPokeBase)
+    *(access.directPokeBase + (address & System::PAGE_MASK)) = value;
+  else
+    changed = access.device->poke(address, value);
+
+  myCPU.checkWriteTrap(address);
+
+  return changed;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 TrapDevice::getAccessFlags(uInt16 address) const
+{
+  return mySystem->getPageAccess(address).device->getAccessFlags(address);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TrapDevice::setAccessFlags(uInt16 address, uInt8 flags)
+{
+  mySystem->getPageAccess(address).device->setAccessFlags(address, flags);
+}
@@ -0,0 +1,98 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef TRAP_DEVICE_HXX
+#define TRAP_DEVICE_HXX
+
+class M6502;
+
+#include "bspf.hxx"
+#include "Device.hxx"
+
+/**
+  The pages of the System containing read or write traps are redirected
+  to this device (see M6502::updateTraps()).  It forwards all accesses to
+  the device installed in the page, and lets the CPU check whether the
+  accessed address is trapped.  So the accesses to all other pages are not
+  slowed down by the traps.
+*/
+class TrapDevice : public Device
+{
+  public:
+    explicit TrapDevice(M6502& cpu) : myCPU(cpu) { }
+    virtual ~TrapDevice() = default;
+
+  public:
+    /**
+      Install device in the specified system.  The pages are redirected
+      by the CPU.
+
+      @param system The system the device should install itself in
+    */
+    void install(System& system) override { mySystem = &system; }
+
+    /**
+      Reset device to its power-on state
+    */
+    void reset() override { }
+
+    /**
+      The device has no state of its own.
+    */
+    bool save(Serializer& out) const override { return true; }
+    bool load(Serializer& in) override { return true; }
+
+  public:
+    /**
+      Get the byte at the specified address from the installed device,
+      and check for a read trap.
+
+      @return The byte at the specified address
+    */
+    uInt8 peek(uInt16 address) override;
+
+    /**
+      Change the byte at the specified address in the installed device,
+      and check for a write trap.
+
+      @param address The address where the value should be stored
+      @param value The value to be stored at the address
+
+      @return  True if the poke changed the device address space, else false
+    */
+    bool poke(uInt16 address, uInt8 value) override;
+
+    /**
+      Query and change the disassembly flags of the installed device.
+    */
+    uInt8 getAccessFlags(uInt16 address) const override;
+    void setAccessFlags(uInt16 address, uInt8 flags) override;
+
+  private:
+    // The CPU which checks the traps
+    M6502& myCPU;
+
+  private:
+    // Following constructors and assignment operators not supported
+    TrapDevice() = delete;
+    TrapDevice(const TrapDevice&) = delete;
+    TrapDevice(TrapDevice&&) = delete;
+    TrapDevice& operator=(const TrapDevice&) = delete;
+    TrapDevice& operator=(TrapDevice&&) = delete;
+};
+
+#endif
@@ -321,6 +321,7 @@ const ByteArray& Cartridge3EPlusWidget::internalRamCurrent(int start, int count)
 void Cartridge3EPlusWidget::internalRamSetValue(int addr, uInt8 value)
 {
   myCart.myRAM[addr] = value;
+  myCart.ramChanged(addr);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -212,6 +212,7 @@ const ByteArray& Cartridge3EWidget::internalRamCurrent(int start, int count)
 void Cartridge3EWidget::internalRamSetValue(int addr, uInt8 value)
 {
   myCart.myRAM[addr] = value;
+  myCart.ramChanged(addr);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -155,6 +155,7 @@ const ByteArray& CartridgeF4SCWidget::internalRamCurrent(int start, int count)
 void CartridgeF4SCWidget::internalRamSetValue(int addr, uInt8 value)
 {
   myCart.myRAM[addr] = value;
+  myCart.stateChanged();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -149,6 +149,7 @@ const ByteArray& CartridgeF6SCWidget::internalRamCurrent(int start, int count)
 void CartridgeF6SCWidget::internalRamSetValue(int addr, uInt8 value)
 {
   myCart.myRAM[addr] = value;
+  myCart.stateChanged();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -147,6 +147,7 @@ const ByteArray& CartridgeF8SCWidget::internalRamCurrent(int start, int count)
 void CartridgeF8SCWidget::internalRamSetValue(int addr, uInt8 value)
 {
   myCart.myRAM[addr] = value;
+  myCart.stateChanged();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -201,6 +201,7 @@ const ByteArray& CartridgeFA2Widget::internalRamCurrent(int start, int count)
 void CartridgeFA2Widget::internalRamSetValue(int addr, uInt8 value)
 {
   myCart.myRAM[addr] = value;
+  myCart.ramChanged(addr);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -148,6 +148,7 @@ const ByteArray& CartridgeFAWidget::internalRamCurrent(int start, int count)
 void CartridgeFAWidget::internalRamSetValue(int addr, uInt8 value)
 {
   myCart.myRAM[addr] = value;
+  myCart.ramChanged(addr);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -164,6 +164,7 @@ const ByteArray& CartridgeMNetworkWidget::internalRamCurrent(int start, int coun
 void CartridgeMNetworkWidget::internalRamSetValue(int addr, uInt8 value)
 {
   myCart.myRAM[addr] = value;
+  myCart.ramChanged(addr);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
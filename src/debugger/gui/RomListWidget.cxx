@@ -19,6 +19,7 @@
 #include "Debugger.hxx"
 #include "DiStella.hxx"
 #include "PackedBitArray.hxx"
+#include "CpuProfile.hxx"
 #include "Widget.hxx"
 #include "StellaKeys.hxx"
 #include "FBSurface.hxx"
@@ -41,7 +42,9 @@ RomListWidget::RomListWidget(GuiObject* boss, const GUI::Font& lfont,
     _currentKeyDown(KBDK_UNKNOWN),
     _base(Common::Base::F_DEFAULT),
     myDisasm(nullptr),
-    myBPState(nullptr)
+    myBPState(nullptr),
+    myProfile(nullptr),
+    myProfileBank(0)
 {
   _flags = Widget::FLAG_ENABLED | Widget::FLAG_CLEARBG | Widget::FLAG_RETAIN_FOCUS;
   _bgcolor = kWidColor;
@@ -140,6 +143,15 @@ void RomListWidget::setList(const CartDebug::Disassembly& disasm,
   recalc();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomListWidget::setProfile(const CpuProfile* profile, uInt32 bank)
+{
+  myProfile = profile && profile->cycles() ? profile : nullptr;
+  myProfileBank = bank;
+
+  setDirty();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void RomListWidget::setSelected(int item)
 {
@@ -477,11 +489,16 @@ void RomListWidget::drawWidget(bool hilite)
   s.frameRect(_x, _y, _w + 1, _h, hilite ? kWidColorHi : kColor);
   s.vLine(_x + CheckboxWidget::boxSize() + 5, _y, _y + _h - 1, kColor);
 
+  // The share of the profiled cycles is shown after the cycle count
+  const CpuProfile::Counter* profile =
+      myProfile ? myProfile->counters(myProfileBank) : nullptr;
+
   // Draw the list items
   int cycleCountW = _fontWidth * 8,
+      profileW = myProfile ? _fontWidth * 6 : 0,
       noTypeDisasmW = _w - l.x() - _labelWidth,
       noCodeDisasmW = noTypeDisasmW - r.width(),
-      codeDisasmW = noCodeDisasmW - cycleCountW,
+      codeDisasmW = noCodeDisasmW - cycleCountW - profileW,
       actualWidth = myDisasm->fieldwidth * _fontWidth;
   if(actualWidth < codeDisasmW)
     codeDisasmW = actualWidth;
@@ -532,6 +549,21 @@ void RomListWidget::drawWidget(bool hilite)
         // Draw cycle count
         s.drawString(_font, dlist[pos].ccount, xpos + _labelWidth + codeDisasmW, ypos,
                      cycleCountW, textColor);
+        // Draw share of the profiled cycles, the hotter the brighter
+        if(profile)
+        {
+          const CpuProfile::Counter& counter =
+              profile[dlist[pos].address & (CpuProfile::BANK_SIZE - 1)];
+          if(counter.count)
+          {
+            double share = counter.cycles * 100.0 / myProfile->cycles();
+            ostringstream buf;
+            buf << std::fixed << std::setprecision(share < 10 ? 1 : 0) << share << "%";
+            s.drawString(_font, buf.str(), xpos + _labelWidth + codeDisasmW + cycleCountW,
+                         ypos, profileW, share >= 10 ? kDbgColorRed :
+                         share >= 1 ? textColor : kColor, TextAlign::Right);
+          }
+        }
       }
       else
       {
@@ -22,6 +22,7 @@ class ScrollBarWidget;
 class PackedBitArray;
 class CheckListWidget;
 class RomListSettings;
+class CpuProfile;
 
 #include "Base.hxx"
 #include "CartDebug.hxx"
@@ -52,6 +53,12 @@ class RomListWidget : public EditableWidget
 
     void setList(const CartDebug::Disassembly& disasm, const PackedBitArray& state);
 
+    /**
+      Show the share of the profiled cycles of each instruction, taken from
+      the counters of the given bank, or nothing if there is no profile.
+    */
+    void setProfile(const CpuProfile* profile, uInt32 bank);
+
     int getSelected() const        { return _selectedItem; }
     int getHighlighted() const     { return _highlightedItem; }
     void setSelected(int item);
@@ -103,6 +110,8 @@ class RomListWidget : public EditableWidget
 
     const CartDebug::Disassembly* myDisasm;
     const PackedBitArray* myBPState;
+    const CpuProfile* myProfile;
+    uInt32 myProfileBank;
     vector<CheckboxWidget*> myCheckList;
 
   private:
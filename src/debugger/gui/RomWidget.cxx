@@ -20,6 +20,8 @@
 #include "CartDebug.hxx"
 #include "DiStella.hxx"
 #include "CpuDebug.hxx"
+#include "CpuProfile.hxx"
+#include "M6502.hxx"
 #include "GuiObject.hxx"
 #include "Font.hxx"
 #include "DataGridWidget.hxx"
@@ -76,6 +78,12 @@ void RomWidget::loadConfig()
     myListIsDirty = false;
   }
 
+  // Show the profile of the disassembled bank (see CartDebug::disassemble)
+  const CpuProfile* profile = dbg.m6502().cpuProfile();
+  if(profile)
+    myRomList->setProfile(profile, (dbg.cpuDebug().pc() & 0x1000) ?
+                          cart.getBank() : profile->ramBank());
+
   // Update romlist to point to current PC (if it has changed)
   int pcline = cart.addressToLine(dbg.cpuDebug().pc());
   if(pcline >= 0 && pcline != myRomList->getHighlighted())
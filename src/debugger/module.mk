@@ -5,6 +5,11 @@ MODULE_OBJS := \
 	src/debugger/DebuggerParser.o \
 	src/debugger/CartDebug.o \
 	src/debugger/CpuDebug.o \
+	src/debugger/CpuTrace.o \
+	src/debugger/CpuProfile.o \
+	src/debugger/Keyframes.o \
+	src/debugger/TrapDevice.o \
+	src/debugger/CompiledExpression.o \
 	src/debugger/DiStella.o \
 	src/debugger/RiotDebug.o \
 	src/debugger/TIADebug.o
@@ -31,7 +31,15 @@ Cartridge::Cartridge(const Settings& settings, const string& md5)
     myBankChanged(true),
     myCodeAccessBase(nullptr),
     myStartBank(0),
-    myBankLocked(false)
+    myBankLocked(false),
+    myStateTracked(false),
+    myStateGeneration(nextStateGeneration()),
+    myStateGenerationUsed(false),
+    myTrackedRAM(nullptr),
+    myTrackedRAMSize(0),
+    myRAMDirty(false),
+    myRAMSaveOffset(0),
+    myRAMEncodingOffset(0)
 {
   auto to_uInt32 = [](const string& s, uInt32 pos) {
     return uInt32(std::stoul(s.substr(pos, 8), nullptr, 16));
@@ -93,10 +101,14 @@ uInt8 Cartridge::peekRAM(uInt8& dest, uInt16 address)
     // Record access here; final determination will happen in ::pokeRAM()
     myRAMAccesses.push_back(address);
     dest = value;
+    ramWritten(dest);
   }
 #else
   if(!mySystem->autodetectMode())
+  {
     dest = value;
+    ramWritten(dest);
+  }
 #endif
   return value;
 }
@@ -115,6 +127,63 @@ void Cartridge::pokeRAM(uInt8& dest, uInt16 address, uInt8 value)
   }
 #endif
   dest = value;
+  ramWritten(dest);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 Cartridge::stateGeneration() const
+{
+  if(!myStateTracked)
+    return 0;
+
+  myStateGenerationUsed = true;
+  return myStateGeneration;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge::trackRAM(uInt8* ram, uInt32 size)
+{
+  trackState();
+
+  myTrackedRAM = ram;
+  myTrackedRAMSize = size;
+  myDirtyRAMPages.assign((size + RAM_PAGE_SIZE - 1) >> RAM_PAGE_SHIFT, false);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge::saveRAM(Serializer& out) const
+{
+  myRAMSaveOffset = out.size();
+  out.putByteArray(myTrackedRAM, myTrackedRAMSize);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge::encodingSaved() const
+{
+  // The encoding contains the current RAM
+  myRAMEncodingOffset = myRAMSaveOffset;
+  std::fill(myDirtyRAMPages.begin(), myDirtyRAMPages.end(), false);
+  myRAMDirty = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge::updateEncoding(uInt8* encoding, size_t size) const
+{
+  if(!myRAMDirty || myRAMEncodingOffset + myTrackedRAMSize > size)
+    return;
+
+  uInt8* ram = encoding + myRAMEncodingOffset;
+  for(uInt32 page = 0; page < myDirtyRAMPages.size(); ++page)
+  {
+    if(myDirtyRAMPages[page])
+    {
+      const uInt32 offset = page << RAM_PAGE_SHIFT;
+      memcpy(ram + offset, myTrackedRAM + offset,
+             std::min(RAM_PAGE_SIZE, myTrackedRAMSize - offset));
+      myDirtyRAMPages[page] = false;
+    }
+  }
+  myRAMDirty = false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -128,6 +197,23 @@ void Cartridge::createCodeAccessBase(uInt32 size)
 #endif
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt16 Cartridge::defineSegment(uInt16 size, uInt16 numBanks,
+                                const PageAccessFunc& pageAccess)
+{
+  Segment segment;
+  segment.numPages = size >> System::PAGE_SHIFT;
+  segment.pages.reserve(segment.numPages * numBanks);
+
+  for(uInt16 bank = 0; bank < numBanks; ++bank)
+    for(uInt16 offset = 0; offset < size; offset += System::PAGE_SIZE)
+      segment.pages.push_back(pageAccess(bank, offset));
+
+  mySegments.push_back(std::move(segment));
+
+  return uInt16(mySegments.size() - 1);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Cartridge::initializeRAM(uInt8* arr, uInt32 size, uInt8 val) const
 {
@@ -27,6 +27,7 @@ class GuiObject;
 #include "bspf.hxx"
 #include "Device.hxx"
 #include "Settings.hxx"
+#include "System.hxx"
 #ifdef DEBUGGER_SUPPORT
   #include "Font.hxx"
 #endif
@@ -43,6 +44,7 @@ class Cartridge : public Device
 {
   public:
     using StartBankFromPropsFunc = std::function<int()>;
+    using PageAccessFunc = std::function<System::PageAccess(uInt16 bank, uInt16 offset)>;
 
   public:
     /**
@@ -106,6 +108,20 @@ class Cartridge : public Device
     */
     virtual bool bankChanged();
 
+    /**
+      Answer the state generation (see Serializable).  This is only
+      supported by carts which track their state changes (see trackState()),
+      all others answer 0.
+    */
+    uInt64 stateGeneration() const override;
+
+    /**
+      Keep track of the encoding used for reuse, and copy the pages of the
+      tracked RAM written since into it (see trackRAM()).
+    */
+    void encodingSaved() const override;
+    void updateEncoding(uInt8* encoding, size_t size) const override;
+
   #ifdef DEBUGGER_SUPPORT
     /**
       To be called at the start of each instruction.
@@ -259,6 +275,36 @@ class Cartridge : public Device
     */
     void createCodeAccessBase(uInt32 size);
 
+    /**
+      Define a segment, i.e. a part of the cartridge address space which
+      is switched between banks as a whole, and precompute its page access
+      methods for all banks.  Switching the bank of the segment is then a
+      mere block copy into the page table (see mapSegment()).  Segments of
+      the same kind (e.g. several 1K slices) can share one definition.
+
+      Note that the page access methods must not depend on anything but
+      the bank (e.g. the ROM image and RAM arrays must not be reallocated).
+
+      @param size        The size of the segment (a multiple of System::PAGE_SIZE)
+      @param numBanks    The number of banks which can be mapped into it
+      @param pageAccess  Creates the page access method for the page at the
+                         given offset into the given bank
+      @return  The index of the segment, in order of definition
+    */
+    uInt16 defineSegment(uInt16 size, uInt16 numBanks, const PageAccessFunc& pageAccess);
+
+    /**
+      Install the precomputed page access methods of a bank of a segment.
+
+      @param segment  The index of the segment (see defineSegment())
+      @param bank     The bank to install
+      @param addr     The first address of the segment in the system
+    */
+    void mapSegment(uInt16 segment, uInt16 bank, uInt16 addr) {
+      const Segment& s = mySegments[segment];
+      mySystem->setPageAccess(addr, &s.pages[bank * s.numPages], s.numPages);
+    }
+
     /**
       Fill the given RAM array with (possibly random) data.
 
@@ -297,7 +343,71 @@ class Cartridge : public Device
     */
     bool randomStartBank() const;
 
+    /**
+      Enable tracking of state changes (see stateGeneration()).  This is
+      only possible for carts whose state consists of the current bank and
+      their RAM.  Such carts must call stateChanged() whenever the bank
+      changes, and whenever they modify their RAM other than through
+      peekRAM()/pokeRAM() (as do the patch command and the debugger).
+    */
+    void trackState() { myStateTracked = true; }
+
+    /**
+      Enable tracking of state changes, and in addition track the changes
+      of the given RAM per page of RAM_PAGE_SIZE bytes.  Writing to the RAM
+      then keeps the state generation, and only the pages written are
+      copied into the kept encoding of the state (see updateEncoding()).
+      save() must write the RAM with saveRAM().  Writes through
+      peekRAM()/pokeRAM() are tracked automatically, others must be
+      reported with ramChanged() (or stateChanged()).
+    */
+    void trackRAM(uInt8* ram, uInt32 size);
+
+    /**
+      Write the RAM given to trackRAM(), remembering where it is placed.
+    */
+    void saveRAM(Serializer& out) const;
+
+    /**
+      Notify a write to the RAM given to trackRAM().
+
+      @param offset  The offset of the byte written in the RAM
+    */
+    void ramChanged(uInt32 offset) {
+      myDirtyRAMPages[offset >> RAM_PAGE_SHIFT] = true;
+      myRAMDirty = true;
+    }
+
+    /**
+      Notify a change of the tracked state.
+    */
+    void stateChanged() {
+      // A new generation is only needed once the current one has been handed out
+      if(myStateGenerationUsed)
+      {
+        myStateGeneration = nextStateGeneration();
+        myStateGenerationUsed = false;
+      }
+    }
+
+  private:
+    /**
+      Notify a write to the given cart RAM location, which is tracked per
+      page if it belongs to the RAM given to trackRAM().
+    */
+    void ramWritten(const uInt8& dest) {
+      if(myTrackedRAMSize && &dest >= myTrackedRAM &&
+         &dest < myTrackedRAM + myTrackedRAMSize)
+        ramChanged(uInt32(&dest - myTrackedRAM));
+      else
+        stateChanged();
+    }
+
   protected:
+    // Size of the pages in which the writes to cart RAM are tracked
+    static constexpr uInt32 RAM_PAGE_SHIFT = 6;
+    static constexpr uInt32 RAM_PAGE_SIZE = 1 << RAM_PAGE_SHIFT;
+
     // Settings class for the application
     const Settings& mySettings;
 
@@ -328,6 +438,29 @@ class Cartridge : public Device
     // Used when we want the 'Cartridge.StartBank' ROM property
     StartBankFromPropsFunc myStartBankFromPropsFunc;
 
+    // The precomputed page access methods of all banks of a segment
+    // (see defineSegment())
+    struct Segment {
+      uInt16 numPages;
+      vector<System::PageAccess> pages;
+    };
+    vector<Segment> mySegments;
+
+    // State change tracking (see trackState())
+    bool myStateTracked;
+    mutable uInt64 myStateGeneration;
+    mutable bool myStateGenerationUsed;
+
+    // The RAM tracked per page (see trackRAM()), the pages written since
+    // the kept encoding was saved, and the offset of the RAM in the last
+    // encoding saved and in the kept one
+    uInt8* myTrackedRAM;
+    uInt32 myTrackedRAMSize;
+    mutable BoolArray myDirtyRAMPages;
+    mutable bool myRAMDirty;
+    mutable size_t myRAMSaveOffset;
+    mutable size_t myRAMEncodingOffset;
+
     // Contains
     ShortArray myRAMAccesses;
 
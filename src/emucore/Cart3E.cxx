@@ -32,12 +32,38 @@ Cartridge3E::Cartridge3E(const ByteBuffer& image, uInt32 size,
   // Copy the ROM image into my buffer
   memcpy(myImage.get(), image.get(), mySize);
   createCodeAccessBase(mySize + 32768);
+  trackRAM(myRAM, 32768);
+
+  // Precompute the page access methods of each ROM slice
+  defineSegment(0x0800, uInt16(mySize >> 11), [this](uInt16 slice, uInt16 offset) {
+    System::PageAccess access(this, System::PageAccessType::READ);
+
+    access.directPeekBase = &myImage[(uInt32(slice) << 11) + offset];
+    access.codeAccessBase = &myCodeAccessBase[(uInt32(slice) << 11) + offset];
+    return access;
+  });
+
+  // Precompute the page access methods of each RAM slice (read port, then
+  // write port)
+  defineSegment(0x0800, 32, [this](uInt16 slice, uInt16 offset) {
+    System::PageAccess access(this, System::PageAccessType::READ);
+
+    // Map write-port RAM access to this class, since we need to inspect all
+    // accesses to check if RWP happens
+    if(offset < 0x0400)
+      access.directPeekBase = &myRAM[(slice << 10) + offset];
+    else
+      access.type = System::PageAccessType::WRITE;
+    access.codeAccessBase = &myCodeAccessBase[mySize + (slice << 10) + (offset & 0x03FF)];
+    return access;
+  });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Cartridge3E::reset()
 {
   initializeRAM(myRAM, 32768);
+  stateChanged();
   initializeStartBank(0);
 
   // We'll map the startup bank into the first segment upon reset
@@ -137,18 +163,8 @@ bool Cartridge3E::bank(uInt16 bank)
       myCurrentBank = bank % (mySize >> 11);
     }
 
-    uInt32 offset = myCurrentBank << 11;
-
-    // Setup the page access methods for the current bank
-    System::PageAccess access(this, System::PageAccessType::READ);
-
     // Map ROM image into the system
-    for(uInt16 addr = 0x1000; addr < 0x1800; addr += System::PAGE_SIZE)
-    {
-      access.directPeekBase = &myImage[offset + (addr & 0x07FF)];
-      access.codeAccessBase = &myCodeAccessBase[offset + (addr & 0x07FF)];
-      mySystem->setPageAccess(addr, access);
-    }
+    mapSegment(0, myCurrentBank, 0x1000);
   }
   else
   {
@@ -156,31 +172,11 @@ bool Cartridge3E::bank(uInt16 bank)
     bank %= 32;
     myCurrentBank = bank + 256;
 
-    uInt32 offset = bank << 10;
-
-    // Setup the page access methods for the current bank
-    System::PageAccess access(this, System::PageAccessType::READ);
-
-    // Map read-port RAM image into the system
-    for(uInt16 addr = 0x1000; addr < 0x1400; addr += System::PAGE_SIZE)
-    {
-      access.directPeekBase = &myRAM[offset + (addr & 0x03FF)];
-      access.codeAccessBase = &myCodeAccessBase[mySize + offset + (addr & 0x03FF)];
-      mySystem->setPageAccess(addr, access);
-    }
-
-    access.directPeekBase = nullptr;
-    access.type = System::PageAccessType::WRITE;
-
-    // Map write-port RAM image into the system
-    // Map access to this class, since we need to inspect all accesses to
-    // check if RWP happens
-    for(uInt16 addr = 0x1400; addr < 0x1800; addr += System::PAGE_SIZE)
-    {
-      access.codeAccessBase = &myCodeAccessBase[mySize + offset + (addr & 0x03FF)];
-      mySystem->setPageAccess(addr, access);
-    }
+    // Map read-port and write-port RAM image into the system
+    mapSegment(1, bank, 0x1000);
   }
+  stateChanged();
+
   return myBankChanged = true;
 }
 
@@ -211,7 +207,10 @@ bool Cartridge3E::patch(uInt16 address, uInt8 value)
     if(myCurrentBank < 256)
       myImage[(address & 0x07FF) + (myCurrentBank << 11)] = value;
     else
+    {
       myRAM[(address & 0x03FF) + ((myCurrentBank - 256) << 10)] = value;
+      ramChanged((address & 0x03FF) + ((myCurrentBank - 256) << 10));
+    }
   }
   else
     myImage[(address & 0x07FF) + mySize - 2048] = value;
@@ -232,7 +231,7 @@ bool Cartridge3E::save(Serializer& out) const
   try
   {
     out.putShort(myCurrentBank);
-    out.putByteArray(myRAM, 32768);
+    saveRAM(out);
   }
   catch(...)
   {
@@ -257,6 +256,8 @@ bool Cartridge3E::load(Serializer& in)
     return false;
   }
 
+  stateChanged();
+
   // Now, go to the current bank
   bank(myCurrentBank);
 
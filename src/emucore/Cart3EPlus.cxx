@@ -31,12 +31,14 @@ Cartridge3EPlus::Cartridge3EPlus(const ByteBuffer& image, uInt32 size,
   // Copy the ROM image into my buffer
   memcpy(myImage.get(), image.get(), mySize);
   createCodeAccessBase(mySize + RAM_TOTAL_SIZE);
+  trackRAM(myRAM, RAM_TOTAL_SIZE);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Cartridge3EPlus::reset()
 {
   initializeRAM(myRAM, RAM_TOTAL_SIZE);
+  stateChanged();
 
   // Remember startup bank (0 per spec, rather than last per 3E scheme).
   // Set this to go to 3rd 1K Bank.
@@ -179,6 +181,7 @@ void Cartridge3EPlus::bankRAMSlot(uInt16 bank)
     bankInUse[bankNumber * 2] = Int16(bank);
     access.type = System::PageAccessType::READ;
   }
+  stateChanged();
 
   uInt16 start = 0x1000 + (bankNumber << (RAM_BANK_TO_POWER+1)) + (upper ? RAM_WRITE_OFFSET : 0);
   uInt16 end = start + RAM_BANK_SIZE - 1;
@@ -218,6 +221,7 @@ void Cartridge3EPlus::bankROMSlot(uInt16 bank)
   bool upper = bank & BITMASK_LOWERUPPER;         // is this the lower or upper 512b
 
   bankInUse[bankNumber * 2 + (upper ? 1 : 0)] = Int16(bank); // Record which bank switched in (as ROM)
+  stateChanged();
 
   uInt32 startCurrentBank = currentBank << ROM_BANK_TO_POWER;     // Effectively *1K
 
@@ -307,7 +311,7 @@ bool Cartridge3EPlus::save(Serializer& out) const
   try
   {
     out.putShortArray(bankInUse, 8);
-    out.putByteArray(myRAM, RAM_TOTAL_SIZE);
+    saveRAM(out);
   }
   catch (...)
   {
@@ -331,6 +335,7 @@ bool Cartridge3EPlus::load(Serializer& in)
     return false;
   }
 
+  stateChanged();
   initializeBankState();
   return true;
 }
@@ -32,6 +32,15 @@ Cartridge3F::Cartridge3F(const ByteBuffer& image, uInt32 size,
   // Copy the ROM image into my buffer
   memcpy(myImage.get(), image.get(), mySize);
   createCodeAccessBase(mySize);
+
+  // Precompute the page access methods of each ROM slice
+  defineSegment(0x0800, uInt16(mySize >> 11), [this](uInt16 slice, uInt16 offset) {
+    System::PageAccess access(this, System::PageAccessType::READ);
+
+    access.directPeekBase = &myImage[(uInt32(slice) << 11) + offset];
+    access.codeAccessBase = &myCodeAccessBase[(uInt32(slice) << 11) + offset];
+    return access;
+  });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -109,18 +118,9 @@ bool Cartridge3F::bank(uInt16 bank)
     myCurrentBank = bank % (mySize >> 11);
   }
 
-  uInt32 offset = myCurrentBank << 11;
-
-  // Setup the page access methods for the current bank
-  System::PageAccess access(this, System::PageAccessType::READ);
-
   // Map ROM image into the system
-  for(uInt16 addr = 0x1000; addr < 0x1800; addr += System::PAGE_SIZE)
-  {
-    access.directPeekBase = &myImage[offset + (addr & 0x07FF)];
-    access.codeAccessBase = &myCodeAccessBase[offset + (addr & 0x07FF)];
-    mySystem->setPageAccess(addr, access);
-  }
+  mapSegment(0, myCurrentBank, 0x1000);
+
   return myBankChanged = true;
 }
 
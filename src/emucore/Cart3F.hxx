@@ -38,7 +38,7 @@ class System;
 
   @author  Bradford W. Mott
 */
-class Cartridge3F : public Cartridge
+class Cartridge3F final : public Cartridge
 {
   friend class Cartridge3FWidget;
 
@@ -26,6 +26,16 @@ CartridgeE0::CartridgeE0(const ByteBuffer& image, uInt32 size,
   // Copy the ROM image into my buffer
   memcpy(myImage, image.get(), std::min(8192u, size));
   createCodeAccessBase(8192);
+
+  // Precompute the page access methods of each slice, for all three
+  // switchable segments
+  defineSegment(0x0400, 8, [this](uInt16 slice, uInt16 offset) {
+    System::PageAccess access(this, System::PageAccessType::READ);
+
+    access.directPeekBase = &myImage[(slice << 10) + offset];
+    access.codeAccessBase = &myCodeAccessBase[(slice << 10) + offset];
+    return access;
+  });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -124,17 +134,9 @@ void CartridgeE0::segmentZero(uInt16 slice)
 
   // Remember the new slice
   myCurrentSlice[0] = slice;
-  uInt16 offset = slice << 10;
 
   // Setup the page access methods for the current bank
-  System::PageAccess access(this, System::PageAccessType::READ);
-
-  for(uInt16 addr = 0x1000; addr < 0x1400; addr += System::PAGE_SIZE)
-  {
-    access.directPeekBase = &myImage[offset + (addr & 0x03FF)];
-    access.codeAccessBase = &myCodeAccessBase[offset + (addr & 0x03FF)];
-    mySystem->setPageAccess(addr, access);
-  }
+  mapSegment(0, slice, 0x1000);
   myBankChanged = true;
 }
 
@@ -145,17 +147,9 @@ void CartridgeE0::segmentOne(uInt16 slice)
 
   // Remember the new slice
   myCurrentSlice[1] = slice;
-  uInt16 offset = slice << 10;
 
   // Setup the page access methods for the current bank
-  System::PageAccess access(this, System::PageAccessType::READ);
-
-  for(uInt16 addr = 0x1400; addr < 0x1800; addr += System::PAGE_SIZE)
-  {
-    access.directPeekBase = &myImage[offset + (addr & 0x03FF)];
-    access.codeAccessBase = &myCodeAccessBase[offset + (addr & 0x03FF)];
-    mySystem->setPageAccess(addr, access);
-  }
+  mapSegment(0, slice, 0x1400);
   myBankChanged = true;
 }
 
@@ -166,17 +160,9 @@ void CartridgeE0::segmentTwo(uInt16 slice)
 
   // Remember the new slice
   myCurrentSlice[2] = slice;
-  uInt16 offset = slice << 10;
 
   // Setup the page access methods for the current bank
-  System::PageAccess access(this, System::PageAccessType::READ);
-
-  for(uInt16 addr = 0x1800; addr < 0x1C00; addr += System::PAGE_SIZE)
-  {
-    access.directPeekBase = &myImage[offset + (addr & 0x03FF)];
-    access.codeAccessBase = &myCodeAccessBase[offset + (addr & 0x03FF)];
-    mySystem->setPageAccess(addr, access);
-  }
+  mapSegment(0, slice, 0x1800);
   myBankChanged = true;
 }
 
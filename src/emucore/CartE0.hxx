@@ -41,7 +41,7 @@ class System;
 
   @author  Bradford W. Mott
 */
-class CartridgeE0 : public Cartridge
+class CartridgeE0 final : public Cartridge
 {
   friend class CartridgeE0Widget;
 
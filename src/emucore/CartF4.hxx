@@ -32,7 +32,7 @@ class System;
 
   @author  Bradford W. Mott
 */
-class CartridgeF4 : public Cartridge
+class CartridgeF4 final : public Cartridge
 {
   friend class CartridgeF4Widget;
 
@@ -27,6 +27,18 @@ CartridgeF6::CartridgeF6(const ByteBuffer& image, uInt32 size,
   // Copy the ROM image into my buffer
   memcpy(myImage, image.get(), std::min(16384u, size));
   createCodeAccessBase(16384);
+  trackState();
+
+  // Precompute the page access methods of each bank; the pages with the
+  // hot spots are handled by peek()
+  defineSegment(0x1000, 4, [this](uInt16 bank, uInt16 offset) {
+    System::PageAccess access(this, System::PageAccessType::READ);
+
+    if(offset < (0x0FF6 & ~System::PAGE_MASK))
+      access.directPeekBase = &myImage[(bank << 12) + offset];
+    access.codeAccessBase = &myCodeAccessBase[(bank << 12) + offset];
+    return access;
+  });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -123,24 +135,10 @@ bool CartridgeF6::bank(uInt16 bank)
   // Remember what bank we're in
   myBankOffset = bank << 12;
 
-  System::PageAccess access(this, System::PageAccessType::READ);
+  // Install the precomputed pages of the bank, including the hot spots
+  mapSegment(0, bank, 0x1000);
+  stateChanged();
 
-  // Set the page accessing methods for the hot spots
-  for(uInt16 addr = (0x1FF6 & ~System::PAGE_MASK); addr < 0x2000;
-      addr += System::PAGE_SIZE)
-  {
-    access.codeAccessBase = &myCodeAccessBase[myBankOffset + (addr & 0x0FFF)];
-    mySystem->setPageAccess(addr, access);
-  }
-
-  // Setup the page access methods for the current bank
-  for(uInt16 addr = 0x1000; addr < (0x1FF6U & ~System::PAGE_MASK);
-      addr += System::PAGE_SIZE)
-  {
-    access.directPeekBase = &myImage[myBankOffset + (addr & 0x0FFF)];
-    access.codeAccessBase = &myCodeAccessBase[myBankOffset + (addr & 0x0FFF)];
-    mySystem->setPageAccess(addr, access);
-  }
   return myBankChanged = true;
 }
 
@@ -199,6 +197,8 @@ bool CartridgeF6::load(Serializer& in)
     return false;
   }
 
+  stateChanged();
+
   // Remember what bank we were in
   bank(myBankOffset >> 12);
 
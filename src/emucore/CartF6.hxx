@@ -32,7 +32,7 @@ class System;
 
   @author  Bradford W. Mott
 */
-class CartridgeF6 : public Cartridge
+class CartridgeF6 final : public Cartridge
 {
   friend class CartridgeF6Widget;
 
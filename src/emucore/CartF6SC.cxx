@@ -27,12 +27,26 @@ CartridgeF6SC::CartridgeF6SC(const ByteBuffer& image, uInt32 size,
   // Copy the ROM image into my buffer
   memcpy(myImage, image.get(), std::min(16384u, size));
   createCodeAccessBase(16384);
+  trackRAM(myRAM, 128);
+
+  // Precompute the page access methods of each bank (the first 256 bytes
+  // belong to the RAM); the pages with the hot spots are handled by peek()
+  defineSegment(0x0F00, 4, [this](uInt16 bank, uInt16 offset) {
+    const uInt16 addr = 0x0100 + offset;
+    System::PageAccess access(this, System::PageAccessType::READ);
+
+    if(addr < (0x0FF6 & ~System::PAGE_MASK))
+      access.directPeekBase = &myImage[(bank << 12) + addr];
+    access.codeAccessBase = &myCodeAccessBase[(bank << 12) + addr];
+    return access;
+  });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeF6SC::reset()
 {
   initializeRAM(myRAM, 128);
+  stateChanged();
   initializeStartBank(0);
 
   // Upon reset we switch to the startup bank
@@ -150,24 +164,10 @@ bool CartridgeF6SC::bank(uInt16 bank)
   // Remember what bank we're in
   myBankOffset = bank << 12;
 
-  System::PageAccess access(this, System::PageAccessType::READ);
-
-  // Set the page accessing methods for the hot spots
-  for(uInt16 addr = (0x1FF6 & ~System::PAGE_MASK); addr < 0x2000;
-      addr += System::PAGE_SIZE)
-  {
-    access.codeAccessBase = &myCodeAccessBase[myBankOffset + (addr & 0x0FFF)];
-    mySystem->setPageAccess(addr, access);
-  }
+  // Install the precomputed pages of the bank, including the hot spots
+  mapSegment(0, bank, 0x1100);
+  stateChanged();
 
-  // Setup the page access methods for the current bank
-  for(uInt16 addr = 0x1100; addr < (0x1FF6U & ~System::PAGE_MASK);
-      addr += System::PAGE_SIZE)
-  {
-    access.directPeekBase = &myImage[myBankOffset + (addr & 0x0FFF)];
-    access.codeAccessBase = &myCodeAccessBase[myBankOffset + (addr & 0x0FFF)];
-    mySystem->setPageAccess(addr, access);
-  }
   return myBankChanged = true;
 }
 
@@ -194,6 +194,7 @@ bool CartridgeF6SC::patch(uInt16 address, uInt8 value)
     // However, the patch command is special in that ignores such
     // cart restrictions
     myRAM[address & 0x007F] = value;
+    stateChanged();
   }
   else
     myImage[myBankOffset + address] = value;
@@ -214,7 +215,7 @@ bool CartridgeF6SC::save(Serializer& out) const
   try
   {
     out.putShort(myBankOffset);
-    out.putByteArray(myRAM, 128);
+    saveRAM(out);
   }
   catch(...)
   {
@@ -239,6 +240,8 @@ bool CartridgeF6SC::load(Serializer& in)
     return false;
   }
 
+  stateChanged();
+
   // Remember what bank we were in
   bank(myBankOffset >> 12);
 
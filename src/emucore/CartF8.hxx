@@ -32,7 +32,7 @@ class System;
 
   @author  Bradford W. Mott
 */
-class CartridgeF8 : public Cartridge
+class CartridgeF8 final : public Cartridge
 {
   friend class CartridgeF8Widget;
 
@@ -27,12 +27,26 @@ CartridgeF8SC::CartridgeF8SC(const ByteBuffer& image, uInt32 size,
   // Copy the ROM image into my buffer
   memcpy(myImage, image.get(), std::min(8192u, size));
   createCodeAccessBase(8192);
+  trackRAM(myRAM, 128);
+
+  // Precompute the page access methods of each bank (the first 256 bytes
+  // belong to the RAM); the pages with the hot spots are handled by peek()
+  defineSegment(0x0F00, 2, [this](uInt16 bank, uInt16 offset) {
+    const uInt16 addr = 0x0100 + offset;
+    System::PageAccess access(this, System::PageAccessType::READ);
+
+    if(addr < (0x0FF8 & ~System::PAGE_MASK))
+      access.directPeekBase = &myImage[(bank << 12) + addr];
+    access.codeAccessBase = &myCodeAccessBase[(bank << 12) + addr];
+    return access;
+  });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeF8SC::reset()
 {
   initializeRAM(myRAM, 128);
+  stateChanged();
   initializeStartBank(1);
 
   // Upon reset we switch to the startup bank
@@ -130,24 +144,10 @@ bool CartridgeF8SC::bank(uInt16 bank)
   // Remember what bank we're in
   myBankOffset = bank << 12;
 
-  System::PageAccess access(this, System::PageAccessType::READ);
-
-  // Set the page accessing methods for the hot spots
-  for(uInt16 addr = (0x1FF8 & ~System::PAGE_MASK); addr < 0x2000;
-      addr += System::PAGE_SIZE)
-  {
-    access.codeAccessBase = &myCodeAccessBase[myBankOffset + (addr & 0x0FFF)];
-    mySystem->setPageAccess(addr, access);
-  }
+  // Install the precomputed pages of the bank, including the hot spots
+  mapSegment(0, bank, 0x1100);
+  stateChanged();
 
-  // Setup the page access methods for the current bank
-  for(uInt16 addr = 0x1100; addr < (0x1FF8U & ~System::PAGE_MASK);
-      addr += System::PAGE_SIZE)
-  {
-    access.directPeekBase = &myImage[myBankOffset + (addr & 0x0FFF)];
-    access.codeAccessBase = &myCodeAccessBase[myBankOffset + (addr & 0x0FFF)];
-    mySystem->setPageAccess(addr, access);
-  }
   return myBankChanged = true;
 }
 
@@ -174,6 +174,7 @@ bool CartridgeF8SC::patch(uInt16 address, uInt8 value)
     // However, the patch command is special in that ignores such
     // cart restrictions
     myRAM[address & 0x007F] = value;
+    stateChanged();
   }
   else
     myImage[myBankOffset + address] = value;
@@ -194,7 +195,7 @@ bool CartridgeF8SC::save(Serializer& out) const
   try
   {
     out.putShort(myBankOffset);
-    out.putByteArray(myRAM, 128);
+    saveRAM(out);
   }
   catch(...)
   {
@@ -219,6 +220,8 @@ bool CartridgeF8SC::load(Serializer& in)
     return false;
   }
 
+  stateChanged();
+
   // Remember what bank we were in
   bank(myBankOffset >> 12);
 
@@ -27,12 +27,14 @@ CartridgeFA::CartridgeFA(const ByteBuffer& image, uInt32 size,
   // Copy the ROM image into my buffer
   memcpy(myImage, image.get(), std::min(12288u, size));
   createCodeAccessBase(12288);
+  trackRAM(myRAM, 256);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeFA::reset()
 {
   initializeRAM(myRAM, 256);
+  stateChanged();
   initializeStartBank(2);
 
   // Upon reset we switch to the startup bank
@@ -158,6 +160,8 @@ bool CartridgeFA::bank(uInt16 bank)
     access.codeAccessBase = &myCodeAccessBase[myBankOffset + (addr & 0x0FFF)];
     mySystem->setPageAccess(addr, access);
   }
+  stateChanged();
+
   return myBankChanged = true;
 }
 
@@ -184,6 +188,7 @@ bool CartridgeFA::patch(uInt16 address, uInt8 value)
     // However, the patch command is special in that ignores such
     // cart restrictions
     myRAM[address & 0x00FF] = value;
+    ramChanged(address & 0x00FF);
   }
   else
     myImage[myBankOffset + address] = value;
@@ -204,7 +209,7 @@ bool CartridgeFA::save(Serializer& out) const
   try
   {
     out.putShort(myBankOffset);
-    out.putByteArray(myRAM, 256);
+    saveRAM(out);
   }
   catch(...)
   {
@@ -229,6 +234,8 @@ bool CartridgeFA::load(Serializer& in)
     return false;
   }
 
+  stateChanged();
+
   // Remember what bank we were in
   bank(myBankOffset >> 12);
 
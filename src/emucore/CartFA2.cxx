@@ -39,12 +39,14 @@ CartridgeFA2::CartridgeFA2(const ByteBuffer& image, uInt32 size,
   // Copy the ROM image into my buffer
   memcpy(myImage, img_ptr, mySize);
   createCodeAccessBase(mySize);
+  trackRAM(myRAM, 256);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeFA2::reset()
 {
   initializeRAM(myRAM, 256);
+  stateChanged();
   initializeStartBank(0);
 
   // Upon reset we switch to the startup bank
@@ -225,6 +227,8 @@ bool CartridgeFA2::bank(uInt16 bank)
     access.codeAccessBase = &myCodeAccessBase[myBankOffset + (addr & 0x0FFF)];
     mySystem->setPageAccess(addr, access);
   }
+  stateChanged();
+
   return myBankChanged = true;
 }
 
@@ -251,6 +255,7 @@ bool CartridgeFA2::patch(uInt16 address, uInt8 value)
     // However, the patch command is special in that ignores such
     // cart restrictions
     myRAM[address & 0x00FF] = value;
+    ramChanged(address & 0x00FF);
   }
   else
     myImage[myBankOffset + address] = value;
@@ -271,7 +276,7 @@ bool CartridgeFA2::save(Serializer& out) const
   try
   {
     out.putShort(myBankOffset);
-    out.putByteArray(myRAM, 256);
+    saveRAM(out);
   }
   catch(...)
   {
@@ -296,6 +301,8 @@ bool CartridgeFA2::load(Serializer& in)
     return false;
   }
 
+  stateChanged();
+
   // Remember what bank we were in
   bank(myBankOffset >> 12);
 
@@ -350,6 +357,7 @@ uInt8 CartridgeFA2::ramReadWrite()
         {
           memset(myRAM, 0, 256);
         }
+        stateChanged();
         myRamAccessTimeout += 500;  // Add 0.5 ms delay for read
       }
       else if(myRAM[255] == 2)  // write
@@ -376,6 +384,7 @@ uInt8 CartridgeFA2::ramReadWrite()
     {
       myRamAccessTimeout = 0;  // Turn off timer
       myRAM[255] = 0;          // Successful operation
+      ramChanged(255);
 
       // Bit 6 is 0, ready/success
       return myImage[myBankOffset + 0xFF4] & ~0x40;
@@ -414,6 +423,7 @@ void CartridgeFA2::flash(uInt8 operation)
       {
         memset(myRAM, 0, 256);
       }
+      stateChanged();
     }
     else if(operation == 2)  // write
     {
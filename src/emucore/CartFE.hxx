@@ -75,7 +75,7 @@ class System;
   @author  Stephen Anthony; with ideas/research from Christian Speckner and
            alex_79 and TomSon (of AtariAge)
 */
-class CartridgeFE : public Cartridge
+class CartridgeFE final : public Cartridge
 {
   friend class CartridgeFEWidget;
 
@@ -37,14 +37,51 @@ void CartridgeMNetwork::initialize(const ByteBuffer& image, uInt32 size)
   // Copy the ROM image into my buffer
   memcpy(myImage.get(), image.get(), std::min(romSize(), size));
   createCodeAccessBase(romSize() + RAM_SIZE);
+  trackRAM(myRAM, RAM_SIZE);
 
   myRAMSlice = bankCount() - 1;
+
+  // Precompute the page access methods of the first segment; its last
+  // slice shows the 1K RAM instead (write port, then read port)
+  defineSegment(BANK_SIZE, bankCount(), [this](uInt16 slice, uInt16 offset) {
+    System::PageAccess access(this, System::PageAccessType::READ);
+
+    if(slice != myRAMSlice)
+    {
+      access.directPeekBase = &myImage[(slice << 11) + offset];
+      access.codeAccessBase = &myCodeAccessBase[(slice << 11) + offset];
+    }
+    else
+    {
+      // All RAM writes are mapped to ::poke()
+      if(offset < BANK_SIZE / 2)
+        access.type = System::PageAccessType::WRITE;
+      else
+        access.directPeekBase = &myRAM[offset & (BANK_SIZE / 2 - 1)];
+      access.codeAccessBase = &myCodeAccessBase[romSize() + (offset & (BANK_SIZE / 2 - 1))];
+    }
+    return access;
+  });
+
+  // Precompute the page access methods of the 256B RAM banks (write port,
+  // then read port)
+  defineSegment(0x200, 4, [this](uInt16 bank, uInt16 offset) {
+    System::PageAccess access(this, System::PageAccessType::READ);
+
+    if(offset < 0x100)
+      access.type = System::PageAccessType::WRITE;
+    else
+      access.directPeekBase = &myRAM[1024 + (bank << 8) + (offset & 0x00FF)];
+    access.codeAccessBase = &myCodeAccessBase[romSize() + BANK_SIZE / 2 + (offset & 0x00FF)];
+    return access;
+  });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeMNetwork::reset()
 {
   initializeRAM(myRAM, RAM_SIZE);
+  stateChanged();
 
   initializeStartBank(0);
   uInt32 ramBank = randomStartBank() ?
@@ -158,13 +195,11 @@ void CartridgeMNetwork::bankRAM(uInt16 bank)
 
   // Remember what bank we're in
   myCurrentRAM = bank;
-  uInt16 offset = bank << 8; // * RAM_SLICE_SIZE (256)
 
-  // Setup the page access methods for the current bank
-  // Set the page accessing method for the 256 bytes of RAM reading pages
-  setAccess(0x1800, 0x100, 1024 + offset, myRAM, romSize() + BANK_SIZE / 2, System::PageAccessType::WRITE);
-  // Set the page accessing method for the 256 bytes of RAM reading pages
-  setAccess(0x1900, 0x100, 1024 + offset, myRAM, romSize() + BANK_SIZE / 2, System::PageAccessType::READ);
+  // Setup the page access methods for the 256 bytes of RAM writing and
+  // reading pages
+  mapSegment(1, bank, 0x1800);
+  stateChanged();
 
   myBankChanged = true;
 }
@@ -177,21 +212,10 @@ bool CartridgeMNetwork::bank(uInt16 slice)
   // Remember what bank we're in
   myCurrentSlice[0] = slice;
 
-  // Setup the page access methods for the current bank
-  if(slice != myRAMSlice)
-  {
-    uInt16 offset = slice << 11; // * BANK_SIZE (2048)
+  // Map the ROM image or the 1K slice of RAM into the first segment
+  mapSegment(0, slice, 0x1000);
+  stateChanged();
 
-    // Map ROM image into first segment
-    setAccess(0x1000, BANK_SIZE, offset, myImage.get(), offset, System::PageAccessType::READ);
-  }
-  else
-  {
-    // Set the page accessing method for the 1K slice of RAM writing pages
-    setAccess(0x1000,                 BANK_SIZE / 2, 0, myRAM, romSize(), System::PageAccessType::WRITE);
-    // Set the page accessing method for the 1K slice of RAM reading pages
-    setAccess(0x1000 + BANK_SIZE / 2, BANK_SIZE / 2, 0, myRAM, romSize(), System::PageAccessType::READ);
-  }
   return myBankChanged = true;
 }
 
@@ -214,6 +238,7 @@ bool CartridgeMNetwork::patch(uInt16 address, uInt8 value)
       // However, the patch command is special in that ignores such
       // cart restrictions
       myRAM[address & 0x03FF] = value;
+      ramChanged(address & 0x03FF);
     }
     else
       myImage[(myCurrentSlice[0] << 11) + (address & (BANK_SIZE-1))] = value;
@@ -224,6 +249,7 @@ bool CartridgeMNetwork::patch(uInt16 address, uInt8 value)
     // However, the patch command is special in that ignores such
     // cart restrictions
     myRAM[1024 + (myCurrentRAM << 8) + (address & 0x00FF)] = value;
+    ramChanged(1024 + (myCurrentRAM << 8) + (address & 0x00FF));
   }
   else
     myImage[(myCurrentSlice[address >> 11] << 11) + (address & (BANK_SIZE-1))] = value;
@@ -245,7 +271,7 @@ bool CartridgeMNetwork::save(Serializer& out) const
   {
     out.putShortArray(myCurrentSlice, NUM_SEGMENTS);
     out.putShort(myCurrentRAM);
-    out.putByteArray(myRAM, RAM_SIZE);
+    saveRAM(out);
   }
   catch(...)
   {
@@ -271,6 +297,8 @@ bool CartridgeMNetwork::load(Serializer& in)
     return false;
   }
 
+  stateChanged();
+
   // Set up the previously used banks for the RAM and segment
   bankRAM(myCurrentRAM);
   bank(myCurrentSlice[0]);
@@ -21,6 +21,7 @@
 #include "AtariVox.hxx"
 #include "Booster.hxx"
 #include "Cart.hxx"
+#include "CartDetector.hxx"
 #include "Control.hxx"
 #include "Cart.hxx"
 #include "Driving.hxx"
@@ -61,12 +62,15 @@
 #include "frame-manager/FrameManager.hxx"
 #include "frame-manager/FrameLayoutDetector.hxx"
 #include "frame-manager/YStartDetector.hxx"
+#include "Tracer.hxx"
+#include "Logger.hxx"
 
 #ifdef CHEATCODE_SUPPORT
   #include "CheatManager.hxx"
 #endif
 #ifdef DEBUGGER_SUPPORT
   #include "Debugger.hxx"
+  #include "CpuTrace.hxx"
 #endif
 
 #include "Console.hxx"
@@ -89,8 +93,11 @@ Console::Console(OSystem& osystem, unique_ptr<Cartridge>& cart,
     myFormatAutodetected(false),
     myUserPaletteDefined(false),
     myConsoleTiming(ConsoleTiming::ntsc),
-    myAudioSettings(audioSettings)
+    myAudioSettings(audioSettings),
+    myIsClone(false)
 {
+  TRACE_SCOPE("Console::Console");
+
   // Load user-defined palette for this ROM
   loadUserPalette();
 
@@ -214,6 +221,55 @@ Console::Console(OSystem& osystem, unique_ptr<Cartridge>& cart,
   mySystem->consoleChanged(myConsoleTiming);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Console::Console(const Console& source, unique_ptr<Cartridge>& cart,
+                 const Event& event)
+  : myOSystem(source.myOSystem),
+    myEvent(event),
+    myProperties(source.myProperties),
+    myCart(std::move(cart)),
+    myDisplayFormat(source.myDisplayFormat),
+    myCurrentFormat(source.myCurrentFormat),
+    myAutodetectedYstart(source.myAutodetectedYstart),
+    myYStartAutodetected(source.myYStartAutodetected),
+    myFormatAutodetected(source.myFormatAutodetected),
+    myUserPaletteDefined(source.myUserPaletteDefined),
+    myConsoleInfo(source.myConsoleInfo),
+    myConsoleTiming(source.myConsoleTiming),
+    myAudioSettings(source.myAudioSettings),
+    myIsClone(true)
+{
+  TRACE_SCOPE("Console::clone");
+
+  // Same as above, except that the frame layout is taken from the source,
+  // and nothing besides the settings is shared with other consoles
+  my6502 = make_unique<M6502>(myOSystem.settings());
+  myRiot = make_unique<M6532>(*this, myOSystem.settings());
+  myTIA  = make_unique<TIA>(*this, [this]() { return timing(); },  myOSystem.settings());
+  myFrameManager = make_unique<FrameManager>();
+  mySwitches = make_unique<Switches>(myEvent, myProperties, myOSystem.settings());
+
+  myTIA->setFrameManager(myFrameManager.get());
+
+  // The state of the generator is copied along with the system
+  myCloneRandom = make_unique<Random>(0);
+  mySystem = make_unique<System>(*myCloneRandom, *my6502, *myRiot, *myTIA, *myCart);
+
+  myLeftControl  = make_unique<Joystick>(Controller::Jack::Left, myEvent, *mySystem);
+  myRightControl = make_unique<Joystick>(Controller::Jack::Right, myEvent, *mySystem);
+
+  myCart->setStartBankFromPropsFunc([this]() {
+    const string& startbank = myProperties.get(PropType::Cart_StartBank);
+    return startbank == EmptyString ? -1 : atoi(startbank.c_str());
+  });
+
+  mySystem->initialize();
+  setControllers(myProperties.get(PropType::Cart_MD5));
+  setTIAProperties();
+  mySystem->reset();
+  mySystem->consoleChanged(myConsoleTiming);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Console::~Console()
 {
@@ -223,7 +279,16 @@ Console::~Console()
 
   // Close audio to prevent invalid access to myConsoleTiming from the audio
   // callback
-  myOSystem.sound().close();
+  if(!myIsClone)
+    myOSystem.sound().close();
+
+#ifdef DEBUGGER_SUPPORT
+  // Write the instructions recorded for the 'cputrace' option
+  const string& cpuTraceFile = myOSystem.settings().getString("cputrace");
+  const CpuTrace* cpuTrace = mySystem->m6502().cpuTrace();
+  if(!myIsClone && !cpuTraceFile.empty() && cpuTrace && !cpuTrace->save(cpuTraceFile))
+    Logger::log("ERROR: Couldn't write CPU trace file '" + cpuTraceFile + "'", 0);
+#endif
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -315,8 +380,9 @@ bool Console::save(Serializer& out) const
       return false;
 
     // Now save the console controllers and switches
-    if(!(myLeftControl->save(out) && myRightControl->save(out) &&
-         mySwitches->save(out)))
+    if(!(myLeftControlCache.save(*myLeftControl, out) &&
+         myRightControlCache.save(*myRightControl, out) &&
+         mySwitchesCache.save(*mySwitches, out)))
       return false;
   }
   catch(...)
@@ -351,6 +417,54 @@ bool Console::load(Serializer& in)
   return true;  // success
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+unique_ptr<Console> Console::clone(const Event& event) const
+{
+  // The cartridge is created from its current image; for multicarts, this
+  // is the selected game only, whose type must be detected again (and not
+  // be taken from the extension of the ROM file)
+  uInt32 size = 0;
+  const uInt8* image = myCart->getImage(size);
+  if(image == nullptr || size == 0)
+    return nullptr;
+
+  ByteBuffer copy = make_unique<uInt8[]>(size);
+  std::copy_n(image, size, copy.get());
+  string md5 = myProperties.get(PropType::Cart_MD5);
+  const bool multiCart = myCart->multiCartID() != "";
+  const FilesystemNode& file = multiCart ? FilesystemNode(md5) : myOSystem.romFile();
+  const string& type = multiCart ? "AUTO" : myCart->detectedType();
+
+  unique_ptr<Console> console;
+  try
+  {
+    unique_ptr<Cartridge> cart =
+      CartDetector::create(file, copy, size, md5, type, myOSystem.settings());
+    console = unique_ptr<Console>(new Console(*this, cart, event));
+  }
+  catch(const runtime_error& e)
+  {
+    cerr << "ERROR: Console::clone: " << e.what() << endl;
+    return nullptr;
+  }
+
+  if(!console->copyState(*this))
+    return nullptr;
+
+  return console;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Console::copyState(const Console& source)
+{
+  Serializer& s = myCopyBuffer;
+
+  // Unchanged components of the source reuse their last encoding
+  s.rewind();
+  return source.save(s) && source.myTIA->saveDisplay(s) &&
+         load(s) && myTIA->loadDisplay(s);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Console::toggleFormat(int direction)
 {
@@ -29,6 +29,7 @@ class CompuMate;
 class Debugger;
 class AudioQueue;
 class AudioSettings;
+class Random;
 
 #include "bspf.hxx"
 #include "ConsoleIO.hxx"
@@ -147,6 +148,30 @@ class Console : public Serializable, public ConsoleIO
     */
     bool load(Serializer& in) override;
 
+    /**
+      Create an independent copy of this console in its current state, e.g.
+      to explore alternative inputs from here.  The copy is driven by the
+      given events and its own random generator, has no audio and is never
+      displayed, so several copies can be emulated in parallel on different
+      threads (by updating its controllers and switches from the events, and
+      calling tia().update()).  Note that SaveKey/AtariVox controllers of
+      all copies still use the same EEPROM file.
+
+      @param event  The event object for the controllers of the copy
+      @return       The copy, or nullptr if it couldn't be created
+    */
+    unique_ptr<Console> clone(const Event& event) const;
+
+    /**
+      Copy the current state (including the display) of another console of
+      the same ROM, usually a clone, into this console.  The other console
+      must not be emulated or copied by another thread meanwhile.
+
+      @param source  The console to copy the state from
+      @return        False if the state couldn't be copied
+    */
+    bool copyState(const Console& source);
+
     /**
       Set the properties to those given
 
@@ -299,6 +324,12 @@ class Console : public Serializable, public ConsoleIO
     void updateYStart(uInt32 ystart);
 
   private:
+    /**
+      Create a copy of the given console for clone(); the state itself
+      is copied afterwards.
+    */
+    Console(const Console& source, unique_ptr<Cartridge>& cart, const Event& event);
+
     /**
      * Dry-run the emulation and detect the frame layout (PAL / NTSC).
      */
@@ -367,6 +398,9 @@ class Console : public Serializable, public ConsoleIO
     // Properties for the game
     Properties myProperties;
 
+    // The random generator of a clone (others use the one of the OSystem)
+    unique_ptr<Random> myCloneRandom;
+
     // Pointer to the 6502 based system being emulated
     unique_ptr<System> mySystem;
 
@@ -395,6 +429,9 @@ class Console : public Serializable, public ConsoleIO
     // Pointers to the left and right controllers
     unique_ptr<Controller> myLeftControl, myRightControl;
 
+    // Reuse the state of the controllers and switches while it is unchanged
+    mutable SerializableCache myLeftControlCache, myRightControlCache, mySwitchesCache;
+
     // Pointer to CompuMate handler (only used in CompuMate ROMs)
     shared_ptr<CompuMate> myCMHandler;
 
@@ -430,6 +467,12 @@ class Console : public Serializable, public ConsoleIO
     // The audio settings
     AudioSettings& myAudioSettings;
 
+    // Whether this console is a clone, which doesn't touch the OSystem
+    bool myIsClone;
+
+    // Buffer for copying the state of another console
+    Serializer myCopyBuffer;
+
     // Table of RGB values for NTSC, PAL and SECAM
     static uInt32 ourNTSCPalette[256];
     static uInt32 ourPALPalette[256];
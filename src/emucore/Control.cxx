@@ -27,7 +27,8 @@ Controller::Controller(Jack jack, const Event& event, const System& system,
     myEvent(event),
     mySystem(system),
     myType(type),
-    myOnAnalogPinUpdateCallback(nullptr)
+    myOnAnalogPinUpdateCallback(nullptr),
+    myStateGeneration(0)
 {
   resetDigitalPins();
   resetAnalogPins();
@@ -80,6 +81,20 @@ bool Controller::save(Serializer& out) const
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 Controller::stateGeneration() const
+{
+  if(myStateGeneration == 0 ||
+     memcmp(myDigitalPinState, myGenerationDigitalPinState, sizeof(myDigitalPinState)) ||
+     memcmp(myAnalogPinValue, myGenerationAnalogPinValue, sizeof(myAnalogPinValue)))
+  {
+    memcpy(myGenerationDigitalPinState, myDigitalPinState, sizeof(myDigitalPinState));
+    memcpy(myGenerationAnalogPinValue, myAnalogPinValue, sizeof(myAnalogPinValue));
+    myStateGeneration = nextStateGeneration();
+  }
+  return myStateGeneration;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Controller::load(Serializer& in)
 {
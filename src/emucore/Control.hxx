@@ -247,6 +247,12 @@ class Controller : public Serializable
     */
     bool load(Serializer& in) override;
 
+    /**
+      Answer the state generation (see Serializable), which changes
+      whenever any of the pins has changed.
+    */
+    uInt64 stateGeneration() const override;
+
     /**
       Inject a callback to be notified on analog pin updates.
     */
@@ -315,6 +321,11 @@ class Controller : public Serializable
     /// The analog value on each analog pin
     Int32 myAnalogPinValue[2];
 
+    /// The pin values when the state generation was last determined
+    mutable bool myGenerationDigitalPinState[5];
+    mutable Int32 myGenerationAnalogPinValue[2];
+    mutable uInt64 myStateGeneration;
+
   private:
     // Following constructors and assignment operators not supported
     Controller() = delete;
@@ -20,6 +20,7 @@
 #include "EmulationWorker.hxx"
 #include "DispatchResult.hxx"
 #include "TIA.hxx"
+#include "Tracer.hxx"
 
 using namespace std::chrono;
 
@@ -32,7 +33,10 @@ EmulationWorker::EmulationWorker()
     myMaxCycles(0),
     myMinCycles(0),
     myDispatchResult(nullptr),
-    myTotalCycles(0)
+    myUnthrottledSeconds(0),
+    myTotalCycles(0),
+    myTotalEmulationTime(0),
+    myLastEmulationTime(0)
 {
   std::mutex mutex;
   std::unique_lock<std::mutex> lock(mutex);
@@ -77,7 +81,8 @@ void EmulationWorker::handlePossibleException()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void EmulationWorker::start(uInt32 cyclesPerSecond, uInt64 maxCycles, uInt64 minCycles, DispatchResult* dispatchResult, TIA* tia)
+void EmulationWorker::start(uInt32 cyclesPerSecond, uInt64 maxCycles, uInt64 minCycles, DispatchResult* dispatchResult, TIA* tia,
+                            double unthrottledSeconds)
 {
   // Wait until any pending signal has been processed
   waitUntilPendingSignalHasProcessed();
@@ -105,6 +110,7 @@ void EmulationWorker::start(uInt32 cyclesPerSecond, uInt64 maxCycles, uInt64 min
     myMaxCycles = maxCycles;
     myMinCycles = minCycles;
     myDispatchResult = dispatchResult;
+    myUnthrottledSeconds = unthrottledSeconds;
 
     // Raise the signal...
     myPendingSignal = Signal::resume;
@@ -127,6 +133,8 @@ uInt64 EmulationWorker::stop()
     // Paranoia: make sure that we don't doublecount an emulation timeslice
     totalCycles = myTotalCycles;
     myTotalCycles = 0;
+    myLastEmulationTime = myTotalEmulationTime;
+    myTotalEmulationTime = 0;
 
     handlePossibleException();
 
@@ -152,6 +160,8 @@ void EmulationWorker::threadMain(std::condition_variable* initializedCondition,
 {
   std::unique_lock<std::mutex> lock(myThreadIsRunningMutex);
 
+  Tracer::instance().setThreadName("emulation");
+
   try {
     {
       // Wait until our parent releases the lock and sleeps
@@ -211,9 +221,14 @@ void EmulationWorker::handleWakeupFromWaitingForResume(std::unique_lock<std::mut
       // Clear the pending signal and notify the main thread
       clearSignal();
 
-      // Reset virtual clock and cycle counter
+      // Reset virtual clock, cycle counter and time spent emulating
       myVirtualTime = high_resolution_clock::now();
       myTotalCycles = 0;
+      myTotalEmulationTime = 0;
+
+      if (myUnthrottledSeconds > 0)
+        myUnthrottledDeadline = myVirtualTime +
+          duration_cast<high_resolution_clock::duration>(duration<double>(myUnthrottledSeconds));
 
       // Enter emulation. This will emulate a timeslice and set the state upon completion.
       dispatchEmulation(lock);
@@ -267,10 +282,13 @@ void EmulationWorker::handleWakeupFromWaitingForStop(std::unique_lock<std::mutex
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void EmulationWorker::dispatchEmulation(std::unique_lock<std::mutex>& lock)
 {
+  TRACE_SCOPE("EmulationWorker::dispatchEmulation");
+
   // Technically, we could do without State::running, but it is cleaner and might be useful in the future
   myState = State::running;
 
   uInt64 totalCycles = 0;
+  const time_point<high_resolution_clock> startTime = high_resolution_clock::now();
 
   do {
     myTia->update(*myDispatchResult, totalCycles > 0 ? myMinCycles - totalCycles : myMaxCycles);
@@ -278,10 +296,19 @@ void EmulationWorker::dispatchEmulation(std::unique_lock<std::mutex>& lock)
   } while (totalCycles < myMinCycles && myDispatchResult->getStatus() == DispatchResult::Status::ok);
 
   myTotalCycles += totalCycles;
+  myTotalEmulationTime +=
+    duration_cast<duration<double>>(high_resolution_clock::now() - startTime).count();
 
   bool continueEmulating = false;
 
-  if (myDispatchResult->getStatus() == DispatchResult::Status::ok) {
+  if (myDispatchResult->getStatus() == DispatchResult::Status::ok && myUnthrottledSeconds > 0) {
+    // In unthrottled mode, 6507 time is not synced to real time. We go for another round
+    // immediatelly until the time allotted to this run has been used up, and then stop
+    // on our own.
+    myVirtualTime = high_resolution_clock::now();
+    continueEmulating = myVirtualTime < myUnthrottledDeadline;
+  }
+  else if (myDispatchResult->getStatus() == DispatchResult::Status::ok) {
     // If emulation finished successfully, we are free to go for another round
     duration<double> timesliceSeconds(static_cast<double>(totalCycles) / static_cast<double>(myCyclesPerSecond));
     myVirtualTime += duration_cast<high_resolution_clock::duration>(timesliceSeconds);
@@ -33,6 +33,10 @@
  * In combination, the scheduling in the main loop and the microscheduling in the worker
  * ensure that the emulation continues to run even if rendering blocks, ensuring the real
  * time scheduling required for cycle exact audio to work.
+ *
+ * In turbo mode, the worker can also run unthrottled. In this case, it emulates timeslices
+ * back to back for a given amount of real time and then stops on its own; the main loop
+ * paces itself to the display instead of 6507 time.
  */
 
 #ifndef EMULATION_WORKER_HXX
@@ -66,14 +70,25 @@ class EmulationWorker
 
     /**
       Wake up the worker and start emulation with the specified parameters.
+
+      If unthrottledSeconds is nonzero, emulation is not synced to 6507 time. Instead,
+      the worker emulates timeslices back to back until the given amount of real time
+      has passed, and then stops on its own (turbo mode).
      */
-    void start(uInt32 cyclesPerSecond, uInt64 maxCycles, uInt64 minCycles, DispatchResult* dispatchResult, TIA* tia);
+    void start(uInt32 cyclesPerSecond, uInt64 maxCycles, uInt64 minCycles, DispatchResult* dispatchResult, TIA* tia,
+               double unthrottledSeconds = 0);
 
     /**
       Stop emulation and return the number of 6507 cycles emulated.
      */
     uInt64 stop();
 
+    /**
+      The real time (in seconds) the worker spent emulating during the run that
+      was ended by the last call to stop().
+     */
+    double emulationTime() const { return myLastEmulationTime; }
+
   private:
 
     /**
@@ -193,11 +208,17 @@ class EmulationWorker
     uInt64 myMaxCycles;
     uInt64 myMinCycles;
     DispatchResult* myDispatchResult;
+    double myUnthrottledSeconds;
 
     // Total number of cycles during this emulation run
     uInt64 myTotalCycles;
+    // Real time spent in TIA::update during this and the last emulation run
+    double myTotalEmulationTime;
+    double myLastEmulationTime;
     // 6507 time
     std::chrono::time_point<std::chrono::high_resolution_clock> myVirtualTime;
+    // End of the current run in unthrottled mode
+    std::chrono::time_point<std::chrono::high_resolution_clock> myUnthrottledDeadline;
 
   private:
 
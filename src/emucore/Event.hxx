@@ -18,7 +18,7 @@
 #ifndef EVENT_HXX
 #define EVENT_HXX
 
-#include <mutex>
+#include <atomic>
 
 #include "bspf.hxx"
 #include "StellaKeys.hxx"
@@ -75,7 +75,7 @@ class Event
       ChangeState, LoadState, SaveState, TakeSnapshot, Quit,
       PauseMode, OptionsMenuMode, CmdMenuMode, TimeMachineMode, DebuggerMode, LauncherMode,
       Fry, VolumeDecrease, VolumeIncrease, SoundToggle, VidmodeDecrease, VidmodeIncrease,
-      Rewind, Unwind,
+      Rewind, Unwind, TurboMode,
 
       UIUp, UIDown, UILeft, UIRight, UIHome, UIEnd, UIPgUp, UIPgDown,
       UISelect, UINavPrev, UINavNext, UIOK, UICancel, UIPrevDir,
@@ -87,9 +87,8 @@ class Event
     class KeyTable {
       public:
 
-        KeyTable(const bool* keyTable, std::mutex& mutex)
+        explicit KeyTable(const std::atomic<bool>* keyTable)
           : myKeyTable(keyTable),
-            myMutex(mutex),
             myIsEnabled(true)
         {
         }
@@ -97,9 +96,7 @@ class Event
         bool operator[](int type) const {
           if (!myIsEnabled) return false;
 
-          std::lock_guard<std::mutex> lock(myMutex);
-
-          return myKeyTable[type];
+          return myKeyTable[type].load(std::memory_order_relaxed);
         }
 
         void enable(bool isEnabled) {
@@ -108,8 +105,7 @@ class Event
 
       private:
 
-        const bool *myKeyTable;
-        std::mutex& myMutex;
+        const std::atomic<bool>* myKeyTable;
 
         bool myIsEnabled;
 
@@ -126,18 +122,22 @@ class Event
       Get the value associated with the event of the specified type.
     */
     Int32 get(Type type) const {
-      std::lock_guard<std::mutex> lock(myMutex);
-
-      return myValues[type];
+      return myValues[type].load(std::memory_order_relaxed);
     }
 
     /**
       Set the value associated with the event of the specified type.
     */
     void set(Type type, Int32 value) {
-      std::lock_guard<std::mutex> lock(myMutex);
+      myValues[type].store(value, std::memory_order_relaxed);
+    }
 
-      myValues[type] = value;
+    /**
+      Add to the value associated with the event of the specified type
+      (for relative values, like the mouse motion).
+    */
+    void add(Type type, Int32 value) {
+      myValues[type].fetch_add(value, std::memory_order_relaxed);
     }
 
     /**
@@ -145,8 +145,6 @@ class Event
     */
     void clear()
     {
-      std::lock_guard<std::mutex> lock(myMutex);
-
       for(uInt32 i = 0; i < LastType; ++i)
         myValues[i] = Event::NoType;
 
@@ -157,15 +155,13 @@ class Event
     /**
       Get the keytable associated with this event.
     */
-    KeyTable getKeys() const { return KeyTable(myKeyTable, myMutex); }
+    KeyTable getKeys() const { return KeyTable(myKeyTable); }
 
     /**
       Set the value associated with the event of the specified type.
     */
     void setKey(StellaKey key, bool pressed) {
-      std::lock_guard<std::mutex> lock(myMutex);
-
-      myKeyTable[key] = pressed;
+      myKeyTable[key].store(pressed, std::memory_order_relaxed);
     }
 
     /**
@@ -185,14 +181,25 @@ class Event
       }
     }
 
+    /**
+      Whether the event only represents controller input (joysticks,
+      paddles and keyboards), which the event handler publishes without
+      any other side effects.
+    */
+    static bool isController(Type type)
+    {
+      return type >= Event::JoystickZeroUp && type <= Event::KeyboardOnePound;
+    }
+
   private:
     // Array of values associated with each event type
-    Int32 myValues[LastType];
+    // The event handler publishes input here while the emulation thread may
+    // be reading it (see 'inputlatch'); every entry is independent, so
+    // relaxed atomics are sufficient and no lock is taken on either side
+    std::atomic<Int32> myValues[LastType];
 
     // Array of keyboard key states
-    bool myKeyTable[KBDK_LAST];
-
-    mutable std::mutex myMutex;
+    std::atomic<bool> myKeyTable[KBDK_LAST];
 
   private:
     // Following constructors and assignment operators not supported
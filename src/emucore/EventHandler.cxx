@@ -61,6 +61,15 @@
   #include "ScrollBarWidget.hxx"
 #endif
 
+namespace {
+  // Joystick events which are unmapped or only feed the controllers can be
+  // published while the emulation is running
+  bool isControllerInput(Event::Type event)
+  {
+    return event == Event::NoType || Event::isController(event);
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 EventHandler::EventHandler(OSystem& osystem)
   : myOSystem(osystem),
@@ -69,6 +78,11 @@ EventHandler::EventHandler(OSystem& osystem)
     myAllowAllDirectionsFlag(false),
     myFryingFlag(false),
     mySkipMouseMotion(true),
+    myMouseMotionX(0),
+    myMouseMotionY(0),
+    myMovieMouseMotionX(0),
+    myMovieMouseMotionY(0),
+    myPollingInput(false),
     myIs7800(false)
 {
   // Create keyboard handler (to handle all physical keyboard functionality)
@@ -142,6 +156,9 @@ void EventHandler::reset(EventHandlerState state)
 void EventHandler::addPhysicalJoystick(PhysicalJoystickPtr joy)
 {
 #ifdef JOYSTICK_SUPPORT
+  if(deferEvent(false, [=]{ addPhysicalJoystick(joy); }))
+    return;
+
   int ID = myPJoyHandler->add(joy);
   if(ID < 0)
     return;
@@ -160,6 +177,9 @@ void EventHandler::addPhysicalJoystick(PhysicalJoystickPtr joy)
 void EventHandler::removePhysicalJoystick(int id)
 {
 #ifdef JOYSTICK_SUPPORT
+  if(deferEvent(false, [=]{ removePhysicalJoystick(id); }))
+    return;
+
   myPJoyHandler->remove(id);
 #endif
 }
@@ -209,14 +229,31 @@ void EventHandler::handleMouseControl()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void EventHandler::poll(uInt64 time)
 {
-  // Process events from the underlying hardware
+  // Process the events deferred during emulation first, then the new ones
+  // from the underlying hardware
+  for(const auto& handler: myDeferredEvents)
+    handler();
+  myDeferredEvents.clear();
   pollEvent();
 
   // Update controllers and console switches, and in general all other things
   // related to emulation
   if(myState == EventHandlerState::EMULATION)
   {
-    myOSystem.console().riot().update();
+    // During movies, input only reaches the console at the start of each
+    // frame, which makes it exactly reproducible; the mouse motion is added
+    // up until then
+    if(myOSystem.state().movieActive())
+    {
+      myMovieMouseMotionX += myMouseMotionX;
+      myMovieMouseMotionY += myMouseMotionY;
+    }
+    else
+    {
+      myEvent.set(Event::MouseAxisXValue, myMouseMotionX);
+      myEvent.set(Event::MouseAxisYValue, myMouseMotionY);
+      myOSystem.console().riot().update();
+    }
 
     // Now check if the StateManager should be saving or loading state
     // (for rewind and/or movies
@@ -245,13 +282,46 @@ void EventHandler::poll(uInt64 time)
 
   // Turn off all mouse-related items; if they haven't been taken care of
   // in the previous ::update() methods, they're now invalid
-  myEvent.set(Event::MouseAxisXValue, 0);
-  myEvent.set(Event::MouseAxisYValue, 0);
+  myMouseMotionX = myMouseMotionY = 0;
+  if(myState != EventHandlerState::EMULATION || !myOSystem.state().movieActive())
+  {
+    myEvent.set(Event::MouseAxisXValue, 0);
+    myEvent.set(Event::MouseAxisYValue, 0);
+    myMovieMouseMotionX = myMovieMouseMotionY = 0;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EventHandler::pollInput()
+{
+  myPollingInput = true;
+  pollEvent();
+  myPollingInput = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool EventHandler::deferEvent(bool controller, const std::function<void()>& handler)
+{
+  if(!myPollingInput || (controller && myDeferredEvents.empty()))
+    return false;
+
+  myDeferredEvents.push_back(handler);
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EventHandler::latchMouseMotion()
+{
+  myEvent.set(Event::MouseAxisXValue, myMovieMouseMotionX.exchange(0));
+  myEvent.set(Event::MouseAxisYValue, myMovieMouseMotionY.exchange(0));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void EventHandler::handleTextEvent(char text)
 {
+  if(deferEvent(false, [=]{ handleTextEvent(text); }))
+    return;
+
 #ifdef GUI_SUPPORT
   // Text events are only used in GUI mode
   if(myOverlay)
@@ -262,13 +332,18 @@ void EventHandler::handleTextEvent(char text)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void EventHandler::handleMouseMotionEvent(int x, int y, int xrel, int yrel)
 {
+  if(deferEvent(myState == EventHandlerState::EMULATION,
+                [=]{ handleMouseMotionEvent(x, y, xrel, yrel); }))
+    return;
+
   // Determine which mode we're in, then send the event to the appropriate place
   if(myState == EventHandlerState::EMULATION)
   {
+    // Several motion events may arrive until the next poll
     if(!mySkipMouseMotion)
     {
-      myEvent.set(Event::MouseAxisXValue, xrel);
-      myEvent.set(Event::MouseAxisYValue, yrel);
+      myMouseMotionX += xrel;
+      myMouseMotionY += yrel;
     }
     mySkipMouseMotion = false;
   }
@@ -282,6 +357,10 @@ void EventHandler::handleMouseMotionEvent(int x, int y, int xrel, int yrel)
 void EventHandler::handleMouseButtonEvent(MouseButton b, bool pressed,
                                           int x, int y)
 {
+  if(deferEvent(myState == EventHandlerState::EMULATION,
+                [=]{ handleMouseButtonEvent(b, pressed, x, y); }))
+    return;
+
   // Determine which mode we're in, then send the event to the appropriate place
   if(myState == EventHandlerState::EMULATION)
   {
@@ -304,8 +383,66 @@ void EventHandler::handleMouseButtonEvent(MouseButton b, bool pressed,
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void EventHandler::handleSystemEvent(SystemEvent e, int, int)
+void EventHandler::handleKeyEvent(StellaKey key, StellaMod mod, bool pressed)
+{
+  // Control and Alt combos are handled by the keyboard handler itself
+  const bool controller = myState == EventHandlerState::EMULATION &&
+      !StellaModTest::isControl(mod) && !StellaModTest::isAlt(mod) &&
+      myPKeyHandler->altKeyCount() == 0 &&
+      Event::isController(eventForKey(key, kEmulationMode));
+
+  if(deferEvent(controller, [=]{ handleKeyEvent(key, mod, pressed); }))
+    return;
+
+  myPKeyHandler->handleEvent(key, mod, pressed);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EventHandler::handleJoyBtnEvent(int stick, int button, bool pressed)
 {
+  const bool controller = myState == EventHandlerState::EMULATION &&
+      isControllerInput(eventForJoyButton(stick, button, kEmulationMode));
+
+  if(deferEvent(controller, [=]{ handleJoyBtnEvent(stick, button, pressed); }))
+    return;
+
+  myPJoyHandler->handleBtnEvent(stick, button, pressed);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EventHandler::handleJoyAxisEvent(int stick, int axis, int value)
+{
+  const bool controller = myState == EventHandlerState::EMULATION &&
+      isControllerInput(eventForJoyAxis(stick, axis, -1, kEmulationMode)) &&
+      isControllerInput(eventForJoyAxis(stick, axis, +1, kEmulationMode));
+
+  if(deferEvent(controller, [=]{ handleJoyAxisEvent(stick, axis, value); }))
+    return;
+
+  myPJoyHandler->handleAxisEvent(stick, axis, value);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EventHandler::handleJoyHatEvent(int stick, int hat, int value)
+{
+  const bool controller = myState == EventHandlerState::EMULATION &&
+      isControllerInput(eventForJoyHat(stick, hat, JoyHat::UP, kEmulationMode)) &&
+      isControllerInput(eventForJoyHat(stick, hat, JoyHat::DOWN, kEmulationMode)) &&
+      isControllerInput(eventForJoyHat(stick, hat, JoyHat::LEFT, kEmulationMode)) &&
+      isControllerInput(eventForJoyHat(stick, hat, JoyHat::RIGHT, kEmulationMode));
+
+  if(deferEvent(controller, [=]{ handleJoyHatEvent(stick, hat, value); }))
+    return;
+
+  myPJoyHandler->handleHatEvent(stick, hat, value);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EventHandler::handleSystemEvent(SystemEvent e, int data1, int data2)
+{
+  if(deferEvent(false, [=]{ handleSystemEvent(e, data1, data2); }))
+    return;
+
   switch(e)
   {
     case SystemEvent::WINDOW_EXPOSED:
@@ -333,6 +470,9 @@ void EventHandler::handleSystemEvent(SystemEvent e, int, int)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void EventHandler::handleEvent(Event::Type event, bool pressed)
 {
+  if(deferEvent(isControllerInput(event), [=]{ handleEvent(event, pressed); }))
+    return;
+
   // Take care of special events that aren't part of the emulation core
   // or need to be preprocessed before passing them on
   switch(event)
@@ -424,6 +564,10 @@ void EventHandler::handleEvent(Event::Type event, bool pressed)
       if (pressed) myOSystem.state().unwindStates();
       return;
 
+    case Event::TurboMode:
+      if(pressed) myOSystem.toggleTurbo();
+      return;
+
     case Event::TakeSnapshot:
       if(pressed) myOSystem.frameBuffer().tiaSurface().saveSnapShot();
       return;
@@ -506,7 +650,8 @@ void EventHandler::handleEvent(Event::Type event, bool pressed)
           myEvent.set(Event::ConsoleColor, 1);
           myOSystem.frameBuffer().showMessage(myIs7800 ? "Pause released" : "Color Mode");
         }
-        myOSystem.console().switches().update();
+        if(!myOSystem.state().movieActive())
+          myOSystem.console().switches().update();
       }
       return;
 
@@ -549,7 +694,8 @@ void EventHandler::handleEvent(Event::Type event, bool pressed)
           myEvent.set(Event::ConsoleLeftDiffB, 0);
           myOSystem.frameBuffer().showMessage(GUI::LEFT_DIFFICULTY + " A");
         }
-        myOSystem.console().switches().update();
+        if(!myOSystem.state().movieActive())
+          myOSystem.console().switches().update();
       }
       return;
 
@@ -582,7 +728,8 @@ void EventHandler::handleEvent(Event::Type event, bool pressed)
           myEvent.set(Event::ConsoleRightDiffB, 0);
           myOSystem.frameBuffer().showMessage(GUI::RIGHT_DIFFICULTY + " A");
         }
-        myOSystem.console().switches().update();
+        if(!myOSystem.state().movieActive())
+          myOSystem.console().switches().update();
       }
       return;
     ////////////////////////////////////////////////////////////////////////
@@ -642,6 +789,13 @@ void EventHandler::handleConsoleStartupEvents()
   if(update)
     myOSystem.console().riot().update();
 
+  const string& recordMovie = myOSystem.settings().getString("recordmovie");
+  const string& playMovie = myOSystem.settings().getString("playmovie");
+  if(recordMovie != "")
+    myOSystem.state().startMovieRecording(recordMovie);
+  else if(playMovie != "")
+    myOSystem.state().startMoviePlayback(playMovie);
+
 #ifdef DEBUGGER_SUPPORT
   if(myOSystem.settings().getBool("debug"))
     enterDebugMode();
@@ -1241,6 +1395,10 @@ void EventHandler::setState(EventHandlerState state)
   // For certain ROMs it may be forced off, whatever the setting
   myPKeyHandler->useCtrlKey() = myOSystem.settings().getBool("ctrlcombo");
 
+  // Turbo mode only applies to emulation; it is left in all other modes
+  if(myState != EventHandlerState::EMULATION)
+    myOSystem.enableTurbo(false);
+
   // Only enable text input in GUI modes, since in emulation mode the
   // keyboard acts as one large joystick with many (single) buttons
   myOverlay = nullptr;
@@ -1339,6 +1497,7 @@ EventHandler::ActionList EventHandler::ourEmulActionList[EMUL_ACTIONLIST_SIZE] =
   { Event::TimeMachineMode,        "Toggle time machine UI",      "", false },
   { Event::Rewind,                 "Rewind game",                 "", false },
   { Event::Unwind,                 "Unwind game",                 "", false },
+  { Event::TurboMode,              "Toggle turbo mode",           "", false },
   { Event::DebuggerMode,           "Toggle debugger mode",        "", false },
   { Event::LauncherMode,           "Enter ROM launcher",          "", false },
   { Event::Quit,                   "Quit",                        "", false },
@@ -18,6 +18,8 @@
 #ifndef EVENTHANDLER_HXX
 #define EVENTHANDLER_HXX
 
+#include <atomic>
+#include <functional>
 #include <map>
 
 class Console;
@@ -65,6 +67,15 @@ class EventHandler
     */
     const Event& event() const { return myEvent; }
 
+    /**
+      Pass the relative mouse motion to the controllers.  During movies,
+      the motion is added up over all polls until the ports are updated at
+      the start of the next frame, which then calls this method (on the
+      emulation thread).  The motion is taken over atomically, so motion
+      added by the main thread meanwhile is kept for the next frame.
+    */
+    void latchMouseMotion();
+
     /**
       Initialize state of this eventhandler.
     */
@@ -97,6 +108,14 @@ class EventHandler
     */
     void poll(uInt64 time);
 
+    /**
+      Collects pending events while the emulation runs on the worker
+      thread, so that input latched at the start of a frame is as recent
+      as possible.  Plain controller input is published right away; all
+      other events are deferred to the next call of poll().
+    */
+    void pollInput();
+
     /**
       Get/set the current state of the EventHandler
 
@@ -317,18 +336,10 @@ class EventHandler
     void handleTextEvent(char text);
     void handleMouseMotionEvent(int x, int y, int xrel, int yrel);
     void handleMouseButtonEvent(MouseButton b, bool pressed, int x, int y);
-    void handleKeyEvent(StellaKey key, StellaMod mod, bool pressed) {
-      myPKeyHandler->handleEvent(key, mod, pressed);
-    }
-    void handleJoyBtnEvent(int stick, int button, bool pressed) {
-      myPJoyHandler->handleBtnEvent(stick, button, pressed);
-    }
-    void handleJoyAxisEvent(int stick, int axis, int value) {
-      myPJoyHandler->handleAxisEvent(stick, axis, value);
-    }
-    void handleJoyHatEvent(int stick, int hat, int value) {
-      myPJoyHandler->handleHatEvent(stick, hat, value);
-    }
+    void handleKeyEvent(StellaKey key, StellaMod mod, bool pressed);
+    void handleJoyBtnEvent(int stick, int button, bool pressed);
+    void handleJoyAxisEvent(int stick, int axis, int value);
+    void handleJoyHatEvent(int stick, int hat, int value);
 
     /**
       Collects and dispatches any pending events.
@@ -366,7 +377,7 @@ class EventHandler
     static constexpr Int32
       COMBO_SIZE           = 16,
       EVENTS_PER_COMBO     = 8,
-      EMUL_ACTIONLIST_SIZE = 85 + COMBO_SIZE,
+      EMUL_ACTIONLIST_SIZE = 86 + COMBO_SIZE,
       MENU_ACTIONLIST_SIZE = 16
     ;
 
@@ -378,6 +389,18 @@ class EventHandler
     void setDefaultJoymap(Event::Type, EventMode mode);
     void saveComboMapping();
 
+    /**
+      While pollInput() is running, queue the handler for the next poll()
+      unless the event is plain controller input.  Once an event has been
+      deferred, all following ones are too, so that the order is kept.
+
+      @param controller  Whether the event is plain controller input
+      @param handler     Handles the event when it is deferred
+
+      @return  True if the event was deferred
+    */
+    bool deferEvent(bool controller, const std::function<void()>& handler);
+
   private:
     // Structure used for action menu items
     struct ActionList {
@@ -419,6 +442,18 @@ class EventHandler
     // state change; we detect when this happens and discard the event
     bool mySkipMouseMotion;
 
+    // The relative mouse motion of the current poll
+    Int32 myMouseMotionX, myMouseMotionY;
+
+    // The mouse motion added up during movies until it is latched at the
+    // start of the next frame (see latchMouseMotion())
+    std::atomic<Int32> myMovieMouseMotionX, myMovieMouseMotionY;
+
+    // Set while pollInput() collects events during emulation, and the
+    // events it has deferred to the next poll()
+    bool myPollingInput;
+    vector<std::function<void()>> myDeferredEvents;
+
     // Whether the currently enabled console is emulating certain aspects
     // of the 7800 (for now, only the switches are notified)
     bool myIs7800;
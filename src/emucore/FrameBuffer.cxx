@@ -15,6 +15,8 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <chrono>
+
 #include "bspf.hxx"
 #include "Logger.hxx"
 
@@ -45,12 +47,15 @@
   #include "TimeMachine.hxx"
 #endif
 
+using namespace std::chrono;
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 FrameBuffer::FrameBuffer(OSystem& osystem)
   : myOSystem(osystem),
     myInitializedCount(0),
     myPausedCount(0),
     myStatsEnabled(false),
+    myTimesEnabled(false),
     myLastScanlines(0),
     myGrabMouse(false),
     myHiDPIAllowed(false),
@@ -282,6 +287,18 @@ FBInitStatus FrameBuffer::createDisplay(const string& title,
     myStatsMsg.surface->applyAttributes();
   }
 
+  myTimesMsg.color = kColorInfo;
+  myTimesMsg.w = std::max(f.getMaxCharWidth() * 40 + 3, int(FpsMeter::FRAME_TIMES_SIZE) + 4);
+  myTimesMsg.h = (f.getFontHeight() + 2) * (FpsMeter::NUM_STAGES + 1) + TIMES_GRAPH_HEIGHT + 2;
+
+  if(!myTimesMsg.surface)
+  {
+    myTimesMsg.surface = allocateSurface(myTimesMsg.w, myTimesMsg.h);
+    myTimesMsg.surface->attributes().blending = true;
+    myTimesMsg.surface->attributes().blendalpha = 92;
+    myTimesMsg.surface->applyAttributes();
+  }
+
   if(!myMsg.surface)
     myMsg.surface = allocateSurface(FBMinimum::Width, font().getFontHeight()+10);
 #endif
@@ -417,11 +434,20 @@ void FrameBuffer::updateInEmulationMode(float framesPerSecond)
   // We don't worry about selective rendering here; the rendering
   // always happens at the full framerate
 
+  FpsMeter& fpsMeter = myOSystem.fpsMeter();
+  time_point<high_resolution_clock> startTime = high_resolution_clock::now();
+
   myTIASurface->render();
 
+  time_point<high_resolution_clock> now = high_resolution_clock::now();
+  fpsMeter.addStageTime(FpsMeter::Stage::conversion,
+                        duration_cast<duration<double>>(now - startTime).count());
+
   // Show frame statistics
   if(myStatsMsg.enabled)
     drawFrameStats(framesPerSecond);
+  if(myTimesMsg.enabled)
+    drawFrameTimes();
 
   myLastScanlines = myOSystem.console().tia().frameBufferScanlinesLastFrame();
   myPausedCount = 0;
@@ -431,7 +457,12 @@ void FrameBuffer::updateInEmulationMode(float framesPerSecond)
     drawMessage();
 
   // Push buffers to screen
+  startTime = high_resolution_clock::now();
   renderToScreen();
+
+  now = high_resolution_clock::now();
+  fpsMeter.addStageTime(FpsMeter::Stage::present,
+                        duration_cast<duration<double>>(now - startTime).count());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -513,6 +544,78 @@ void FrameBuffer::drawFrameStats(float framesPerSecond)
 #endif
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameBuffer::drawFrameTimes()
+{
+#ifdef GUI_SUPPORT
+  static constexpr std::array<const char*, FpsMeter::NUM_STAGES> STAGE_NAMES = {
+    "Emulation", "Conversion", "Present", "Audio", "Run-ahead", "Idle"
+  };
+  static constexpr std::array<ColorId, FpsMeter::NUM_STAGES> STAGE_COLORS = {
+    kDbgChangedTextColor, kDbgColorHi, kSliderColorHi, kTextColorEm, kDbgColorRed, kBGColorLo
+  };
+
+  const FpsMeter& fpsMeter = myOSystem.fpsMeter();
+  int xPos = 2, yPos = 0;
+  const GUI::Font& f = hidpiEnabled() ? infoFont() : font();
+  const int dy = f.getFontHeight() + 2;
+
+  // The graph is scaled to two frame budgets at the emulated framerate
+  const float budget = myOSystem.frameRate() > 0 ? 1000.F / myOSystem.frameRate() : 1000.F / 60;
+
+  ostringstream ss;
+
+  myTimesMsg.surface->invalidate();
+
+  ss << std::left << std::setw(15) << "Frame time (ms)" << std::right
+     << std::setw(7) << "p50" << std::setw(7) << "p99";
+  myTimesMsg.surface->drawString(f, ss.str(), xPos, yPos,
+      myTimesMsg.w, myTimesMsg.color, TextAlign::Left, 0, true, kBGColor);
+  yPos += dy;
+
+  for(uInt32 stage = 0; stage < FpsMeter::NUM_STAGES; ++stage)
+  {
+    const FpsMeter::Stage s = static_cast<FpsMeter::Stage>(stage);
+    ss.str("");
+    ss << std::left << std::setw(15) << STAGE_NAMES[stage] << std::right
+       << std::fixed << std::setprecision(2)
+       << std::setw(7) << fpsMeter.stagePercentile(s, 50)
+       << std::setw(7) << fpsMeter.stagePercentile(s, 99);
+
+    myTimesMsg.surface->drawString(f, ss.str(), xPos, yPos,
+        myTimesMsg.w, STAGE_COLORS[stage], TextAlign::Left, 0, true, kBGColor);
+    yPos += dy;
+  }
+
+  // Stacked bar graph, one column per host frame, oldest on the left
+  const uInt32 graphBottom = yPos + TIMES_GRAPH_HEIGHT;
+  const float scale = TIMES_GRAPH_HEIGHT / (2 * budget);
+
+  for(uInt32 frame = 0; frame < fpsMeter.numFrameTimes(); ++frame)
+  {
+    uInt32 y = graphBottom;
+
+    for(uInt32 stage = 0; stage < FpsMeter::NUM_STAGES && y > uInt32(yPos); ++stage)
+    {
+      const uInt32 h = std::min(uInt32(fpsMeter.frameTime(frame, FpsMeter::Stage(stage)) * scale + 0.5F),
+                                y - yPos);
+      if(h == 0) continue;
+
+      y -= h;
+      myTimesMsg.surface->vLine(xPos + frame, y, y + h - 1, STAGE_COLORS[stage]);
+    }
+  }
+  myTimesMsg.surface->hLine(xPos, graphBottom - TIMES_GRAPH_HEIGHT / 2,
+                            xPos + FpsMeter::FRAME_TIMES_SIZE - 1, kColorInfo);
+
+  const int statsHeight = myStatsMsg.enabled ? (myStatsMsg.h + 4) * hidpiScaleFactor() : 0;
+  myTimesMsg.surface->setDstPos(myImageRect.x() + 10, myImageRect.y() + 8 + statsHeight);
+  myTimesMsg.surface->setDstSize(myTimesMsg.w * hidpiScaleFactor(),
+                                 myTimesMsg.h * hidpiScaleFactor());
+  myTimesMsg.surface->render();
+#endif
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FrameBuffer::toggleFrameStats()
 {
@@ -527,6 +630,12 @@ void FrameBuffer::showFrameStats(bool enable)
   myStatsEnabled = myStatsMsg.enabled = enable;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameBuffer::toggleFrameTimes()
+{
+  myTimesEnabled = myTimesMsg.enabled = !myTimesEnabled;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FrameBuffer::enableMessages(bool enable)
 {
@@ -534,11 +643,13 @@ void FrameBuffer::enableMessages(bool enable)
   {
     // Only re-enable frame stats if they were already enabled before
     myStatsMsg.enabled = myStatsEnabled;
+    myTimesMsg.enabled = myTimesEnabled;
   }
   else
   {
     // Temporarily disable frame stats
     myStatsMsg.enabled = false;
+    myTimesMsg.enabled = false;
 
     // Erase old messages on the screen
     myMsg.enabled = false;
@@ -145,6 +145,11 @@ class FrameBuffer
     */
     void showFrameStats(bool enable);
 
+    /**
+      Toggles showing or hiding the per-stage frame time breakdown.
+    */
+    void toggleFrameTimes();
+
     /**
       Enable/disable any pending messages.  Disabled messages aren't removed
       from the message queue; they're just not redrawn into the framebuffer.
@@ -340,6 +345,12 @@ class FrameBuffer
     */
     virtual void clear() = 0;
 
+    /**
+      Answers the refresh rate (in Hz) of the display showing the window,
+      or 0 if it is unknown.
+    */
+    virtual uInt32 refreshRate() const = 0;
+
   protected:
     /**
       This method is called to query and initialize the video hardware
@@ -501,6 +512,9 @@ class FrameBuffer
     // Draws the frame stats overlay
     void drawFrameStats(float framesPerSecond);
 
+    // Draws the frame time breakdown overlay (percentiles and graph)
+    void drawFrameTimes();
+
     // Indicates the number of times the framebuffer was initialized
     uInt32 myInitializedCount;
 
@@ -565,6 +579,10 @@ class FrameBuffer
     Message myMsg;
     Message myStatsMsg;
     bool myStatsEnabled;
+    Message myTimesMsg;
+    bool myTimesEnabled;
+    // Height (in pixels) of the frame time graph, covering two frame budgets
+    static constexpr uInt32 TIMES_GRAPH_HEIGHT = 48;
     uInt32 myLastScanlines;
 
     bool myGrabMouse;
@@ -18,6 +18,10 @@
 #ifdef DEBUGGER_SUPPORT
   #include "Debugger.hxx"
   #include "Expression.hxx"
+  #include "CompiledExpression.hxx"
+  #include "CpuTrace.hxx"
+  #include "CpuProfile.hxx"
+  #include "TrapDevice.hxx"
   #include "CartDebug.hxx"
   #include "PackedBitArray.hxx"
   #include "Base.hxx"
@@ -44,6 +48,12 @@
 #include "Vec.hxx"
 
 #include "Cart.hxx"
+#include "Cart3F.hxx"
+#include "CartE0.hxx"
+#include "CartF4.hxx"
+#include "CartF6.hxx"
+#include "CartF8.hxx"
+#include "CartFE.hxx"
 #include "TIA.hxx"
 #include "M6532.hxx"
 #include "System.hxx"
@@ -52,10 +62,16 @@
 #include "exception/EmulationWarning.hxx"
 #include "exception/FatalEmulationError.hxx"
 
+// Threaded dispatch relies on computed gotos, which are a GCC/Clang extension
+#if defined(THREADED_DISPATCH) && !defined(__GNUC__)
+  #undef THREADED_DISPATCH
+#endif
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 M6502::M6502(const Settings& settings)
   : myExecutionStatus(0),
     mySystem(nullptr),
+    myExecute(&M6502::_execute<false, Cartridge>),
     mySettings(settings),
     A(0), X(0), Y(0), SP(0), IR(0), PC(0),
     N(false), V(false), B(false), D(false), I(false), notZ(false), C(false),
@@ -81,15 +97,41 @@ M6502::M6502(const Settings& settings)
 {
 #ifdef DEBUGGER_SUPPORT
   myDebugger = nullptr;
-  myJustHitReadTrapFlag = myJustHitWriteTrapFlag = false;
+  myHitTrapInfo.address = 0;
+  myHitTrapInfo.read = false;
+  myTrapsArmed = false;
+  myInstrumented = false;
+  myRamGeneration = 0;
+  myRunUntilAddresses = nullptr;
+  myRunUntilCondition = nullptr;
+  myRunUntilMaxInstructions = myRunUntilInstructions = 0;
+  myRunUntilActive = myRunUntilDone = false;
+  myCpuTraceEnabled = myCpuProfileEnabled = false;
 #endif
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+M6502::~M6502()
+{
+  // Defined here, where the conditions of the debugger are complete types
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502::install(System& system)
 {
   // Remember which system I'm installed in
   mySystem = &system;
+
+  // Specialise the CPU core for the most common cartridge types, so that
+  // their peek() and poke() are called without virtual dispatch
+  const string& cart = system.cart().name();
+  if(cart == "CartridgeF8")      myExecute = &M6502::_execute<false, CartridgeF8>;
+  else if(cart == "CartridgeF6") myExecute = &M6502::_execute<false, CartridgeF6>;
+  else if(cart == "CartridgeF4") myExecute = &M6502::_execute<false, CartridgeF4>;
+  else if(cart == "CartridgeE0") myExecute = &M6502::_execute<false, CartridgeE0>;
+  else if(cart == "CartridgeFE") myExecute = &M6502::_execute<false, CartridgeFE>;
+  else if(cart == "Cartridge3F") myExecute = &M6502::_execute<false, Cartridge3F>;
+  else                           myExecute = &M6502::_execute<false, Cartridge>;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -126,11 +168,15 @@ void M6502::reset()
   myHaltRequested = false;
   myGhostReadsTrap = mySettings.getBool("dbg.ghostreadstrap");
   myReadFromWritePortBreak = devSettings ? mySettings.getBool("dev.rwportbreak") : false;
+#ifdef DEBUGGER_SUPPORT
+  updateInstrumentation();
+#endif
 
   myLastBreakCycle = ULLONG_MAX;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool INSTRUMENTED, class CART>
 inline uInt8 M6502::peek(uInt16 address, uInt8 flags)
 {
   handleHalt();
@@ -146,31 +192,14 @@ inline uInt8 M6502::peek(uInt16 address, uInt8 flags)
   mySystem->incrementCycles(SYSTEM_CYCLES_PER_CPU);
   icycles += SYSTEM_CYCLES_PER_CPU;
   myFlags = flags;
-  uInt8 result = mySystem->peek(address, flags);
+  uInt8 result = mySystem->peek<CART>(address, flags);
   myLastPeekAddress = address;
 
-#ifdef DEBUGGER_SUPPORT
-  if(myReadTraps.isInitialized() && myReadTraps.isSet(address)
-     && (myGhostReadsTrap || flags != DISASM_NONE))
-  {
-    myLastPeekBaseAddress = myDebugger->getBaseAddress(myLastPeekAddress, true); // mirror handling
-    int cond = evalCondTraps();
-    if(cond > -1)
-    {
-      myJustHitReadTrapFlag = true;
-      stringstream msg;
-      msg << "RTrap" << (flags == DISASM_NONE ? "G[" : "[") << Common::Base::HEX2 << cond << "]"
-        << (myTrapCondNames[cond].empty() ? ": " : "If: {" + myTrapCondNames[cond] + "} ");
-      myHitTrapInfo.message = msg.str();
-      myHitTrapInfo.address = address;
-    }
-  }
-#endif  // DEBUGGER_SUPPORT
-
   return result;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool INSTRUMENTED, class CART>
 inline void M6502::poke(uInt16 address, uInt8 value, uInt8 flags)
 {
   ////////////////////////////////////////////////
@@ -183,23 +212,12 @@ inline void M6502::poke(uInt16 address, uInt8 value, uInt8 flags)
   ////////////////////////////////////////////////
   mySystem->incrementCycles(SYSTEM_CYCLES_PER_CPU);
   icycles += SYSTEM_CYCLES_PER_CPU;
-  mySystem->poke(address, value, flags);
+  mySystem->poke<CART>(address, value, flags);
   myLastPokeAddress = address;
 
 #ifdef DEBUGGER_SUPPORT
-  if(myWriteTraps.isInitialized() && myWriteTraps.isSet(address))
-  {
-    myLastPokeBaseAddress = myDebugger->getBaseAddress(myLastPokeAddress, false); // mirror handling
-    int cond = evalCondTraps();
-    if(cond > -1)
-    {
-      myJustHitWriteTrapFlag = true;
-      stringstream msg;
-      msg << "WTrap[" << Common::Base::HEX2 << cond << "]" << (myTrapCondNames[cond].empty() ? ": " : "If: {" + myTrapCondNames[cond] + "} ");
-      myHitTrapInfo.message = msg.str();
-      myHitTrapInfo.address = address;
-    }
-  }
+  if(INSTRUMENTED && (address & 0x1280) == 0x0080)  // zero-page RAM
+    ++myRamGeneration;
 #endif  // DEBUGGER_SUPPORT
 }
 
@@ -222,7 +240,17 @@ inline void M6502::handleHalt()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502::execute(uInt64 number, DispatchResult& result)
 {
-  _execute(number, result);
+#ifdef DEBUGGER_SUPPORT
+  if(myDebugger)
+    myDebugger->updateKeyframes();
+
+  myTrapsArmed = true;
+  if(myInstrumented) _execute<true, Cartridge>(number, result);
+  else               (this->*myExecute)(number, result);
+  myTrapsArmed = false;
+#else
+  (this->*myExecute)(number, result);
+#endif
 
 #ifdef DEBUGGER_SUPPORT
   // Debugger hack: this ensures that stepping a "STA WSYNC" will actually end at the
@@ -249,9 +277,102 @@ bool M6502::execute(uInt64 number)
   return result.isSuccess();
 }
 
+#ifdef THREADED_DISPATCH
+  #pragma GCC diagnostic push
+  #pragma GCC diagnostic ignored "-Wpedantic"
+
+  // Without instrumentation, every instruction fetches the next one and
+  // jumps to its code directly; otherwise it returns to the main loop,
+  // which does the checks for the debugger
+  #define M6502_NEXT                                                     \
+    if(!INSTRUMENTED)                                                    \
+    {                                                                    \
+      currentCycles = mySystem->cycles() - previousCycles;              \
+      if(!myExecutionStatus && currentCycles < maxCycles)               \
+      {                                                                  \
+        myLastPeekAddress = myLastPokeAddress = myDataAddressForPoke = 0; \
+        icycles = 0;                                                     \
+        IR = peek(PC++, DISASM_CODE);                                    \
+        goto *ourOpcodes[IR];                                            \
+      }                                                                  \
+    }                                                                    \
+    goto M6502_done;
+#endif
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
+template<bool INSTRUMENTED, class CART>
+void M6502::_execute(uInt64 cycles, DispatchResult& result)
 {
+#ifdef THREADED_DISPATCH
+  // The code of each instruction, indexed by opcode
+  static const void* const ourOpcodes[256] = {
+    &&M6502_OP_0x00, &&M6502_OP_0x01, &&M6502_OP_invalid, &&M6502_OP_0x03,
+    &&M6502_OP_0x04, &&M6502_OP_0x05, &&M6502_OP_0x06, &&M6502_OP_0x07,
+    &&M6502_OP_0x08, &&M6502_OP_0x09, &&M6502_OP_0x0a, &&M6502_OP_0x0b,
+    &&M6502_OP_0x0c, &&M6502_OP_0x0d, &&M6502_OP_0x0e, &&M6502_OP_0x0f,
+    &&M6502_OP_0x10, &&M6502_OP_0x11, &&M6502_OP_invalid, &&M6502_OP_0x13,
+    &&M6502_OP_0x14, &&M6502_OP_0x15, &&M6502_OP_0x16, &&M6502_OP_0x17,
+    &&M6502_OP_0x18, &&M6502_OP_0x19, &&M6502_OP_0x1a, &&M6502_OP_0x1b,
+    &&M6502_OP_0x1c, &&M6502_OP_0x1d, &&M6502_OP_0x1e, &&M6502_OP_0x1f,
+    &&M6502_OP_0x20, &&M6502_OP_0x21, &&M6502_OP_invalid, &&M6502_OP_0x23,
+    &&M6502_OP_0x24, &&M6502_OP_0x25, &&M6502_OP_0x26, &&M6502_OP_0x27,
+    &&M6502_OP_0x28, &&M6502_OP_0x29, &&M6502_OP_0x2a, &&M6502_OP_0x2b,
+    &&M6502_OP_0x2c, &&M6502_OP_0x2d, &&M6502_OP_0x2e, &&M6502_OP_0x2f,
+    &&M6502_OP_0x30, &&M6502_OP_0x31, &&M6502_OP_invalid, &&M6502_OP_0x33,
+    &&M6502_OP_0x34, &&M6502_OP_0x35, &&M6502_OP_0x36, &&M6502_OP_0x37,
+    &&M6502_OP_0x38, &&M6502_OP_0x39, &&M6502_OP_0x3a, &&M6502_OP_0x3b,
+    &&M6502_OP_0x3c, &&M6502_OP_0x3d, &&M6502_OP_0x3e, &&M6502_OP_0x3f,
+    &&M6502_OP_0x40, &&M6502_OP_0x41, &&M6502_OP_invalid, &&M6502_OP_0x43,
+    &&M6502_OP_0x44, &&M6502_OP_0x45, &&M6502_OP_0x46, &&M6502_OP_0x47,
+    &&M6502_OP_0x48, &&M6502_OP_0x49, &&M6502_OP_0x4a, &&M6502_OP_0x4b,
+    &&M6502_OP_0x4c, &&M6502_OP_0x4d, &&M6502_OP_0x4e, &&M6502_OP_0x4f,
+    &&M6502_OP_0x50, &&M6502_OP_0x51, &&M6502_OP_invalid, &&M6502_OP_0x53,
+    &&M6502_OP_0x54, &&M6502_OP_0x55, &&M6502_OP_0x56, &&M6502_OP_0x57,
+    &&M6502_OP_0x58, &&M6502_OP_0x59, &&M6502_OP_0x5a, &&M6502_OP_0x5b,
+    &&M6502_OP_0x5c, &&M6502_OP_0x5d, &&M6502_OP_0x5e, &&M6502_OP_0x5f,
+    &&M6502_OP_0x60, &&M6502_OP_0x61, &&M6502_OP_invalid, &&M6502_OP_0x63,
+    &&M6502_OP_0x64, &&M6502_OP_0x65, &&M6502_OP_0x66, &&M6502_OP_0x67,
+    &&M6502_OP_0x68, &&M6502_OP_0x69, &&M6502_OP_0x6a, &&M6502_OP_0x6b,
+    &&M6502_OP_0x6c, &&M6502_OP_0x6d, &&M6502_OP_0x6e, &&M6502_OP_0x6f,
+    &&M6502_OP_0x70, &&M6502_OP_0x71, &&M6502_OP_invalid, &&M6502_OP_0x73,
+    &&M6502_OP_0x74, &&M6502_OP_0x75, &&M6502_OP_0x76, &&M6502_OP_0x77,
+    &&M6502_OP_0x78, &&M6502_OP_0x79, &&M6502_OP_0x7a, &&M6502_OP_0x7b,
+    &&M6502_OP_0x7c, &&M6502_OP_0x7d, &&M6502_OP_0x7e, &&M6502_OP_0x7f,
+    &&M6502_OP_0x80, &&M6502_OP_0x81, &&M6502_OP_0x82, &&M6502_OP_0x83,
+    &&M6502_OP_0x84, &&M6502_OP_0x85, &&M6502_OP_0x86, &&M6502_OP_0x87,
+    &&M6502_OP_0x88, &&M6502_OP_0x89, &&M6502_OP_0x8a, &&M6502_OP_0x8b,
+    &&M6502_OP_0x8c, &&M6502_OP_0x8d, &&M6502_OP_0x8e, &&M6502_OP_0x8f,
+    &&M6502_OP_0x90, &&M6502_OP_0x91, &&M6502_OP_invalid, &&M6502_OP_0x93,
+    &&M6502_OP_0x94, &&M6502_OP_0x95, &&M6502_OP_0x96, &&M6502_OP_0x97,
+    &&M6502_OP_0x98, &&M6502_OP_0x99, &&M6502_OP_0x9a, &&M6502_OP_0x9b,
+    &&M6502_OP_0x9c, &&M6502_OP_0x9d, &&M6502_OP_0x9e, &&M6502_OP_0x9f,
+    &&M6502_OP_0xa0, &&M6502_OP_0xa1, &&M6502_OP_0xa2, &&M6502_OP_0xa3,
+    &&M6502_OP_0xa4, &&M6502_OP_0xa5, &&M6502_OP_0xa6, &&M6502_OP_0xa7,
+    &&M6502_OP_0xa8, &&M6502_OP_0xa9, &&M6502_OP_0xaa, &&M6502_OP_0xab,
+    &&M6502_OP_0xac, &&M6502_OP_0xad, &&M6502_OP_0xae, &&M6502_OP_0xaf,
+    &&M6502_OP_0xb0, &&M6502_OP_0xb1, &&M6502_OP_invalid, &&M6502_OP_0xb3,
+    &&M6502_OP_0xb4, &&M6502_OP_0xb5, &&M6502_OP_0xb6, &&M6502_OP_0xb7,
+    &&M6502_OP_0xb8, &&M6502_OP_0xb9, &&M6502_OP_0xba, &&M6502_OP_0xbb,
+    &&M6502_OP_0xbc, &&M6502_OP_0xbd, &&M6502_OP_0xbe, &&M6502_OP_0xbf,
+    &&M6502_OP_0xc0, &&M6502_OP_0xc1, &&M6502_OP_0xc2, &&M6502_OP_0xc3,
+    &&M6502_OP_0xc4, &&M6502_OP_0xc5, &&M6502_OP_0xc6, &&M6502_OP_0xc7,
+    &&M6502_OP_0xc8, &&M6502_OP_0xc9, &&M6502_OP_0xca, &&M6502_OP_0xcb,
+    &&M6502_OP_0xcc, &&M6502_OP_0xcd, &&M6502_OP_0xce, &&M6502_OP_0xcf,
+    &&M6502_OP_0xd0, &&M6502_OP_0xd1, &&M6502_OP_invalid, &&M6502_OP_0xd3,
+    &&M6502_OP_0xd4, &&M6502_OP_0xd5, &&M6502_OP_0xd6, &&M6502_OP_0xd7,
+    &&M6502_OP_0xd8, &&M6502_OP_0xd9, &&M6502_OP_0xda, &&M6502_OP_0xdb,
+    &&M6502_OP_0xdc, &&M6502_OP_0xdd, &&M6502_OP_0xde, &&M6502_OP_0xdf,
+    &&M6502_OP_0xe0, &&M6502_OP_0xe1, &&M6502_OP_0xe2, &&M6502_OP_0xe3,
+    &&M6502_OP_0xe4, &&M6502_OP_0xe5, &&M6502_OP_0xe6, &&M6502_OP_0xe7,
+    &&M6502_OP_0xe8, &&M6502_OP_0xe9, &&M6502_OP_0xea, &&M6502_OP_0xeb,
+    &&M6502_OP_0xec, &&M6502_OP_0xed, &&M6502_OP_0xee, &&M6502_OP_0xef,
+    &&M6502_OP_0xf0, &&M6502_OP_0xf1, &&M6502_OP_invalid, &&M6502_OP_0xf3,
+    &&M6502_OP_0xf4, &&M6502_OP_0xf5, &&M6502_OP_0xf6, &&M6502_OP_0xf7,
+    &&M6502_OP_0xf8, &&M6502_OP_0xf9, &&M6502_OP_0xfa, &&M6502_OP_0xfb,
+    &&M6502_OP_0xfc, &&M6502_OP_0xfd, &&M6502_OP_0xfe, &&M6502_OP_0xff
+  };
+#endif
+
   myExecutionStatus = 0;
 
 #ifdef DEBUGGER_SUPPORT
@@ -259,54 +380,83 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
   M6532& riot = mySystem->m6532();
 #endif
 
+#ifdef DEBUGGER_SUPPORT
+  // The debugger may have changed RAM since the last call
+  if(INSTRUMENTED)
+    ++myRamGeneration;
+#endif
+
   uInt64 previousCycles = mySystem->cycles();
   uInt64 currentCycles = 0;
+  const uInt64 maxCycles = cycles * SYSTEM_CYCLES_PER_CPU;
 
   // Loop until execution is stopped or a fatal error occurs
   for(;;)
   {
-    while (!myExecutionStatus && currentCycles < cycles * SYSTEM_CYCLES_PER_CPU)
+    while (!myExecutionStatus && currentCycles < maxCycles)
     {
   #ifdef DEBUGGER_SUPPORT
-      // Don't break if we haven't actually executed anything yet
-      if (myLastBreakCycle != mySystem->cycles()) {
-        if(myJustHitReadTrapFlag || myJustHitWriteTrapFlag)
+      if(INSTRUMENTED)
+      {
+        if(myRunUntilActive)
         {
-          bool read = myJustHitReadTrapFlag;
-          myJustHitReadTrapFlag = myJustHitWriteTrapFlag = false;
-
-          myLastBreakCycle = mySystem->cycles();
-          result.setDebugger(currentCycles, myHitTrapInfo.message, myHitTrapInfo.address, read);
-          return;
+          if(myRunUntilInstructions > 0 &&
+             ((myRunUntilAddresses && myRunUntilAddresses->isSet(PC)) ||
+              (myRunUntilCondition && !myRunUntilCondition->evaluate(myRamGeneration)) ||
+              myRunUntilInstructions == myRunUntilMaxInstructions))
+          {
+            myRunUntilDone = true;
+            result.setOk(currentCycles);
+            return;
+          }
+          ++myRunUntilInstructions;
         }
 
-        if(myBreakPoints.isInitialized() && myBreakPoints.isSet(PC)) {
-          myLastBreakCycle = mySystem->cycles();
-          result.setDebugger(currentCycles, "BP: ", PC);
-          return;
+        // The conditions may read trapped addresses
+        myTrapsArmed = false;
+
+        // Don't break if we haven't actually executed anything yet
+        if (myLastBreakCycle != mySystem->cycles()) {
+          if(myBreakPoints.isInitialized() && myBreakPoints.isSet(PC)) {
+            myLastBreakCycle = mySystem->cycles();
+            result.setDebugger(currentCycles, "BP: ", PC);
+            return;
+          }
+
+          int cond = evalCondBreaks();
+          if(cond > -1)
+          {
+            ostringstream msg;
+            msg << "CBP[" << Common::Base::HEX2 << cond << "]: " << myCondBreakNames[cond];
+
+            myLastBreakCycle = mySystem->cycles();
+            result.setDebugger(currentCycles, msg.str());
+            return;
+          }
         }
 
-        int cond = evalCondBreaks();
+        int cond = evalCondSaveStates();
         if(cond > -1)
         {
           ostringstream msg;
-          msg << "CBP[" << Common::Base::HEX2 << cond << "]: " << myCondBreakNames[cond];
+          msg << "conditional savestate [" << Common::Base::HEX2 << cond << "]";
+          myDebugger->addState(msg.str());
+        }
 
-          myLastBreakCycle = mySystem->cycles();
-          result.setDebugger(currentCycles, msg.str());
-          return;
+        if(myCpuTraceEnabled)
+        {
+          CpuTrace::Record& r =
+            myCpuTrace->next(mySystem->cycles() / SYSTEM_CYCLES_PER_CPU);
+          r.pc = PC;
+          r.bank = mySystem->cart().getBank();
+          r.scanline = uInt16(tia.scanlines());
+          r.clock = uInt8(tia.clocksThisLine());
+          r.a = A;  r.x = X;  r.y = Y;  r.sp = SP;  r.ps = PS();
         }
-      }
 
-      int cond = evalCondSaveStates();
-      if(cond > -1)
-      {
-        ostringstream msg;
-        msg << "conditional savestate [" << Common::Base::HEX2 << cond << "]";
-        myDebugger->addState(msg.str());
+        mySystem->cart().clearAllRAMAccesses();
+        myTrapsArmed = true;
       }
-
-      mySystem->cart().clearAllRAMAccesses();
   #endif  // DEBUGGER_SUPPORT
 
       uInt16 operandAddress = 0, intermediateAddress = 0;
@@ -319,11 +469,34 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
         icycles = 0;
     #ifdef DEBUGGER_SUPPORT
         uInt16 oldPC = PC;
+        uInt64 oldCycles = mySystem->cycles();
+        uInt32 oldBank = 0;
+        if(INSTRUMENTED && myCpuProfileEnabled)
+          oldBank = (PC & 0x1000) ? mySystem->cart().getBank()
+                                  : myCpuProfile->ramBank();
     #endif
 
         // Fetch instruction at the program counter
-        IR = peek(PC++, DISASM_CODE);  // This address represents a code section
+        IR = peek<INSTRUMENTED, CART>(PC++, DISASM_CODE);  // This address represents a code section
+
+        // The instructions access memory with or without the checks for the
+        // debugger, and specialised on the cartridge type
+        #define peek peek<INSTRUMENTED, CART>
+        #define poke poke<INSTRUMENTED, CART>
+
+    #ifdef THREADED_DISPATCH
+        // Jump to the code of the instruction
+        goto *ourOpcodes[IR];
+
+        // 6502 instruction emulation is generated by an M4 macro file
+        #include "M6502Threaded.ins"
 
+      M6502_OP_invalid:
+        FatalEmulationError::raise("invalid instruction");
+
+      M6502_done:
+        ;
+    #else
         // Call code to execute the instruction
         switch(IR)
         {
@@ -333,9 +506,23 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
           default:
             FatalEmulationError::raise("invalid instruction");
         }
+    #endif
+
+        #undef peek
+        #undef poke
 
     #ifdef DEBUGGER_SUPPORT
-        if(myReadFromWritePortBreak)
+        if(INSTRUMENTED && myCpuProfileEnabled)
+        {
+          myCpuProfile->add(oldBank, oldPC, uInt32(mySystem->cycles() - oldCycles),
+                            tia.scanlines());
+
+          // Branches and jumps backwards close a loop
+          if(PC < oldPC && ((IR & 0x1f) == 0x10 || IR == 0x4c))
+            myCpuProfile->addLoop(oldBank, oldPC, PC);
+        }
+
+        if(INSTRUMENTED && myReadFromWritePortBreak)
         {
           uInt16 rwpAddr = mySystem->cart().getIllegalRAMAccess();
           if(rwpAddr)
@@ -358,7 +545,7 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
       currentCycles = (mySystem->cycles() - previousCycles);
 
   #ifdef DEBUGGER_SUPPORT
-      if(myStepStateByInstruction)
+      if(INSTRUMENTED && myStepStateByInstruction)
       {
         // Check out M6502::execute for an explanation.
         handleHalt();
@@ -369,6 +556,19 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
   #endif
     }
 
+  #ifdef DEBUGGER_SUPPORT
+    // See if the last instruction hit a trap
+    if(myExecutionStatus & TrapHitBit)
+    {
+      myExecutionStatus &= ~TrapHitBit;
+
+      myLastBreakCycle = mySystem->cycles();
+      result.setDebugger(currentCycles, myHitTrapInfo.message, myHitTrapInfo.address,
+                         myHitTrapInfo.read);
+      return;
+    }
+  #endif
+
     // See if we need to handle an interrupt
     if((myExecutionStatus & MaskableInterruptBit) ||
         (myExecutionStatus & NonmaskableInterruptBit))
@@ -394,13 +594,18 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
       return;
     }
 
-    if (currentCycles >= cycles * SYSTEM_CYCLES_PER_CPU) {
+    if (currentCycles >= maxCycles) {
       result.setOk(currentCycles);
       return;
     }
   }
 }
 
+#ifdef THREADED_DISPATCH
+  #undef M6502_NEXT
+  #pragma GCC diagnostic pop
+#endif
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502::interruptHandler()
 {
@@ -535,10 +740,20 @@ void M6502::attach(Debugger& debugger)
   myDebugger = &debugger;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 M6502::evalConds(const vector<unique_ptr<CompiledExpression>>& conds) const
+{
+  for(uInt32 i = 0; i < conds.size(); i++)
+    if(conds[i]->evaluate(myRamGeneration))
+      return i;
+
+  return -1; // no condition hit
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 M6502::addCondBreak(Expression* e, const string& name)
 {
-  myCondBreaks.emplace_back(e);
+  myCondBreaks.emplace_back(make_unique<CompiledExpression>(e));
   myCondBreakNames.push_back(name);
 
   updateStepStateByInstruction();
@@ -579,7 +794,7 @@ const StringList& M6502::getCondBreakNames() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 M6502::addCondSaveState(Expression* e, const string& name)
 {
-  myCondSaveStates.emplace_back(e);
+  myCondSaveStates.emplace_back(make_unique<CompiledExpression>(e));
   myCondSaveStateNames.push_back(name);
 
   updateStepStateByInstruction();
@@ -620,7 +835,7 @@ const StringList& M6502::getCondSaveStateNames() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 M6502::addCondTrap(Expression* e, const string& name)
 {
-  myTrapConds.emplace_back(e);
+  myTrapConds.emplace_back(make_unique<CompiledExpression>(e));
   myTrapCondNames.push_back(name);
 
   updateStepStateByInstruction();
@@ -658,10 +873,161 @@ const StringList& M6502::getCondTrapNames() const
   return myTrapCondNames;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::startRunUntil(const PackedBitArray* addresses,
+                          const CompiledExpression* condition,
+                          uInt64 maxInstructions)
+{
+  myRunUntilAddresses = addresses;
+  myRunUntilCondition = condition;
+  myRunUntilMaxInstructions = maxInstructions;
+  myRunUntilInstructions = 0;
+  myRunUntilActive = true;
+  myRunUntilDone = false;
+
+  updateStepStateByInstruction();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 M6502::stopRunUntil()
+{
+  myRunUntilAddresses = nullptr;
+  myRunUntilCondition = nullptr;
+  myRunUntilActive = false;
+
+  updateStepStateByInstruction();
+
+  return myRunUntilInstructions;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::enableCpuTrace(bool enable)
+{
+  if(enable && !myCpuTrace)
+    myCpuTrace = make_unique<CpuTrace>();
+  myCpuTraceEnabled = enable;
+
+  // The beam position is only known if the TIA is updated by instruction
+  updateStepStateByInstruction();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::enableCpuProfile(bool enable)
+{
+  if(enable && !myCpuProfile)
+    myCpuProfile = make_unique<CpuProfile>(mySystem->cart().bankCount());
+  myCpuProfileEnabled = enable;
+
+  // The scanlines are only known if the TIA is updated by instruction
+  updateStepStateByInstruction();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502::updateStepStateByInstruction()
 {
   myStepStateByInstruction = myCondBreaks.size() || myCondSaveStates.size() ||
-                             myTrapConds.size();
+                             myRunUntilActive ||
+                             myCpuTraceEnabled || myCpuProfileEnabled;
+  updateInstrumentation();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::updateInstrumentation()
+{
+  myInstrumented = myBreakPoints.isAnySet() ||
+                   myCondBreaks.size() || myCondSaveStates.size() ||
+                   myReadFromWritePortBreak ||
+                   myRunUntilActive || myCpuTraceEnabled || myCpuProfileEnabled;
+
+  updateTraps();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::updateTraps()
+{
+  static_assert(TrapArray::BLOCK_SIZE == System::PAGE_SIZE,
+                "Traps must be counted per page");
+
+  if(!mySystem)
+    return;
+
+  if(!myTrapDevice)
+  {
+    myTrapDevice = make_unique<TrapDevice>(*this);
+    myTrapDevice->install(*mySystem);
+  }
+
+  // A page is trapped if any of its mirrors in the 64K address space is
+  array<bool, System::NUM_PAGES> trapped;
+  trapped.fill(false);
+  for(uInt32 address = 0; address < 0x10000; address += System::PAGE_SIZE)
+    if(myReadTraps.isBlockSet(address) || myWriteTraps.isBlockSet(address))
+      trapped[(address & System::ADDRESS_MASK) >> System::PAGE_SHIFT] = true;
+
+  for(uInt16 page = 0; page < System::NUM_PAGES; ++page)
+    mySystem->setPageRedirect(page << System::PAGE_SHIFT,
+                              trapped[page] ? myTrapDevice.get() : nullptr);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::checkReadTrap(uInt16 address)
+{
+  // Ghost reads (the CPU discarding the value) are optionally ignored
+  if(!myTrapsArmed || !myReadTraps.isInitialized() || !myReadTraps.isSet(address) ||
+     (!myGhostReadsTrap && myFlags == DISASM_NONE))
+    return;
+
+  myLastPeekAddress = address;
+  myLastPeekBaseAddress = myDebugger->getBaseAddress(address, true); // mirror handling
+
+  int cond = evalTrap();
+  if(cond > -1)
+  {
+    stringstream msg;
+    msg << "RTrap" << (myFlags == DISASM_NONE ? "G[" : "[") << Common::Base::HEX2 << cond << "]"
+      << (myTrapCondNames[cond].empty() ? ": " : "If: {" + myTrapCondNames[cond] + "} ");
+    myHitTrapInfo.message = msg.str();
+    myHitTrapInfo.address = address;
+    myHitTrapInfo.read = true;
+    myExecutionStatus |= TrapHitBit;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::checkWriteTrap(uInt16 address)
+{
+  if(!myTrapsArmed || !myWriteTraps.isInitialized() || !myWriteTraps.isSet(address))
+    return;
+
+  myLastPokeAddress = address;
+  myLastPokeBaseAddress = myDebugger->getBaseAddress(address, false); // mirror handling
+
+  int cond = evalTrap();
+  if(cond > -1)
+  {
+    stringstream msg;
+    msg << "WTrap[" << Common::Base::HEX2 << cond << "]" << (myTrapCondNames[cond].empty() ? ": " : "If: {" + myTrapCondNames[cond] + "} ");
+    myHitTrapInfo.message = msg.str();
+    myHitTrapInfo.address = address;
+    myHitTrapInfo.read = false;
+    myExecutionStatus |= TrapHitBit;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 M6502::evalTrap()
+{
+  // The conditions may depend on the hardware state and on RAM, which
+  // the fast variant of the CPU core doesn't keep up to date
+  mySystem->tia().updateEmulation();
+  mySystem->m6532().updateEmulation();
+  ++myRamGeneration;
+
+  // The conditions may read trapped addresses themselves
+  myTrapsArmed = false;
+  Int32 cond = evalCondTraps();
+  myTrapsArmed = true;
+
+  return cond;
 }
 #endif  // DEBUGGER_SUPPORT
@@ -27,6 +27,10 @@ class DispatchResult;
 #ifdef DEBUGGER_SUPPORT
   class Debugger;
   class CpuDebug;
+  class CompiledExpression;
+  class CpuTrace;
+  class CpuProfile;
+  class TrapDevice;
 
   #include "Expression.hxx"
   #include "PackedBitArray.hxx"
@@ -63,12 +67,13 @@ class M6502 : public Serializable
       Create a new 6502 microprocessor.
     */
     explicit M6502(const Settings& settings);
-    virtual ~M6502() = default;
+    virtual ~M6502();
 
   public:
     /**
       Install the processor in the specified system.  Invoked by the
-      system when the processor is attached to it.
+      system when the processor is attached to it.  The fast variant of
+      the CPU core is selected for the type of the system's cartridge.
 
       @param system The system the processor should install itself in
     */
@@ -234,8 +239,93 @@ class M6502 : public Serializable
     void clearCondTraps();
     const StringList& getCondTrapNames() const;
 
+    /**
+      Check whether the given address is trapped for reads resp. writes,
+      and whether the conditions of the traps are met.  If so, execution
+      stops after the current instruction.  Called by the trap device for
+      all accesses to the pages containing traps (see updateTraps()), so
+      only accesses by the CPU while executing are considered.
+
+      @param address  The address accessed
+    */
+    void checkReadTrap(uInt16 address);
+    void checkWriteTrap(uInt16 address);
+
+    /**
+      Let execute() stop before the next instruction as soon as the PC is
+      one of the given addresses, the given condition is false, or the
+      given number of instructions has been executed.  At least one
+      instruction is executed.  The checks are done inside the CPU loop,
+      so that 'stepwhile', 'runto' and 'runtopc' run at full speed.
+
+      @param addresses        The addresses to stop at, or nullptr
+      @param condition        The condition to run while, or nullptr
+      @param maxInstructions  The maximum number of instructions to
+                              execute, or 0 for no limit
+    */
+    void startRunUntil(const PackedBitArray* addresses,
+                       const CompiledExpression* condition,
+                       uInt64 maxInstructions);
+
+    /**
+      Stop checking the conditions given to startRunUntil().
+
+      @return  The number of instructions executed since then
+    */
+    uInt64 stopRunUntil();
+
+    /**
+      Answer whether one of the conditions given to startRunUntil() was met.
+    */
+    bool runUntilDone() const { return myRunUntilDone; }
+
+    /**
+      Start or stop recording every executed instruction into the CPU
+      trace.  The recorded instructions are kept while recording is
+      stopped, so that they can still be saved.
+    */
+    void enableCpuTrace(bool enable);
+    bool cpuTraceEnabled() const { return myCpuTraceEnabled; }
+
+    /**
+      Answer the CPU trace, or nullptr if it was never enabled.
+    */
+    const CpuTrace* cpuTrace() const { return myCpuTrace.get(); }
+
+    /**
+      Start or stop counting the executions and cycles of every instruction
+      in the CPU profile.  The counts are kept while profiling is stopped.
+    */
+    void enableCpuProfile(bool enable);
+    bool cpuProfileEnabled() const { return myCpuProfileEnabled; }
+
+    /**
+      Answer the CPU profile, or nullptr if it was never enabled.
+    */
+    CpuProfile* cpuProfile() const { return myCpuProfile.get(); }
+
+    /**
+      Set the cycle of the last stop at a breakpoint or condition; the CPU
+      doesn't stop again at the same cycle.  ULLONG_MAX allows a stop at
+      any cycle.
+    */
+    void setLastBreakCycle(uInt64 cycles) { myLastBreakCycle = cycles; }
+
     void setGhostReadsTrap(bool enable) { myGhostReadsTrap = enable; }
-    void setReadFromWritePortBreak(bool enable) { myReadFromWritePortBreak = enable; }
+    void setReadFromWritePortBreak(bool enable) {
+      myReadFromWritePortBreak = enable;
+      updateInstrumentation();
+    }
+
+    /**
+      Check whether any breakpoints, conditional saves, RWP detection,
+      run-until conditions, the CPU trace or the CPU profile are armed,
+      and select the instrumented or the fast variant of the CPU core
+      accordingly.  Also redirects the pages containing traps (see
+      updateTraps()).  Must be called whenever one of these is armed or
+      disarmed.
+    */
+    void updateInstrumentation();
 #endif  // DEBUGGER_SUPPORT
 
   private:
@@ -251,7 +341,7 @@ class M6502 : public Serializable
 
       @return The byte at the specified address
     */
-    uInt8 peek(uInt16 address, uInt8 flags);
+    template<bool INSTRUMENTED, class CART> uInt8 peek(uInt16 address, uInt8 flags);
 
     /**
       Change the byte at the specified address to the given value and
@@ -260,7 +350,7 @@ class M6502 : public Serializable
       @param address  The address where the value should be stored
       @param value    The value to be stored at the address
     */
-    void poke(uInt16 address, uInt8 value, uInt8 flags = 0);
+    template<bool INSTRUMENTED, class CART> void poke(uInt16 address, uInt8 value, uInt8 flags = 0);
 
     /**
       Get the 8-bit value of the Processor Status register.
@@ -309,8 +399,12 @@ class M6502 : public Serializable
     /**
       This is the actual dispatch function that does the grunt work. M6502::execute
       wraps it and makes sure that any pending halt is processed before returning.
+
+      Only the instrumented variant checks for breakpoints, traps, conditional
+      saves and RWP (see updateInstrumentation()).  The fast variant can be
+      specialised on the type of the cartridge (see install()).
     */
-    void _execute(uInt64 cycles, DispatchResult& result);
+    template<bool INSTRUMENTED, class CART> void _execute(uInt64 cycles, DispatchResult& result);
 
 #ifdef DEBUGGER_SUPPORT
     /**
@@ -318,25 +412,39 @@ class M6502 : public Serializable
       with the CPU and update the flag accordingly.
     */
     void updateStepStateByInstruction();
+
+    /**
+      Redirect the pages of the system which contain read or write traps
+      (or any of their mirrors) to the trap device, and restore all other
+      pages.  The traps are checked on these pages only, by both variants
+      of the CPU core.
+    */
+    void updateTraps();
 #endif  // DEBUGGER_SUPPORT
 
   private:
     /**
       Bit fields used to indicate that certain conditions need to be
       handled such as stopping execution, fatal errors, maskable interrupts
-      and non-maskable interrupts (in myExecutionStatus)
+      and non-maskable interrupts (in myExecutionStatus); a hit trap stops
+      execution after the current instruction
     */
     static constexpr uInt8
       StopExecutionBit        = 0x01,
       FatalErrorBit           = 0x02,
       MaskableInterruptBit    = 0x04,
-      NonmaskableInterruptBit = 0x08
+      NonmaskableInterruptBit = 0x08,
+      TrapHitBit              = 0x10
     ;
     uInt8 myExecutionStatus;
 
     /// Pointer to the system the processor is installed in or the null pointer
     System* mySystem;
 
+    /// The fast variant of _execute(), specialised on the cartridge type
+    using ExecuteMethod = void (M6502::*)(uInt64, DispatchResult&);
+    ExecuteMethod myExecute;
+
     /// Reference to the settings
     const Settings& mySettings;
 
@@ -396,31 +504,21 @@ class M6502 : public Serializable
     bool myHaltRequested;
 
 #ifdef DEBUGGER_SUPPORT
-    Int32 evalCondBreaks() {
-      for(uInt32 i = 0; i < myCondBreaks.size(); i++)
-        if(myCondBreaks[i]->evaluate())
-          return i;
-
-      return -1; // no break hit
-    }
-
-    Int32 evalCondSaveStates()
-    {
-      for(uInt32 i = 0; i < myCondSaveStates.size(); i++)
-        if(myCondSaveStates[i]->evaluate())
-          return i;
-
-      return -1; // no save state point hit
-    }
+    /**
+      Evaluate the given conditions, and return the index of the first one
+      which is true, or -1 if none is.
+    */
+    Int32 evalConds(const vector<unique_ptr<CompiledExpression>>& conds) const;
 
-    Int32 evalCondTraps()
-    {
-      for(uInt32 i = 0; i < myTrapConds.size(); i++)
-        if(myTrapConds[i]->evaluate())
-          return i;
+    Int32 evalCondBreaks() const { return evalConds(myCondBreaks); }
+    Int32 evalCondSaveStates() const { return evalConds(myCondSaveStates); }
+    Int32 evalCondTraps() const { return evalConds(myTrapConds); }
 
-      return -1; // no trapif hit
-    }
+    /**
+      Bring the hardware up to date for the trap conditions (which are
+      evaluated in the middle of an instruction), and evaluate them.
+    */
+    Int32 evalTrap();
 
     /// Pointer to the debugger for this processor or the null pointer
     Debugger* myDebugger;
@@ -429,21 +527,51 @@ class M6502 : public Serializable
     PackedBitArray myBreakPoints;// , myReadTraps, myWriteTraps, myReadTrapIfs, myWriteTrapIfs;
     TrapArray myReadTraps, myWriteTraps;
 
-    // Did we just now hit a trap?
-    bool myJustHitReadTrapFlag;
-    bool myJustHitWriteTrapFlag;
+    // The trap just hit (see TrapHitBit)
     struct HitTrapInfo {
       string message;
       int address;
+      bool read;
     };
     HitTrapInfo myHitTrapInfo;
 
-    vector<unique_ptr<Expression>> myCondBreaks;
+    // The pages containing traps are redirected to this device
+    unique_ptr<TrapDevice> myTrapDevice;
+
+    // Whether accesses to trapped addresses are checked; only true while
+    // the CPU is executing, not when the debugger accesses the memory
+    bool myTrapsArmed;
+
+    vector<unique_ptr<CompiledExpression>> myCondBreaks;
     StringList myCondBreakNames;
-    vector<unique_ptr<Expression>> myCondSaveStates;
+    vector<unique_ptr<CompiledExpression>> myCondSaveStates;
     StringList myCondSaveStateNames;
-    vector<unique_ptr<Expression>> myTrapConds;
+    vector<unique_ptr<CompiledExpression>> myTrapConds;
     StringList myTrapCondNames;
+
+    // Changes whenever the CPU writes to zero-page RAM, and whenever the
+    // debugger might have modified the machine; conditions which only
+    // depend on RAM are not re-evaluated while it stays the same
+    uInt64 myRamGeneration;
+
+    // The conditions for 'stepwhile', 'runto' and 'runtopc' (see startRunUntil())
+    const PackedBitArray* myRunUntilAddresses;
+    const CompiledExpression* myRunUntilCondition;
+    uInt64 myRunUntilMaxInstructions;
+    uInt64 myRunUntilInstructions;
+    bool myRunUntilActive;
+    bool myRunUntilDone;
+
+    // The most recently executed instructions (see enableCpuTrace())
+    unique_ptr<CpuTrace> myCpuTrace;
+    bool myCpuTraceEnabled;
+
+    // The instruction counts and cycles (see enableCpuProfile())
+    unique_ptr<CpuProfile> myCpuProfile;
+    bool myCpuProfileEnabled;
+
+    // Whether the instrumented variant of the CPU core is used
+    bool myInstrumented;
 #endif  // DEBUGGER_SUPPORT
 
     bool myGhostReadsTrap;          // trap on ghost reads
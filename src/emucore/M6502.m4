@@ -20,6 +20,12 @@
 
   Recompile with the following:
     'm4 M6502.m4 > M6502.ins'
+    'm4 -DM6502_THREADED M6502.m4 > M6502Threaded.ins'
+
+  The first variant consists of the cases of a switch statement.  The
+  second one is used for threaded dispatch (see THREADED_DISPATCH in
+  M6502.cxx): each instruction starts with a label M6502_OP_<opcode>, and
+  ends with M6502_NEXT, which fetches the next instruction and jumps to it.
 
   @author  Bradford W. Mott and Stephen Anthony
 */
@@ -52,6 +58,9 @@
   #endif
 #endif
 
+ifdef(`M6502_THREADED',
+`define(M6502_OPCODE, `M6502_OP_$1:')define(M6502_END, `M6502_NEXT')',
+`define(M6502_OPCODE, `case $1:')define(M6502_END, `break;')')dnl
 
 define(M6502_IMPLIED, `{
   peek(PC, DISASM_NONE);
@@ -1009,1333 +1018,1333 @@ define(M6502_TYA, `{
 
 //////////////////////////////////////////////////
 // ADC
-case 0x69:
+M6502_OPCODE(0x69)
 M6502_IMMEDIATE_READ
 M6502_ADC
-break;
+M6502_END
 
-case 0x65:
+M6502_OPCODE(0x65)
 M6502_ZERO_READ
 M6502_ADC
-break;
+M6502_END
 
-case 0x75:
+M6502_OPCODE(0x75)
 M6502_ZEROX_READ
 M6502_ADC
-break;
+M6502_END
 
-case 0x6d:
+M6502_OPCODE(0x6d)
 M6502_ABSOLUTE_READ
 M6502_ADC
-break;
+M6502_END
 
-case 0x7d:
+M6502_OPCODE(0x7d)
 M6502_ABSOLUTEX_READ
 M6502_ADC
-break;
+M6502_END
 
-case 0x79:
+M6502_OPCODE(0x79)
 M6502_ABSOLUTEY_READ
 M6502_ADC
-break;
+M6502_END
 
-case 0x61:
+M6502_OPCODE(0x61)
 M6502_INDIRECTX_READ
 M6502_ADC
-break;
+M6502_END
 
-case 0x71:
+M6502_OPCODE(0x71)
 M6502_INDIRECTY_READ
 M6502_ADC
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // ASR
-case 0x4b:
+M6502_OPCODE(0x4b)
 M6502_IMMEDIATE_READ
 M6502_ASR
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // ANC
-case 0x0b:
-case 0x2b:
+M6502_OPCODE(0x0b)
+M6502_OPCODE(0x2b)
 M6502_IMMEDIATE_READ
 M6502_ANC
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // AND
-case 0x29:
+M6502_OPCODE(0x29)
 M6502_IMMEDIATE_READ
 M6502_AND
-break;
+M6502_END
 
-case 0x25:
+M6502_OPCODE(0x25)
 M6502_ZERO_READ
 M6502_AND
-break;
+M6502_END
 
-case 0x35:
+M6502_OPCODE(0x35)
 M6502_ZEROX_READ
 M6502_AND
-break;
+M6502_END
 
-case 0x2d:
+M6502_OPCODE(0x2d)
 M6502_ABSOLUTE_READ
 M6502_AND
-break;
+M6502_END
 
-case 0x3d:
+M6502_OPCODE(0x3d)
 M6502_ABSOLUTEX_READ
 M6502_AND
-break;
+M6502_END
 
-case 0x39:
+M6502_OPCODE(0x39)
 M6502_ABSOLUTEY_READ
 M6502_AND
-break;
+M6502_END
 
-case 0x21:
+M6502_OPCODE(0x21)
 M6502_INDIRECTX_READ
 M6502_AND
-break;
+M6502_END
 
-case 0x31:
+M6502_OPCODE(0x31)
 M6502_INDIRECTY_READ
 M6502_AND
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // ANE
-case 0x8b:
+M6502_OPCODE(0x8b)
 M6502_IMMEDIATE_READ
 M6502_ANE
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // ARR
-case 0x6b:
+M6502_OPCODE(0x6b)
 M6502_IMMEDIATE_READ
 M6502_ARR
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // ASL
-case 0x0a:
+M6502_OPCODE(0x0a)
 M6502_IMPLIED
 M6502_ASLA
-break;
+M6502_END
 
-case 0x06:
+M6502_OPCODE(0x06)
 M6502_ZERO_READMODIFYWRITE
 M6502_ASL
-break;
+M6502_END
 
-case 0x16:
+M6502_OPCODE(0x16)
 M6502_ZEROX_READMODIFYWRITE
 M6502_ASL
-break;
+M6502_END
 
-case 0x0e:
+M6502_OPCODE(0x0e)
 M6502_ABSOLUTE_READMODIFYWRITE
 M6502_ASL
-break;
+M6502_END
 
-case 0x1e:
+M6502_OPCODE(0x1e)
 M6502_ABSOLUTEX_READMODIFYWRITE
 M6502_ASL
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // BIT
-case 0x24:
+M6502_OPCODE(0x24)
 M6502_ZERO_READ
 M6502_BIT
-break;
+M6502_END
 
-case 0x2C:
+M6502_OPCODE(0x2c)
 M6502_ABSOLUTE_READ
 M6502_BIT
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // Branches
-case 0x90:
+M6502_OPCODE(0x90)
 M6502_IMMEDIATE_READ
 M6502_BCC
-break;
+M6502_END
 
 
-case 0xb0:
+M6502_OPCODE(0xb0)
 M6502_IMMEDIATE_READ
 M6502_BCS
-break;
+M6502_END
 
 
-case 0xf0:
+M6502_OPCODE(0xf0)
 M6502_IMMEDIATE_READ
 M6502_BEQ
-break;
+M6502_END
 
 
-case 0x30:
+M6502_OPCODE(0x30)
 M6502_IMMEDIATE_READ
 M6502_BMI
-break;
+M6502_END
 
 
-case 0xD0:
+M6502_OPCODE(0xd0)
 M6502_IMMEDIATE_READ
 M6502_BNE
-break;
+M6502_END
 
 
-case 0x10:
+M6502_OPCODE(0x10)
 M6502_IMMEDIATE_READ
 M6502_BPL
-break;
+M6502_END
 
 
-case 0x50:
+M6502_OPCODE(0x50)
 M6502_IMMEDIATE_READ
 M6502_BVC
-break;
+M6502_END
 
 
-case 0x70:
+M6502_OPCODE(0x70)
 M6502_IMMEDIATE_READ
 M6502_BVS
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // BRK
-case 0x00:
+M6502_OPCODE(0x00)
 M6502_BRK
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // CLC
-case 0x18:
+M6502_OPCODE(0x18)
 M6502_IMPLIED
 M6502_CLC
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // CLD
-case 0xd8:
+M6502_OPCODE(0xd8)
 M6502_IMPLIED
 M6502_CLD
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // CLI
-case 0x58:
+M6502_OPCODE(0x58)
 M6502_IMPLIED
 M6502_CLI
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // CLV
-case 0xb8:
+M6502_OPCODE(0xb8)
 M6502_IMPLIED
 M6502_CLV
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // CMP
-case 0xc9:
+M6502_OPCODE(0xc9)
 M6502_IMMEDIATE_READ
 M6502_CMP
-break;
+M6502_END
 
-case 0xc5:
+M6502_OPCODE(0xc5)
 M6502_ZERO_READ
 M6502_CMP
-break;
+M6502_END
 
-case 0xd5:
+M6502_OPCODE(0xd5)
 M6502_ZEROX_READ
 M6502_CMP
-break;
+M6502_END
 
-case 0xcd:
+M6502_OPCODE(0xcd)
 M6502_ABSOLUTE_READ
 M6502_CMP
-break;
+M6502_END
 
-case 0xdd:
+M6502_OPCODE(0xdd)
 M6502_ABSOLUTEX_READ
 M6502_CMP
-break;
+M6502_END
 
-case 0xd9:
+M6502_OPCODE(0xd9)
 M6502_ABSOLUTEY_READ
 M6502_CMP
-break;
+M6502_END
 
-case 0xc1:
+M6502_OPCODE(0xc1)
 M6502_INDIRECTX_READ
 M6502_CMP
-break;
+M6502_END
 
-case 0xd1:
+M6502_OPCODE(0xd1)
 M6502_INDIRECTY_READ
 M6502_CMP
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // CPX
-case 0xe0:
+M6502_OPCODE(0xe0)
 M6502_IMMEDIATE_READ
 M6502_CPX
-break;
+M6502_END
 
-case 0xe4:
+M6502_OPCODE(0xe4)
 M6502_ZERO_READ
 M6502_CPX
-break;
+M6502_END
 
-case 0xec:
+M6502_OPCODE(0xec)
 M6502_ABSOLUTE_READ
 M6502_CPX
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // CPY
-case 0xc0:
+M6502_OPCODE(0xc0)
 M6502_IMMEDIATE_READ
 M6502_CPY
-break;
+M6502_END
 
-case 0xc4:
+M6502_OPCODE(0xc4)
 M6502_ZERO_READ
 M6502_CPY
-break;
+M6502_END
 
-case 0xcc:
+M6502_OPCODE(0xcc)
 M6502_ABSOLUTE_READ
 M6502_CPY
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // DCP
-case 0xcf:
+M6502_OPCODE(0xcf)
 M6502_ABSOLUTE_READMODIFYWRITE
 M6502_DCP
-break;
+M6502_END
 
-case 0xdf:
+M6502_OPCODE(0xdf)
 M6502_ABSOLUTEX_READMODIFYWRITE
 M6502_DCP
-break;
+M6502_END
 
-case 0xdb:
+M6502_OPCODE(0xdb)
 M6502_ABSOLUTEY_READMODIFYWRITE
 M6502_DCP
-break;
+M6502_END
 
-case 0xc7:
+M6502_OPCODE(0xc7)
 M6502_ZERO_READMODIFYWRITE
 M6502_DCP
-break;
+M6502_END
 
-case 0xd7:
+M6502_OPCODE(0xd7)
 M6502_ZEROX_READMODIFYWRITE
 M6502_DCP
-break;
+M6502_END
 
-case 0xc3:
+M6502_OPCODE(0xc3)
 M6502_INDIRECTX_READMODIFYWRITE
 M6502_DCP
-break;
+M6502_END
 
-case 0xd3:
+M6502_OPCODE(0xd3)
 M6502_INDIRECTY_READMODIFYWRITE
 M6502_DCP
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // DEC
-case 0xc6:
+M6502_OPCODE(0xc6)
 M6502_ZERO_READMODIFYWRITE
 M6502_DEC
-break;
+M6502_END
 
-case 0xd6:
+M6502_OPCODE(0xd6)
 M6502_ZEROX_READMODIFYWRITE
 M6502_DEC
-break;
+M6502_END
 
-case 0xce:
+M6502_OPCODE(0xce)
 M6502_ABSOLUTE_READMODIFYWRITE
 M6502_DEC
-break;
+M6502_END
 
-case 0xde:
+M6502_OPCODE(0xde)
 M6502_ABSOLUTEX_READMODIFYWRITE
 M6502_DEC
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // DEX
-case 0xca:
+M6502_OPCODE(0xca)
 M6502_IMPLIED
 M6502_DEX
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // DEY
-case 0x88:
+M6502_OPCODE(0x88)
 M6502_IMPLIED
 M6502_DEY
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // EOR
-case 0x49:
+M6502_OPCODE(0x49)
 M6502_IMMEDIATE_READ
 M6502_EOR
-break;
+M6502_END
 
-case 0x45:
+M6502_OPCODE(0x45)
 M6502_ZERO_READ
 M6502_EOR
-break;
+M6502_END
 
-case 0x55:
+M6502_OPCODE(0x55)
 M6502_ZEROX_READ
 M6502_EOR
-break;
+M6502_END
 
-case 0x4d:
+M6502_OPCODE(0x4d)
 M6502_ABSOLUTE_READ
 M6502_EOR
-break;
+M6502_END
 
-case 0x5d:
+M6502_OPCODE(0x5d)
 M6502_ABSOLUTEX_READ
 M6502_EOR
-break;
+M6502_END
 
-case 0x59:
+M6502_OPCODE(0x59)
 M6502_ABSOLUTEY_READ
 M6502_EOR
-break;
+M6502_END
 
-case 0x41:
+M6502_OPCODE(0x41)
 M6502_INDIRECTX_READ
 M6502_EOR
-break;
+M6502_END
 
-case 0x51:
+M6502_OPCODE(0x51)
 M6502_INDIRECTY_READ
 M6502_EOR
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // INC
-case 0xe6:
+M6502_OPCODE(0xe6)
 M6502_ZERO_READMODIFYWRITE
 M6502_INC
-break;
+M6502_END
 
-case 0xf6:
+M6502_OPCODE(0xf6)
 M6502_ZEROX_READMODIFYWRITE
 M6502_INC
-break;
+M6502_END
 
-case 0xee:
+M6502_OPCODE(0xee)
 M6502_ABSOLUTE_READMODIFYWRITE
 M6502_INC
-break;
+M6502_END
 
-case 0xfe:
+M6502_OPCODE(0xfe)
 M6502_ABSOLUTEX_READMODIFYWRITE
 M6502_INC
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // INX
-case 0xe8:
+M6502_OPCODE(0xe8)
 M6502_IMPLIED
 M6502_INX
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // INY
-case 0xc8:
+M6502_OPCODE(0xc8)
 M6502_IMPLIED
 M6502_INY
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // ISB
-case 0xef:
+M6502_OPCODE(0xef)
 M6502_ABSOLUTE_READMODIFYWRITE
 M6502_ISB
-break;
+M6502_END
 
-case 0xff:
+M6502_OPCODE(0xff)
 M6502_ABSOLUTEX_READMODIFYWRITE
 M6502_ISB
-break;
+M6502_END
 
-case 0xfb:
+M6502_OPCODE(0xfb)
 M6502_ABSOLUTEY_READMODIFYWRITE
 M6502_ISB
-break;
+M6502_END
 
-case 0xe7:
+M6502_OPCODE(0xe7)
 M6502_ZERO_READMODIFYWRITE
 M6502_ISB
-break;
+M6502_END
 
-case 0xf7:
+M6502_OPCODE(0xf7)
 M6502_ZEROX_READMODIFYWRITE
 M6502_ISB
-break;
+M6502_END
 
-case 0xe3:
+M6502_OPCODE(0xe3)
 M6502_INDIRECTX_READMODIFYWRITE
 M6502_ISB
-break;
+M6502_END
 
-case 0xf3:
+M6502_OPCODE(0xf3)
 M6502_INDIRECTY_READMODIFYWRITE
 M6502_ISB
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // JMP
-case 0x4c:
+M6502_OPCODE(0x4c)
 M6502_ABSOLUTE_WRITE
 M6502_JMP
-break;
+M6502_END
 
-case 0x6c:
+M6502_OPCODE(0x6c)
 M6502_INDIRECT
 M6502_JMP
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // JSR
-case 0x20:
+M6502_OPCODE(0x20)
 M6502_JSR
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // LAS
-case 0xbb:
+M6502_OPCODE(0xbb)
 M6502_ABSOLUTEY_READ
 M6502_LAS
-break;
+M6502_END
 
 
 //////////////////////////////////////////////////
 // LAX
-case 0xaf:
+M6502_OPCODE(0xaf)
 M6502_ABSOLUTE_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 SET_LAST_PEEK(myLastSrcAddressX, intermediateAddress)
 M6502_LAX
-break;
+M6502_END
 
-case 0xbf:
+M6502_OPCODE(0xbf)
 M6502_ABSOLUTEY_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 SET_LAST_PEEK(myLastSrcAddressX, intermediateAddress)
 M6502_LAX
-break;
+M6502_END
 
-case 0xa7:
+M6502_OPCODE(0xa7)
 M6502_ZERO_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 SET_LAST_PEEK(myLastSrcAddressX, intermediateAddress)
 M6502_LAX
-break;
+M6502_END
 
-case 0xb7:
+M6502_OPCODE(0xb7)
 M6502_ZEROY_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)  // TODO - check this
 SET_LAST_PEEK(myLastSrcAddressX, intermediateAddress)
 M6502_LAX
-break;
+M6502_END
 
-case 0xa3:
+M6502_OPCODE(0xa3)
 M6502_INDIRECTX_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 SET_LAST_PEEK(myLastSrcAddressX, intermediateAddress)  // TODO - check this
 M6502_LAX
-break;
+M6502_END
 
-case 0xb3:
+M6502_OPCODE(0xb3)
 M6502_INDIRECTY_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 SET_LAST_PEEK(myLastSrcAddressX, intermediateAddress)  // TODO - check this
 M6502_LAX
-break;
+M6502_END
 //////////////////////////////////////////////////
 
 
 //////////////////////////////////////////////////
 // LDA
-case 0xa9:
+M6502_OPCODE(0xa9)
 M6502_IMMEDIATE_READ
 CLEAR_LAST_PEEK(myLastSrcAddressA)
 M6502_LDA
-break;
+M6502_END
 
-case 0xa5:
+M6502_OPCODE(0xa5)
 M6502_ZERO_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_LDA
-break;
+M6502_END
 
-case 0xb5:
+M6502_OPCODE(0xb5)
 M6502_ZEROX_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_LDA
-break;
+M6502_END
 
-case 0xad:
+M6502_OPCODE(0xad)
 M6502_ABSOLUTE_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_LDA
-break;
+M6502_END
 
-case 0xbd:
+M6502_OPCODE(0xbd)
 M6502_ABSOLUTEX_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_LDA
-break;
+M6502_END
 
-case 0xb9:
+M6502_OPCODE(0xb9)
 M6502_ABSOLUTEY_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_LDA
-break;
+M6502_END
 
-case 0xa1:
+M6502_OPCODE(0xa1)
 M6502_INDIRECTX_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_LDA
-break;
+M6502_END
 
-case 0xb1:
+M6502_OPCODE(0xb1)
 M6502_INDIRECTY_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_LDA
-break;
+M6502_END
 //////////////////////////////////////////////////
 
 
 //////////////////////////////////////////////////
 // LDX
-case 0xa2:
+M6502_OPCODE(0xa2)
 M6502_IMMEDIATE_READ
 CLEAR_LAST_PEEK(myLastSrcAddressX)
 M6502_LDX
-break;
+M6502_END
 
-case 0xa6:
+M6502_OPCODE(0xa6)
 M6502_ZERO_READ
 SET_LAST_PEEK(myLastSrcAddressX, intermediateAddress)
 M6502_LDX
-break;
+M6502_END
 
-case 0xb6:
+M6502_OPCODE(0xb6)
 M6502_ZEROY_READ
 SET_LAST_PEEK(myLastSrcAddressX, intermediateAddress)
 M6502_LDX
-break;
+M6502_END
 
-case 0xae:
+M6502_OPCODE(0xae)
 M6502_ABSOLUTE_READ
 SET_LAST_PEEK(myLastSrcAddressX, intermediateAddress)
 M6502_LDX
-break;
+M6502_END
 
-case 0xbe:
+M6502_OPCODE(0xbe)
 M6502_ABSOLUTEY_READ
 SET_LAST_PEEK(myLastSrcAddressX, intermediateAddress)
 M6502_LDX
-break;
+M6502_END
 //////////////////////////////////////////////////
 
 
 //////////////////////////////////////////////////
 // LDY
-case 0xa0:
+M6502_OPCODE(0xa0)
 M6502_IMMEDIATE_READ
 CLEAR_LAST_PEEK(myLastSrcAddressY)
 M6502_LDY
-break;
+M6502_END
 
-case 0xa4:
+M6502_OPCODE(0xa4)
 M6502_ZERO_READ
 SET_LAST_PEEK(myLastSrcAddressY, intermediateAddress)
 M6502_LDY
-break;
+M6502_END
 
-case 0xb4:
+M6502_OPCODE(0xb4)
 M6502_ZEROX_READ
 SET_LAST_PEEK(myLastSrcAddressY, intermediateAddress)
 M6502_LDY
-break;
+M6502_END
 
-case 0xac:
+M6502_OPCODE(0xac)
 M6502_ABSOLUTE_READ
 SET_LAST_PEEK(myLastSrcAddressY, intermediateAddress)
 M6502_LDY
-break;
+M6502_END
 
-case 0xbc:
+M6502_OPCODE(0xbc)
 M6502_ABSOLUTEX_READ
 SET_LAST_PEEK(myLastSrcAddressY, intermediateAddress)
 M6502_LDY
-break;
+M6502_END
 //////////////////////////////////////////////////
 
 //////////////////////////////////////////////////
 // LSR
-case 0x4a:
+M6502_OPCODE(0x4a)
 M6502_IMPLIED
 M6502_LSRA
-break;
+M6502_END
 
 
-case 0x46:
+M6502_OPCODE(0x46)
 M6502_ZERO_READMODIFYWRITE
 M6502_LSR
-break;
+M6502_END
 
-case 0x56:
+M6502_OPCODE(0x56)
 M6502_ZEROX_READMODIFYWRITE
 M6502_LSR
-break;
+M6502_END
 
-case 0x4e:
+M6502_OPCODE(0x4e)
 M6502_ABSOLUTE_READMODIFYWRITE
 M6502_LSR
-break;
+M6502_END
 
-case 0x5e:
+M6502_OPCODE(0x5e)
 M6502_ABSOLUTEX_READMODIFYWRITE
 M6502_LSR
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // LXA
-case 0xab:
+M6502_OPCODE(0xab)
 M6502_IMMEDIATE_READ
 M6502_LXA
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // NOP
-case 0x1a:
-case 0x3a:
-case 0x5a:
-case 0x7a:
-case 0xda:
-case 0xea:
-case 0xfa:
+M6502_OPCODE(0x1a)
+M6502_OPCODE(0x3a)
+M6502_OPCODE(0x5a)
+M6502_OPCODE(0x7a)
+M6502_OPCODE(0xda)
+M6502_OPCODE(0xea)
+M6502_OPCODE(0xfa)
 M6502_IMPLIED
 M6502_NOP
-break;
+M6502_END
 
-case 0x80:
-case 0x82:
-case 0x89:
-case 0xc2:
-case 0xe2:
+M6502_OPCODE(0x80)
+M6502_OPCODE(0x82)
+M6502_OPCODE(0x89)
+M6502_OPCODE(0xc2)
+M6502_OPCODE(0xe2)
 M6502_IMMEDIATE_READ
 M6502_NOP
-break;
+M6502_END
 
-case 0x04:
-case 0x44:
-case 0x64:
+M6502_OPCODE(0x04)
+M6502_OPCODE(0x44)
+M6502_OPCODE(0x64)
 M6502_ZERO_READ
 M6502_NOP
-break;
-
-case 0x14:
-case 0x34:
-case 0x54:
-case 0x74:
-case 0xd4:
-case 0xf4:
+M6502_END
+
+M6502_OPCODE(0x14)
+M6502_OPCODE(0x34)
+M6502_OPCODE(0x54)
+M6502_OPCODE(0x74)
+M6502_OPCODE(0xd4)
+M6502_OPCODE(0xf4)
 M6502_ZEROX_READ
 M6502_NOP
-break;
+M6502_END
 
-case 0x0c:
+M6502_OPCODE(0x0c)
 M6502_ABSOLUTE_READ
 M6502_NOP
-break;
-
-case 0x1c:
-case 0x3c:
-case 0x5c:
-case 0x7c:
-case 0xdc:
-case 0xfc:
+M6502_END
+
+M6502_OPCODE(0x1c)
+M6502_OPCODE(0x3c)
+M6502_OPCODE(0x5c)
+M6502_OPCODE(0x7c)
+M6502_OPCODE(0xdc)
+M6502_OPCODE(0xfc)
 M6502_ABSOLUTEX_READ
 M6502_NOP
-break;
+M6502_END
 
 
 //////////////////////////////////////////////////
 // ORA
-case 0x09:
+M6502_OPCODE(0x09)
 M6502_IMMEDIATE_READ
 CLEAR_LAST_PEEK(myLastSrcAddressA)
 M6502_ORA
-break;
+M6502_END
 
-case 0x05:
+M6502_OPCODE(0x05)
 M6502_ZERO_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_ORA
-break;
+M6502_END
 
-case 0x15:
+M6502_OPCODE(0x15)
 M6502_ZEROX_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_ORA
-break;
+M6502_END
 
-case 0x0d:
+M6502_OPCODE(0x0d)
 M6502_ABSOLUTE_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_ORA
-break;
+M6502_END
 
-case 0x1d:
+M6502_OPCODE(0x1d)
 M6502_ABSOLUTEX_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_ORA
-break;
+M6502_END
 
-case 0x19:
+M6502_OPCODE(0x19)
 M6502_ABSOLUTEY_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_ORA
-break;
+M6502_END
 
-case 0x01:
+M6502_OPCODE(0x01)
 M6502_INDIRECTX_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_ORA
-break;
+M6502_END
 
-case 0x11:
+M6502_OPCODE(0x11)
 M6502_INDIRECTY_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_ORA
-break;
+M6502_END
 //////////////////////////////////////////////////
 
 //////////////////////////////////////////////////
 // PHA
-case 0x48:
+M6502_OPCODE(0x48)
 M6502_IMPLIED
 SET_LAST_POKE(myLastSrcAddressA)
 M6502_PHA
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // PHP
-case 0x08:
+M6502_OPCODE(0x08)
 M6502_IMPLIED
 // TODO - add tracking for this opcode
 M6502_PHP
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // PLA
-case 0x68:
+M6502_OPCODE(0x68)
 M6502_IMPLIED
 // TODO - add tracking for this opcode
 M6502_PLA
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // PLP
-case 0x28:
+M6502_OPCODE(0x28)
 M6502_IMPLIED
 // TODO - add tracking for this opcode
 M6502_PLP
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // RLA
-case 0x2f:
+M6502_OPCODE(0x2f)
 M6502_ABSOLUTE_READMODIFYWRITE
 M6502_RLA
-break;
+M6502_END
 
-case 0x3f:
+M6502_OPCODE(0x3f)
 M6502_ABSOLUTEX_READMODIFYWRITE
 M6502_RLA
-break;
+M6502_END
 
-case 0x3b:
+M6502_OPCODE(0x3b)
 M6502_ABSOLUTEY_READMODIFYWRITE
 M6502_RLA
-break;
+M6502_END
 
-case 0x27:
+M6502_OPCODE(0x27)
 M6502_ZERO_READMODIFYWRITE
 M6502_RLA
-break;
+M6502_END
 
-case 0x37:
+M6502_OPCODE(0x37)
 M6502_ZEROX_READMODIFYWRITE
 M6502_RLA
-break;
+M6502_END
 
-case 0x23:
+M6502_OPCODE(0x23)
 M6502_INDIRECTX_READMODIFYWRITE
 M6502_RLA
-break;
+M6502_END
 
-case 0x33:
+M6502_OPCODE(0x33)
 M6502_INDIRECTY_READMODIFYWRITE
 M6502_RLA
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // ROL
-case 0x2a:
+M6502_OPCODE(0x2a)
 M6502_IMPLIED
 M6502_ROLA
-break;
+M6502_END
 
-case 0x26:
+M6502_OPCODE(0x26)
 M6502_ZERO_READMODIFYWRITE
 M6502_ROL
-break;
+M6502_END
 
-case 0x36:
+M6502_OPCODE(0x36)
 M6502_ZEROX_READMODIFYWRITE
 M6502_ROL
-break;
+M6502_END
 
-case 0x2e:
+M6502_OPCODE(0x2e)
 M6502_ABSOLUTE_READMODIFYWRITE
 M6502_ROL
-break;
+M6502_END
 
-case 0x3e:
+M6502_OPCODE(0x3e)
 M6502_ABSOLUTEX_READMODIFYWRITE
 M6502_ROL
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // ROR
-case 0x6a:
+M6502_OPCODE(0x6a)
 M6502_IMPLIED
 M6502_RORA
-break;
+M6502_END
 
-case 0x66:
+M6502_OPCODE(0x66)
 M6502_ZERO_READMODIFYWRITE
 M6502_ROR
-break;
+M6502_END
 
-case 0x76:
+M6502_OPCODE(0x76)
 M6502_ZEROX_READMODIFYWRITE
 M6502_ROR
-break;
+M6502_END
 
-case 0x6e:
+M6502_OPCODE(0x6e)
 M6502_ABSOLUTE_READMODIFYWRITE
 M6502_ROR
-break;
+M6502_END
 
-case 0x7e:
+M6502_OPCODE(0x7e)
 M6502_ABSOLUTEX_READMODIFYWRITE
 M6502_ROR
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // RRA
-case 0x6f:
+M6502_OPCODE(0x6f)
 M6502_ABSOLUTE_READMODIFYWRITE
 M6502_RRA
-break;
+M6502_END
 
-case 0x7f:
+M6502_OPCODE(0x7f)
 M6502_ABSOLUTEX_READMODIFYWRITE
 M6502_RRA
-break;
+M6502_END
 
-case 0x7b:
+M6502_OPCODE(0x7b)
 M6502_ABSOLUTEY_READMODIFYWRITE
 M6502_RRA
-break;
+M6502_END
 
-case 0x67:
+M6502_OPCODE(0x67)
 M6502_ZERO_READMODIFYWRITE
 M6502_RRA
-break;
+M6502_END
 
-case 0x77:
+M6502_OPCODE(0x77)
 M6502_ZEROX_READMODIFYWRITE
 M6502_RRA
-break;
+M6502_END
 
-case 0x63:
+M6502_OPCODE(0x63)
 M6502_INDIRECTX_READMODIFYWRITE
 M6502_RRA
-break;
+M6502_END
 
-case 0x73:
+M6502_OPCODE(0x73)
 M6502_INDIRECTY_READMODIFYWRITE
 M6502_RRA
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // RTI
-case 0x40:
+M6502_OPCODE(0x40)
 M6502_IMPLIED
 M6502_RTI
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // RTS
-case 0x60:
+M6502_OPCODE(0x60)
 M6502_IMPLIED
 M6502_RTS
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // SAX
-case 0x8f:
+M6502_OPCODE(0x8f)
 M6502_ABSOLUTE_WRITE
 M6502_SAX
-break;
+M6502_END
 
-case 0x87:
+M6502_OPCODE(0x87)
 M6502_ZERO_WRITE
 M6502_SAX
-break;
+M6502_END
 
-case 0x97:
+M6502_OPCODE(0x97)
 M6502_ZEROY_WRITE
 M6502_SAX
-break;
+M6502_END
 
-case 0x83:
+M6502_OPCODE(0x83)
 M6502_INDIRECTX_WRITE
 M6502_SAX
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // SBC
-case 0xe9:
-case 0xeb:
+M6502_OPCODE(0xe9)
+M6502_OPCODE(0xeb)
 M6502_IMMEDIATE_READ
 M6502_SBC
-break;
+M6502_END
 
-case 0xe5:
+M6502_OPCODE(0xe5)
 M6502_ZERO_READ
 M6502_SBC
-break;
+M6502_END
 
-case 0xf5:
+M6502_OPCODE(0xf5)
 M6502_ZEROX_READ
 M6502_SBC
-break;
+M6502_END
 
-case 0xed:
+M6502_OPCODE(0xed)
 M6502_ABSOLUTE_READ
 M6502_SBC
-break;
+M6502_END
 
-case 0xfd:
+M6502_OPCODE(0xfd)
 M6502_ABSOLUTEX_READ
 M6502_SBC
-break;
+M6502_END
 
-case 0xf9:
+M6502_OPCODE(0xf9)
 M6502_ABSOLUTEY_READ
 M6502_SBC
-break;
+M6502_END
 
-case 0xe1:
+M6502_OPCODE(0xe1)
 M6502_INDIRECTX_READ
 M6502_SBC
-break;
+M6502_END
 
-case 0xf1:
+M6502_OPCODE(0xf1)
 M6502_INDIRECTY_READ
 M6502_SBC
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // SBX
-case 0xcb:
+M6502_OPCODE(0xcb)
 M6502_IMMEDIATE_READ
 M6502_SBX
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // SEC
-case 0x38:
+M6502_OPCODE(0x38)
 M6502_IMPLIED
 M6502_SEC
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // SED
-case 0xf8:
+M6502_OPCODE(0xf8)
 M6502_IMPLIED
 M6502_SED
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // SEI
-case 0x78:
+M6502_OPCODE(0x78)
 M6502_IMPLIED
 M6502_SEI
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // SHA
-case 0x9f:
+M6502_OPCODE(0x9f)
 M6502_ABSOLUTEY_WRITE
 M6502_SHA
-break;
+M6502_END
 
-case 0x93:
+M6502_OPCODE(0x93)
 M6502_INDIRECTY_WRITE
 M6502_SHA
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // SHS
-case 0x9b:
+M6502_OPCODE(0x9b)
 M6502_ABSOLUTEY_WRITE
 M6502_SHS
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // SHX
-case 0x9e:
+M6502_OPCODE(0x9e)
 M6502_ABSOLUTEY_WRITE
 M6502_SHX
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // SHY
-case 0x9c:
+M6502_OPCODE(0x9c)
 M6502_ABSOLUTEX_WRITE
 M6502_SHY
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // SLO
-case 0x0f:
+M6502_OPCODE(0x0f)
 M6502_ABSOLUTE_READMODIFYWRITE
 M6502_SLO
-break;
+M6502_END
 
-case 0x1f:
+M6502_OPCODE(0x1f)
 M6502_ABSOLUTEX_READMODIFYWRITE
 M6502_SLO
-break;
+M6502_END
 
-case 0x1b:
+M6502_OPCODE(0x1b)
 M6502_ABSOLUTEY_READMODIFYWRITE
 M6502_SLO
-break;
+M6502_END
 
-case 0x07:
+M6502_OPCODE(0x07)
 M6502_ZERO_READMODIFYWRITE
 M6502_SLO
-break;
+M6502_END
 
-case 0x17:
+M6502_OPCODE(0x17)
 M6502_ZEROX_READMODIFYWRITE
 M6502_SLO
-break;
+M6502_END
 
-case 0x03:
+M6502_OPCODE(0x03)
 M6502_INDIRECTX_READMODIFYWRITE
 M6502_SLO
-break;
+M6502_END
 
-case 0x13:
+M6502_OPCODE(0x13)
 M6502_INDIRECTY_READMODIFYWRITE
 M6502_SLO
-break;
+M6502_END
 
 //////////////////////////////////////////////////
 // SRE
-case 0x4f:
+M6502_OPCODE(0x4f)
 M6502_ABSOLUTE_READMODIFYWRITE
 M6502_SRE
-break;
+M6502_END
 
-case 0x5f:
+M6502_OPCODE(0x5f)
 M6502_ABSOLUTEX_READMODIFYWRITE
 M6502_SRE
-break;
+M6502_END
 
-case 0x5b:
+M6502_OPCODE(0x5b)
 M6502_ABSOLUTEY_READMODIFYWRITE
 M6502_SRE
-break;
+M6502_END
 
-case 0x47:
+M6502_OPCODE(0x47)
 M6502_ZERO_READMODIFYWRITE
 M6502_SRE
-break;
+M6502_END
 
-case 0x57:
+M6502_OPCODE(0x57)
 M6502_ZEROX_READMODIFYWRITE
 M6502_SRE
-break;
+M6502_END
 
-case 0x43:
+M6502_OPCODE(0x43)
 M6502_INDIRECTX_READMODIFYWRITE
 M6502_SRE
-break;
+M6502_END
 
-case 0x53:
+M6502_OPCODE(0x53)
 M6502_INDIRECTY_READMODIFYWRITE
 M6502_SRE
-break;
+M6502_END
 
 
 //////////////////////////////////////////////////
 // STA
-case 0x85:
+M6502_OPCODE(0x85)
 M6502_ZERO_WRITE
 SET_LAST_POKE(myLastSrcAddressA)
 M6502_STA
-break;
+M6502_END
 
-case 0x95:
+M6502_OPCODE(0x95)
 M6502_ZEROX_WRITE
 M6502_STA
-break;
+M6502_END
 
-case 0x8d:
+M6502_OPCODE(0x8d)
 M6502_ABSOLUTE_WRITE
 SET_LAST_POKE(myLastSrcAddressA)
 M6502_STA
-break;
+M6502_END
 
-case 0x9d:
+M6502_OPCODE(0x9d)
 M6502_ABSOLUTEX_WRITE
 M6502_STA
-break;
+M6502_END
 
-case 0x99:
+M6502_OPCODE(0x99)
 M6502_ABSOLUTEY_WRITE
 M6502_STA
-break;
+M6502_END
 
-case 0x81:
+M6502_OPCODE(0x81)
 M6502_INDIRECTX_WRITE
 M6502_STA
-break;
+M6502_END
 
-case 0x91:
+M6502_OPCODE(0x91)
 M6502_INDIRECTY_WRITE
 M6502_STA
-break;
+M6502_END
 //////////////////////////////////////////////////
 
 
 //////////////////////////////////////////////////
 // STX
-case 0x86:
+M6502_OPCODE(0x86)
 M6502_ZERO_WRITE
 SET_LAST_POKE(myLastSrcAddressX)
 M6502_STX
-break;
+M6502_END
 
-case 0x96:
+M6502_OPCODE(0x96)
 M6502_ZEROY_WRITE
 M6502_STX
-break;
+M6502_END
 
-case 0x8e:
+M6502_OPCODE(0x8e)
 M6502_ABSOLUTE_WRITE
 SET_LAST_POKE(myLastSrcAddressX)
 M6502_STX
-break;
+M6502_END
 //////////////////////////////////////////////////
 
 
 //////////////////////////////////////////////////
 // STY
-case 0x84:
+M6502_OPCODE(0x84)
 M6502_ZERO_WRITE
 SET_LAST_POKE(myLastSrcAddressY)
 M6502_STY
-break;
+M6502_END
 
-case 0x94:
+M6502_OPCODE(0x94)
 M6502_ZEROX_WRITE
 M6502_STY
-break;
+M6502_END
 
-case 0x8c:
+M6502_OPCODE(0x8c)
 M6502_ABSOLUTE_WRITE
 SET_LAST_POKE(myLastSrcAddressY)
 M6502_STY
-break;
+M6502_END
 //////////////////////////////////////////////////
 
 
 //////////////////////////////////////////////////
 // Remaining MOVE opcodes
-case 0xaa:
+M6502_OPCODE(0xaa)
 M6502_IMPLIED
 SET_LAST_PEEK(myLastSrcAddressX, myLastSrcAddressA)
 M6502_TAX
-break;
+M6502_END
 
 
-case 0xa8:
+M6502_OPCODE(0xa8)
 M6502_IMPLIED
 SET_LAST_PEEK(myLastSrcAddressY, myLastSrcAddressA)
 M6502_TAY
-break;
+M6502_END
 
 
-case 0xba:
+M6502_OPCODE(0xba)
 M6502_IMPLIED
 SET_LAST_PEEK(myLastSrcAddressX, myLastSrcAddressS)
 M6502_TSX
-break;
+M6502_END
 
 
-case 0x8a:
+M6502_OPCODE(0x8a)
 M6502_IMPLIED
 SET_LAST_PEEK(myLastSrcAddressA, myLastSrcAddressX)
 M6502_TXA
-break;
+M6502_END
 
 
-case 0x9a:
+M6502_OPCODE(0x9a)
 M6502_IMPLIED
 SET_LAST_PEEK(myLastSrcAddressS, myLastSrcAddressX)
 M6502_TXS
-break;
+M6502_END
 
 
-case 0x98:
+M6502_OPCODE(0x98)
 M6502_IMPLIED
 SET_LAST_PEEK(myLastSrcAddressA, myLastSrcAddressY)
 M6502_TYA
-break;
+M6502_END
 //////////////////////////////////////////////////
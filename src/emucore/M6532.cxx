@@ -31,6 +31,7 @@
 M6532::M6532(const ConsoleIO& console, const Settings& settings)
   : myConsole(console),
     mySettings(settings),
+    myPortHandler(nullptr),
     myTimer(0), mySubTimer(0), myDivider(1),
     myTimerWrapped(false), myWrappedThisCycle(false),
     mySetTimerCycle(0), myLastCycle(0),
@@ -104,9 +105,15 @@ void M6532::update()
   bool prevPA7 = lport.getPin(Controller::DigitalPin::Four);
 
   // Update entire port state
-  lport.update();
-  rport.update();
-  myConsole.switches().update();
+  if(!myPortHandler || !myPortHandler->replayPorts(myConsole, mySystem->cycles()))
+  {
+    lport.update();
+    rport.update();
+    myConsole.switches().update();
+
+    if(myPortHandler)
+      myPortHandler->recordPorts(myConsole, mySystem->cycles());
+  }
 
   // Get new PA7 state
   bool currPA7 = lport.getPin(Controller::DigitalPin::Four);
@@ -44,6 +44,29 @@ class M6532 : public Device
     */
     friend class RiotDebug;
 
+    /**
+      Interface for logging the state of the controllers and console
+      switches whenever they are updated, and for replaying it later on.
+    */
+    class PortHandler
+    {
+      public:
+        virtual ~PortHandler() = default;
+
+        /**
+          Called before the ports are updated from the current events.
+
+          @return  True if the handler has set the ports itself, in which
+                   case they are not updated from the events
+        */
+        virtual bool replayPorts(const ConsoleIO& console, uInt64 cycles) = 0;
+
+        /**
+          Called after the ports were updated from the current events.
+        */
+        virtual void recordPorts(const ConsoleIO& console, uInt64 cycles) = 0;
+    };
+
   public:
     /**
       Create a new 6532 for the specified console
@@ -65,6 +88,12 @@ class M6532 : public Device
     */
     void update();
 
+    /**
+      Set the handler which logs or replays each port update (may be nullptr).
+    */
+    void setPortHandler(PortHandler* handler) { myPortHandler = handler; }
+    PortHandler* portHandler() const { return myPortHandler; }
+
     /**
       Install 6532 in the specified system.  Invoked by the system
       when the 6532 is attached to it.
@@ -168,6 +197,9 @@ class M6532 : public Device
     // Reference to the settings
     const Settings& mySettings;
 
+    // Logs or replays the port updates (if set)
+    PortHandler* myPortHandler;
+
     // An amazing 128 bytes of RAM
     uInt8 myRAM[128];
 
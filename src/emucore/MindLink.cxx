@@ -16,6 +16,7 @@
 //============================================================================
 
 #include "Event.hxx"
+#include "Serializer.hxx"
 #include "MindLink.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -70,6 +71,44 @@ void MindLink::nextMindlinkBit()
 	}
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MindLink::save(Serializer& out) const
+{
+  if(!Controller::save(out))
+    return false;
+
+  try
+  {
+    out.putInt(myMindlinkPos);
+    out.putInt(myMindlinkShift);
+  }
+  catch(...)
+  {
+    cerr << "ERROR: MindLink::save() exception\n";
+    return false;
+  }
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MindLink::load(Serializer& in)
+{
+  if(!Controller::load(in))
+    return false;
+
+  try
+  {
+    myMindlinkPos = in.getInt();
+    myMindlinkShift = in.getInt();
+  }
+  catch(...)
+  {
+    cerr << "ERROR: MindLink::load() exception\n";
+    return false;
+  }
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool MindLink::setMouseControl(
     Controller::Type xtype, int xid, Controller::Type ytype, int yid)
@@ -72,6 +72,30 @@ class MindLink : public Controller
     */
     void update() override;
 
+    /**
+      Saves the current state of this controller to the given Serializer.
+      Besides the pins, this includes the position and the bit being transferred, which
+      change while the game accesses the controller.
+
+      @param out The serializer device to save to.
+      @return The result of the save.  True on success, false on failure.
+    */
+    bool save(Serializer& out) const override;
+
+    /**
+      Loads the current state of this controller from the given Serializer.
+
+      @param in The serializer device to load from.
+      @return The result of the load.  True on success, false on failure.
+    */
+    bool load(Serializer& in) override;
+
+    /**
+      The state changes without any pin changes, so it isn't tracked
+      (see Serializable).
+    */
+    uInt64 stateGeneration() const override { return 0; }
+
     /**
       Returns the name of this controller.
     */
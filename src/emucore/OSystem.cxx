@@ -49,12 +49,14 @@
 #include "FrameBuffer.hxx"
 #include "TIASurface.hxx"
 #include "TIAConstants.hxx"
+#include "Serializer.hxx"
 #include "Settings.hxx"
 #include "PropsSet.hxx"
 #include "EventHandler.hxx"
 #include "PNGLibrary.hxx"
 #include "Console.hxx"
 #include "Random.hxx"
+#include "RewindManager.hxx"
 #include "StateManager.hxx"
 #include "TimerManager.hxx"
 #include "Version.hxx"
@@ -62,6 +64,7 @@
 #include "DispatchResult.hxx"
 #include "EmulationWorker.hxx"
 #include "AudioSettings.hxx"
+#include "Tracer.hxx"
 #include "repository/KeyValueRepositoryNoop.hxx"
 #include "repository/KeyValueRepositoryConfigfile.hxx"
 
@@ -71,6 +74,14 @@ using namespace std::chrono;
 
 namespace {
   constexpr uInt32 FPS_METER_QUEUE_SIZE = 100;
+
+  // Turbo mode renders one frame per display refresh; this rate is assumed
+  // if the refresh rate of the display is unknown
+  constexpr uInt32 DEFAULT_REFRESH_RATE = 60;
+
+  // With input latched on VSYNC, input is collected with this interval
+  // while the emulation is running
+  constexpr milliseconds INPUT_POLL_INTERVAL(1);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -78,7 +89,12 @@ OSystem::OSystem()
   : myLauncherUsed(false),
     myQuitLoop(false),
     mySettingsLoaded(false),
-    myFpsMeter(FPS_METER_QUEUE_SIZE)
+    myFpsMeter(FPS_METER_QUEUE_SIZE),
+    myTurboEnabled(false),
+    myTurboSpeed(1),
+    myTurboWasMuted(false),
+    myTurboRenderInterval(1. / DEFAULT_REFRESH_RATE),
+    myRunAheadFrames(0)
 {
   // Get built-in features
   #ifdef SOUND_SUPPORT
@@ -144,6 +160,10 @@ bool OSystem::create()
       << FilesystemNode(myPropertiesFile).getShortPath() << "'" << endl;
   Logger::log(buf.str(), 1);
 
+  // Start recording host-side trace events, if requested
+  if(!mySettings->getString("trace").empty())
+    Tracer::instance().start();
+
   // NOTE: The framebuffer MUST be created before any other object!!!
   // Get relevant information about the video hardware
   // This must be done before any graphics context is created, since
@@ -400,6 +420,7 @@ string OSystem::createConsole(const FilesystemNode& rom, const string& md5sum,
       return "ERROR: Couldn't create framebuffer for console";
     }
     myConsole->initializeAudio();
+    myRunAheadFrames = mySettings->getInt("runahead");
 
     if(showmessage)
     {
@@ -417,6 +438,9 @@ string OSystem::createConsole(const FilesystemNode& rom, const string& md5sum,
 
     myFrameBuffer->setCursorState();
 
+    // Continue from the previous session's Time Machine states, if kept
+    myStateManager->rewindManager().startPersisting(true);
+
     // Also check if certain virtual buttons should be held down
     // These must be checked each time a new console is being created
     myEventHandler->handleConsoleStartupEvents();
@@ -639,41 +663,117 @@ float OSystem::frameRate() const
   return myConsole ? myConsole->getFramerate() : 0;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void OSystem::enableTurbo(bool enable)
+{
+  if(enable == myTurboEnabled)
+    return;
+  // Turbo mode only makes sense while a game is actually being emulated
+  if(enable && !(myConsole && myEventHandler->state() == EventHandlerState::EMULATION))
+    return;
+
+  myTurboEnabled = enable;
+  ostringstream buf;
+
+  if(myTurboEnabled)
+  {
+    myTurboSpeed = BSPF::clamp(mySettings->getFloat("turbospeed"), 0.F, MAX_TURBO_SPEED);
+    myTurboWasMuted = mySound->mute(true);
+    myLastTurboRender = high_resolution_clock::now();
+
+    const uInt32 refreshRate = myFrameBuffer->refreshRate();
+    myTurboRenderInterval = 1. / (refreshRate > 0 ? refreshRate : DEFAULT_REFRESH_RATE);
+
+    buf << "Turbo mode enabled (";
+    if(myTurboSpeed > 0)
+      buf << myTurboSpeed << "x)";
+    else
+      buf << "unthrottled)";
+  }
+  else
+  {
+    mySound->mute(myTurboWasMuted);
+    buf << "Turbo mode disabled";
+  }
+  myFpsMeter.reset();
+  myFrameBuffer->showMessage(buf.str());
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 double OSystem::dispatchEmulation(EmulationWorker& emulationWorker)
 {
   if (!myConsole) return 0.;
 
+  TRACE_SCOPE("OSystem::dispatchEmulation");
+
   TIA& tia(myConsole->tia());
   EmulationTiming& timing(myConsole->emulationTiming());
   DispatchResult dispatchResult;
 
+  const bool unthrottled = myTurboEnabled && myTurboSpeed <= 0;
+  const double speed = myTurboEnabled && !unthrottled ? myTurboSpeed : 1.;
+  const time_point<high_resolution_clock> startTime = high_resolution_clock::now();
+
   // Check whether we have a frame pending for rendering...
   bool framePending = tia.newFramePending();
+
+  // ... in turbo mode, only the last frame of each display interval is rendered,
+  // all others are dropped before they reach the TIASurface...
+  if (framePending && myTurboEnabled) {
+    if (duration_cast<duration<double>>(startTime - myLastTurboRender).count() < myTurboRenderInterval)
+      framePending = false;
+    else
+      myLastTurboRender = startTime;
+  }
   // ... and copy it to the frame buffer. It is important to do this before
   // the worker is started to avoid racing.
   if (framePending) {
     myFpsMeter.render(tia.framesSinceLastRender());
     tia.renderToFrameBuffer();
+
+    // Replace the frame with one from the (speculative) future
+    if (myRunAheadFrames > 0 && !myTurboEnabled && !myStateManager->movieActive()) runAhead();
   }
 
   // Start emulation on a dedicated thread. It will do its own scheduling to sync 6507 and real time
   // and will run until we stop the worker.
   emulationWorker.start(
-    timing.cyclesPerSecond(),
+    uInt32(timing.cyclesPerSecond() * speed),
     timing.maxCyclesPerTimeslice(),
     timing.minCyclesPerTimeslice(),
     &dispatchResult,
-    &tia
+    &tia,
+    unthrottled ? myTurboRenderInterval : 0.
   );
 
   // Render the frame. This may block, but emulation will continue to run on the worker, so the
   // audio pipeline is kept fed :)
   if (framePending) myFrameBuffer->updateInEmulationMode(myFpsMeter.fps());
 
+  // With input latched at the start of each frame, keep collecting input until
+  // the next frame is due instead of stopping the worker right away. The frames
+  // emulated in the meantime thus see input which is at most INPUT_POLL_INTERVAL
+  // old, and not as old as the last event poll.
+  if (tia.inputLatchOnVsync() && !unthrottled) {
+    const time_point<high_resolution_clock> frameEnd = startTime +
+      duration_cast<high_resolution_clock::duration>(duration<double>(
+        static_cast<double>(timing.cyclesPerFrame()) /
+        (static_cast<double>(timing.cyclesPerSecond()) * speed)
+      ));
+
+    for (auto now = high_resolution_clock::now(); now < frameEnd; now = high_resolution_clock::now()) {
+      myEventHandler->pollInput();
+      std::this_thread::sleep_until(std::min<time_point<high_resolution_clock>>(now + INPUT_POLL_INTERVAL, frameEnd));
+    }
+  }
+
   // Stop the worker and wait until it has finished
   uInt64 totalCycles = emulationWorker.stop();
 
+  // Collect the time spent on the other threads for the frame time breakdown
+  myFpsMeter.addStageTime(FpsMeter::Stage::emulation, emulationWorker.emulationTime());
+  myFpsMeter.addStageTime(FpsMeter::Stage::audio, mySound->consumeCallbackTime());
+
   // Handle the dispatch result
   switch (dispatchResult.getStatus()) {
     case DispatchResult::Status::ok:
@@ -706,8 +806,77 @@ double OSystem::dispatchEmulation(EmulationWorker& emulationWorker)
   if (dispatchResult.getStatus() == DispatchResult::Status::ok && myEventHandler->frying())
     myConsole->fry();
 
-  // Return the 6507 time used in seconds
-  return static_cast<double>(totalCycles) / static_cast<double>(timing.cyclesPerSecond());
+  // Return the 6507 time used in seconds; when running unthrottled, there
+  // is no relation to 6507 time, and we return the real time used instead
+  if (unthrottled)
+    return duration_cast<duration<double>>(high_resolution_clock::now() - startTime).count();
+
+  return static_cast<double>(totalCycles) / (static_cast<double>(timing.cyclesPerSecond()) * speed);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void OSystem::runAhead()
+{
+  TRACE_SCOPE("OSystem::runAhead");
+
+  TIA& tia(myConsole->tia());
+  const EmulationTiming& timing(myConsole->emulationTiming());
+  const time_point<high_resolution_clock> startTime = high_resolution_clock::now();
+  constexpr uInt32 frameSize = TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight;
+
+  if (!myRunAheadState) {
+    myRunAheadState = make_unique<Serializer>();
+    myRunAheadFrame = make_unique<uInt8[]>(frameSize);
+  }
+
+  // Snapshot the real timeline, including the partially drawn frame
+  Serializer& state = *myRunAheadState;
+  state.rewind();
+  if (!myStateManager->saveState(state) || !tia.saveDisplay(state)) {
+    myRunAheadFrames = 0;
+    Logger::log("ERROR: Couldn't save state for run-ahead, disabling it", 0);
+    return;
+  }
+
+  tia.enableAudioOutput(false);
+
+  // Each frame is emulated up to its completion; frames that never finish
+  // (no VSYNC) are cut off after a generous number of cycles
+  DispatchResult dispatchResult;
+  const uInt64 maxCycles = 2 * uInt64(timing.cyclesPerFrame());
+  bool frameComplete = true;
+
+  for (uInt32 frame = 0; frame < myRunAheadFrames && frameComplete; ++frame) {
+    uInt64 cycles = 0;
+
+    while (!tia.newFramePending() && cycles < maxCycles) {
+      tia.update(dispatchResult, timing.maxCyclesPerTimeslice());
+      cycles += dispatchResult.getCycles();
+
+      // Breakpoints and fatal errors are left to the real timeline
+      if (dispatchResult.getStatus() != DispatchResult::Status::ok) break;
+    }
+
+    frameComplete = tia.newFramePending();
+    tia.renderToFrameBuffer();
+  }
+
+  tia.enableAudioOutput(true);
+
+  // Keep the last run-ahead frame and go back to the real timeline
+  memcpy(myRunAheadFrame.get(), tia.frameBuffer(), frameSize);
+
+  state.rewind();
+  if (!myStateManager->loadState(state) || !tia.loadDisplay(state)) {
+    myRunAheadFrames = 0;
+    Logger::log("ERROR: Couldn't restore state after run-ahead, disabling it", 0);
+    return;
+  }
+
+  memcpy(tia.frameBuffer(), myRunAheadFrame.get(), frameSize);
+
+  myFpsMeter.addStageTime(FpsMeter::Stage::runAhead,
+    duration_cast<duration<double>>(high_resolution_clock::now() - startTime).count());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -719,6 +888,7 @@ void OSystem::mainLoop()
   EmulationWorker emulationWorker;
 
   myFpsMeter.reset(TIAConstants::initialGarbageFrames);
+  Tracer::instance().setThreadName("main");
 
   for(;;)
   {
@@ -762,6 +932,12 @@ void OSystem::mainLoop()
       // Wait until we have caught up with 6507 time
       std::this_thread::sleep_until(virtualTime);
     }
+
+    if (myEventHandler->state() == EventHandlerState::EMULATION) {
+      myFpsMeter.addStageTime(FpsMeter::Stage::idle,
+        duration_cast<duration<double>>(high_resolution_clock::now() - now).count());
+      myFpsMeter.commitFrameTimes();
+    }
   }
 
   // Cleanup time
@@ -771,6 +947,11 @@ void OSystem::mainLoop()
 
   myCheatManager->saveCheatDatabase();
 #endif
+
+  // Write the trace events recorded during this run
+  const string& traceFile = mySettings->getString("trace");
+  if(Tracer::enabled() && !Tracer::instance().dump(traceFile))
+    Logger::log("ERROR: Couldn't write trace file '" + traceFile + "'", 0);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -25,6 +25,7 @@ class Properties;
 class PropertiesSet;
 class Random;
 class Sound;
+class Serializer;
 class StateManager;
 class TimerManager;
 class EmulationWorker;
@@ -70,6 +71,10 @@ class OSystem
 {
   friend class EventHandler;
 
+  public:
+    // The highest supported 'turbospeed'
+    static constexpr float MAX_TURBO_SPEED = 100.F;
+
   public:
     OSystem();
     virtual ~OSystem();
@@ -387,8 +392,24 @@ class OSystem
     */
     void resetFps();
 
+    /**
+      Get the FPS meter, which also collects the frame time breakdown.
+
+      @return The FPS meter
+    */
+    FpsMeter& fpsMeter() { return myFpsMeter; }
+
     float frameRate() const;
 
+    /**
+      Enable or disable turbo (fast-forward) mode.  While active, emulation
+      runs at 'turbospeed' times the normal speed (or unthrottled for 0),
+      sound is muted and only one frame per display refresh is rendered.
+    */
+    void enableTurbo(bool enable);
+    void toggleTurbo() { enableTurbo(!myTurboEnabled); }
+    bool turboEnabled() const { return myTurboEnabled; }
+
     /**
       Attempt to override the base directory that will be used by derived
       classes, and use this one instead.  Note that this is only a hint;
@@ -552,6 +573,23 @@ class OSystem
 
     FpsMeter myFpsMeter;
 
+    // Turbo mode, its speed factor (0 = unthrottled) and the mute state
+    // to restore when it is left
+    bool myTurboEnabled;
+    float myTurboSpeed;
+    bool myTurboWasMuted;
+
+    // Time of the last frame rendered in turbo mode, and the minimum time
+    // between two rendered frames (one display refresh)
+    std::chrono::time_point<std::chrono::high_resolution_clock> myLastTurboRender;
+    double myTurboRenderInterval;
+
+    // Number of frames to run ahead of the real timeline, the snapshot
+    // of the real timeline and the buffer for the run-ahead frame
+    uInt32 myRunAheadFrames;
+    unique_ptr<Serializer> myRunAheadState;
+    ByteBuffer myRunAheadFrame;
+
     // If not empty, a hint for derived classes to use this as the
     // base directory (where all settings are stored)
     // Derived classes are free to ignore it and use their own defaults
@@ -593,6 +631,13 @@ class OSystem
 
     double dispatchEmulation(EmulationWorker& emulationWorker);
 
+    /**
+      Emulate 'runahead' frames beyond the current state with the current
+      input, leave the last of them in the TIA frame buffer and restore the
+      current state again.  Audio is only generated by the real timeline.
+    */
+    void runAhead();
+
     // Following constructors and assignment operators not supported
     OSystem(const OSystem&) = delete;
     OSystem(OSystem&&) = delete;
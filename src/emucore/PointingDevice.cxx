@@ -18,6 +18,7 @@
 #include "Control.hxx"
 #include "Event.hxx"
 #include "System.hxx"
+#include "Serializer.hxx"
 #include "TIA.hxx"
 
 #include "PointingDevice.hxx"
@@ -98,6 +99,64 @@ void PointingDevice::update()
                           (myEvent.get(Event::MouseButtonRightValue) == 0));
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool PointingDevice::save(Serializer& out) const
+{
+  if(!Controller::save(out))
+    return false;
+
+  try
+  {
+    out.putDouble(myHCounterRemainder);
+    out.putDouble(myVCounterRemainder);
+    out.putInt(myTrackBallLinesH);
+    out.putInt(myTrackBallLinesV);
+    out.putBool(myTrackBallLeft);
+    out.putBool(myTrackBallDown);
+    out.putByte(myCountH);
+    out.putByte(myCountV);
+    out.putInt(myScanCountH);
+    out.putInt(myScanCountV);
+    out.putInt(myFirstScanOffsetH);
+    out.putInt(myFirstScanOffsetV);
+  }
+  catch(...)
+  {
+    cerr << "ERROR: PointingDevice::save() exception\n";
+    return false;
+  }
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool PointingDevice::load(Serializer& in)
+{
+  if(!Controller::load(in))
+    return false;
+
+  try
+  {
+    myHCounterRemainder = float(in.getDouble());
+    myVCounterRemainder = float(in.getDouble());
+    myTrackBallLinesH = in.getInt();
+    myTrackBallLinesV = in.getInt();
+    myTrackBallLeft = in.getBool();
+    myTrackBallDown = in.getBool();
+    myCountH = in.getByte();
+    myCountV = in.getByte();
+    myScanCountH = in.getInt();
+    myScanCountV = in.getInt();
+    myFirstScanOffsetH = in.getInt();
+    myFirstScanOffsetV = in.getInt();
+  }
+  catch(...)
+  {
+    cerr << "ERROR: PointingDevice::load() exception\n";
+    return false;
+  }
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool PointingDevice::setMouseControl(
     Controller::Type xtype, int xid, Controller::Type ytype, int yid)
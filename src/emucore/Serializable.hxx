@@ -18,6 +18,8 @@
 #ifndef SERIALIZABLE_HXX
 #define SERIALIZABLE_HXX
 
+#include <atomic>
+
 #include "Serializer.hxx"
 
 /**
@@ -53,6 +55,97 @@ class Serializable
       @return  False on any errors, else true
     */
     virtual bool load(Serializer& in) = 0;
+
+    /**
+      Answer a value which changes whenever the state written by save()
+      may have changed.  Snapshot consumers can reuse an earlier encoding
+      of the object as long as this value stays the same (see
+      SerializableCache).  Values are unique across all objects.
+
+      @return  The state generation, or 0 if changes aren't tracked
+    */
+    virtual uInt64 stateGeneration() const { return 0; }
+
+    /**
+      Notify that the encoding just written by save() is kept for reuse by
+      a snapshot consumer (see SerializableCache).  There is at most one
+      such encoding per object.
+    */
+    virtual void encodingSaved() const { }
+
+    /**
+      Bring the kept encoding up to date with the changes made since it was
+      saved, as far as they don't change the state generation (e.g. writes
+      to single pages of cart RAM).
+
+      @param encoding  The kept encoding
+      @param size      The size of the encoding
+    */
+    virtual void updateEncoding(uInt8* encoding, size_t size) const { }
+
+  protected:
+    /**
+      Get a new state generation, distinct from all earlier ones.
+    */
+    static uInt64 nextStateGeneration() {
+      static std::atomic<uInt64> ourGeneration(0);
+      return ourGeneration.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+};
+
+/**
+  This class keeps the encoding of a Serializable object, and reuses it
+  when saving the object again, as long as its state generation has not
+  changed in the meantime.  Changes which leave the generation unchanged
+  are applied to the encoding in place (see updateEncoding()).  Objects
+  which don't track their changes are always saved anew.
+
+  @author  Stephen Anthony
+*/
+class SerializableCache
+{
+  public:
+    SerializableCache() : myGeneration(0) { }
+
+    /**
+      Save the current state of the object to the given Serializer,
+      reusing the cached encoding if possible.
+
+      @param object  The object to save
+      @param out     The Serializer object to use
+      @return  False on any errors, else true
+    */
+    bool save(const Serializable& object, Serializer& out)
+    {
+      const uInt64 generation = object.stateGeneration();
+      if(generation == 0)
+        return object.save(out);
+
+      if(generation != myGeneration)
+      {
+        myGeneration = 0;
+        myBuffer.rewind();
+        if(!object.save(myBuffer))
+          return false;
+        object.encodingSaved();
+        myGeneration = generation;
+      }
+      else
+        object.updateEncoding(myBuffer.data(), myBuffer.size());
+      out.putByteArray(myBuffer.data(), uInt32(myBuffer.size()));
+      return true;
+    }
+
+  private:
+    Serializer myBuffer;
+    uInt64 myGeneration;
+
+  private:
+    // Following constructors and assignment operators not supported
+    SerializableCache(const SerializableCache&) = delete;
+    SerializableCache(SerializableCache&&) = delete;
+    SerializableCache& operator=(const SerializableCache&) = delete;
+    SerializableCache& operator=(SerializableCache&&) = delete;
 };
 
 #endif
@@ -23,7 +23,12 @@ using std::ios_base;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Serializer::Serializer(const string& filename, bool readonly)
-  : myStream(nullptr)
+  : myStream(nullptr),
+    myData(nullptr),
+    myCapacity(0),
+    myEnd(0),
+    myReadPos(0),
+    myWritePos(0)
 {
   if(readonly)
   {
@@ -63,54 +68,93 @@ Serializer::Serializer(const string& filename, bool readonly)
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Serializer::Serializer()
-  : myStream(nullptr)
+  : myStream(nullptr),
+    myBuffer(make_unique<uInt8[]>(INITIAL_CAPACITY)),
+    myData(myBuffer.get()),
+    myCapacity(INITIAL_CAPACITY),
+    myEnd(0),
+    myReadPos(0),
+    myWritePos(0)
 {
-  myStream = make_unique<stringstream>(ios::in | ios::out | ios::binary);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Serializer::Serializer(uInt8* data, size_t size)
+  : myStream(nullptr),
+    myData(data),
+    myCapacity(size),
+    myEnd(0),
+    myReadPos(0),
+    myWritePos(0)
+{
+}
 
-  // For some reason, Windows and possibly macOS needs to store something in
-  // the stream before it is used for the first time
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Serializer::Serializer(const uInt8* data, size_t size)
+  : myStream(nullptr),
+    // The data is never written, since the capacity is zero
+    myData(const_cast<uInt8*>(data)),
+    myCapacity(0),
+    myEnd(size),
+    myReadPos(0),
+    myWritePos(0)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Serializer::rewind()
+{
   if(myStream)
   {
-    myStream->exceptions( ios_base::failbit | ios_base::badbit | ios_base::eofbit );
-    putBool(true);
-    rewind();
+    myStream->clear();
+    myStream->seekg(ios_base::beg);
+    myStream->seekp(ios_base::beg);
   }
+  else
+    myReadPos = myWritePos = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::rewind()
+size_t Serializer::size() const
 {
-  myStream->clear();
-  myStream->seekg(ios_base::beg);
-  myStream->seekp(ios_base::beg);
+  return myStream ? size_t(myStream->tellp()) : myWritePos;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-size_t Serializer::size() const
+void Serializer::grow(size_t size)
 {
-  return myStream->tellp();
+  if(!myBuffer)
+    throw runtime_error("Serializer: write beyond end of memory");
+
+  const size_t capacity = std::max(size, 2 * myCapacity);
+  ByteBuffer buffer = make_unique<uInt8[]>(capacity);
+
+  std::memcpy(buffer.get(), myData, myEnd);
+  myBuffer = std::move(buffer);
+  myData = myBuffer.get();
+  myCapacity = capacity;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 Serializer::getByte() const
 {
-  char buf;
-  myStream->read(&buf, 1);
+  uInt8 val = 0;
+  readBytes(&val, 1);
 
-  return buf;
+  return val;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::getByteArray(uInt8* array, uInt32 size) const
 {
-  myStream->read(reinterpret_cast<char*>(array), size);
+  readBytes(array, size);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt16 Serializer::getShort() const
 {
   uInt16 val = 0;
-  myStream->read(reinterpret_cast<char*>(&val), sizeof(uInt16));
+  readBytes(&val, sizeof(uInt16));
 
   return val;
 }
@@ -118,14 +162,14 @@ uInt16 Serializer::getShort() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::getShortArray(uInt16* array, uInt32 size) const
 {
-  myStream->read(reinterpret_cast<char*>(array), sizeof(uInt16)*size);
+  readBytes(array, sizeof(uInt16)*size);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 Serializer::getInt() const
 {
   uInt32 val = 0;
-  myStream->read(reinterpret_cast<char*>(&val), sizeof(uInt32));
+  readBytes(&val, sizeof(uInt32));
 
   return val;
 }
@@ -133,14 +177,14 @@ uInt32 Serializer::getInt() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::getIntArray(uInt32* array, uInt32 size) const
 {
-  myStream->read(reinterpret_cast<char*>(array), sizeof(uInt32)*size);
+  readBytes(array, sizeof(uInt32)*size);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt64 Serializer::getLong() const
 {
   uInt64 val = 0;
-  myStream->read(reinterpret_cast<char*>(&val), sizeof(uInt64));
+  readBytes(&val, sizeof(uInt64));
 
   return val;
 }
@@ -149,7 +193,7 @@ uInt64 Serializer::getLong() const
 double Serializer::getDouble() const
 {
   double val = 0.0;
-  myStream->read(reinterpret_cast<char*>(&val), sizeof(double));
+  readBytes(&val, sizeof(double));
 
   return val;
 }
@@ -160,7 +204,7 @@ string Serializer::getString() const
   int len = getInt();
   string str;
   str.resize(len);
-  myStream->read(&str[0], len);
+  readBytes(&str[0], len);
 
   return str;
 }
@@ -174,49 +218,49 @@ bool Serializer::getBool() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::putByte(uInt8 value)
 {
-  myStream->write(reinterpret_cast<char*>(&value), 1);
+  writeBytes(&value, 1);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::putByteArray(const uInt8* array, uInt32 size)
 {
-  myStream->write(reinterpret_cast<const char*>(array), size);
+  writeBytes(array, size);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::putShort(uInt16 value)
 {
-  myStream->write(reinterpret_cast<char*>(&value), sizeof(uInt16));
+  writeBytes(&value, sizeof(uInt16));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::putShortArray(const uInt16* array, uInt32 size)
 {
-  myStream->write(reinterpret_cast<const char*>(array), sizeof(uInt16)*size);
+  writeBytes(array, sizeof(uInt16)*size);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::putInt(uInt32 value)
 {
-  myStream->write(reinterpret_cast<char*>(&value), sizeof(uInt32));
+  writeBytes(&value, sizeof(uInt32));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::putIntArray(const uInt32* array, uInt32 size)
 {
-  myStream->write(reinterpret_cast<const char*>(array), sizeof(uInt32)*size);
+  writeBytes(array, sizeof(uInt32)*size);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::putLong(uInt64 value)
 {
-  myStream->write(reinterpret_cast<char*>(&value), sizeof(uInt64));
+  writeBytes(&value, sizeof(uInt64));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::putDouble(double value)
 {
-  myStream->write(reinterpret_cast<char*>(&value), sizeof(double));
+  writeBytes(&value, sizeof(double));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -224,7 +268,7 @@ void Serializer::putString(const string& str)
 {
   int len = int(str.length());
   putInt(len);
-  myStream->write(str.data(), len);
+  writeBytes(str.data(), len);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
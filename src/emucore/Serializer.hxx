@@ -25,6 +25,17 @@
   read from/written to a binary stream in a system-independent way.  The
   stream can be either an actual file, or an in-memory structure.
 
+  The in-memory structure is a contiguous, growable byte buffer with
+  independent read and write positions.  Its capacity is kept across
+  rewind(), so a Serializer that is reused (rewind states, run-ahead)
+  stops allocating once it has grown to the size of a state.  The data
+  ends where the last write ended, even if more was written before the
+  last rewind(); reading beyond it throws, like the file stream does.
+
+  An in-memory stream can also use memory provided by the caller, which
+  avoids copying the data in or out (e.g. for libretro).  Such a stream
+  cannot grow; writing beyond its size throws.
+
   Bytes are written as characters, shorts as 2 characters (16-bits),
   integers as 4 characters (32-bits), long integers as 8 bytes (64-bits),
   strings are written as characters prepended by the length of the string,
@@ -49,12 +60,24 @@ class Serializer
     Serializer(const string& filename, bool readonly = false);
     Serializer();
 
+    /**
+      Creates a new in-memory Serializer device, which writes to the given
+      memory without taking ownership of it.
+    */
+    Serializer(uInt8* data, size_t size);
+
+    /**
+      Creates a new in-memory Serializer device, which reads the given
+      memory without taking ownership of it.  It can't be written to.
+    */
+    Serializer(const uInt8* data, size_t size);
+
   public:
     /**
       Answers whether the serializer is currently initialized for reading
       and writing.
     */
-    explicit operator bool() const { return myStream != nullptr; }
+    explicit operator bool() const { return myStream != nullptr || myData != nullptr; }
 
     /**
       Resets the read/write location to the beginning of the stream.
@@ -66,6 +89,15 @@ class Serializer
     */
     size_t size() const;
 
+    /**
+      Returns a view of the serialized bytes of an in-memory stream; it
+      covers size() bytes and stays valid until the next write.  Through
+      the non-const variant, the bytes of an owned buffer can be updated in
+      place.  For file streams, nullptr is returned.
+    */
+    const uInt8* data() const { return myData; }
+    uInt8* data() { return myData; }
+
     /**
       Reads a byte value (unsigned 8-bit) from the current input stream.
 
@@ -213,9 +245,57 @@ class Serializer
     void putBool(bool b);
 
   private:
-    // The stream to send the serialized data to.
+    /**
+      Copy raw bytes from/to the current stream position.
+    */
+    void readBytes(void* data, size_t size) const {
+      if(myStream)
+        myStream->read(static_cast<char*>(data), size);
+      else
+      {
+        if(myReadPos + size > myEnd)
+          throw runtime_error("Serializer: read beyond end of data");
+
+        std::memcpy(data, myData + myReadPos, size);
+        myReadPos += size;
+      }
+    }
+    void writeBytes(const void* data, size_t size) {
+      if(myStream)
+        myStream->write(static_cast<const char*>(data), size);
+      else
+      {
+        if(myWritePos + size > myCapacity)
+          grow(myWritePos + size);
+
+        std::memcpy(myData + myWritePos, data, size);
+        myWritePos += size;
+        myEnd = myWritePos;
+      }
+    }
+
+    /**
+      Enlarge the in-memory buffer to hold at least the given number of bytes.
+      Throws if the memory is provided by the caller.
+    */
+    void grow(size_t size);
+
+  private:
+    // The stream to send the serialized data to (file streams only)
     unique_ptr<iostream> myStream;
 
+    // The in-memory buffer (if owned), the memory in use (owned or provided
+    // by the caller), its capacity, the end of the data (the end of the
+    // last write) and the current read and write positions
+    ByteBuffer myBuffer;
+    uInt8* myData;
+    size_t myCapacity;
+    size_t myEnd;
+    mutable size_t myReadPos;
+    size_t myWritePos;
+
+    static constexpr size_t INITIAL_CAPACITY = 4096;
+
     static constexpr uInt8 TruePattern = 0xfe, FalsePattern = 0x01;
 
   private:
@@ -36,6 +36,7 @@ Settings::Settings()
   // Video-related options
   setPermanent("video", "");
   setPermanent("speed", "1.0");
+  setPermanent("turbospeed", "10.0");
   setPermanent("vsync", "true");
   setPermanent("center", "false");
   setPermanent("palette", "standard");
@@ -85,6 +86,8 @@ Settings::Settings()
   setPermanent("combomap", "");
   setPermanent("joydeadzone", "13");
   setPermanent("joyallow4", "false");
+  setPermanent("inputlatch", "poll");
+  setPermanent("runahead", "0");
   setPermanent("usemouse", "analog");
   setPermanent("grabmouse", "true");
   setPermanent("cursor", "2");
@@ -137,6 +140,10 @@ Settings::Settings()
   setPermanent("threads", "false");
   setTemporary("romloadcount", "0");
   setTemporary("maxres", "");
+  setTemporary("trace", "");
+  setTemporary("recordmovie", "");
+  setTemporary("playmovie", "");
+  setTemporary("movieturbo", "false");
 
 #ifdef DEBUGGER_SUPPORT
   // Debugger/disassembly options
@@ -149,6 +156,7 @@ Settings::Settings()
   setPermanent("dis.showaddr", "true");
   setPermanent("dis.relocate", "false");
   setPermanent("dev.rwportbreak", "true");
+  setTemporary("cputrace", "");
 #endif
 
   // Player settings
@@ -166,6 +174,8 @@ Settings::Settings()
   setPermanent("plr.tm.uncompressed", 60);
   setPermanent("plr.tm.interval", "30f"); // = 0.5 seconds
   setPermanent("plr.tm.horizon", "10m"); // = ~10 minutes
+  setPermanent("plr.tm.replay", "false");
+  setPermanent("plr.tm.persist", "false");
   setPermanent("plr.eepromaccess", "false");
 
   // Developer settings
@@ -193,6 +203,8 @@ Settings::Settings()
   setPermanent("dev.tm.uncompressed", 600);
   setPermanent("dev.tm.interval", "1f"); // = 1 frame
   setPermanent("dev.tm.horizon", "30s"); // = ~30 seconds
+  setPermanent("dev.tm.replay", "false");
+  setPermanent("dev.tm.persist", "false");
   // Thumb ARM emulation options
   setPermanent("dev.thumb.trapfatal", "true");
   setPermanent("dev.eepromaccess", "true");
@@ -236,6 +248,10 @@ void Settings::validate()
   f = getFloat("speed");
   if (f <= 0) setValue("speed", "1.0");
 
+  f = getFloat("turbospeed");
+  if (f < 0) setValue("turbospeed", "10.0");
+  else if (f > OSystem::MAX_TURBO_SPEED) setValue("turbospeed", OSystem::MAX_TURBO_SPEED);
+
   i = getInt("tia.aspectn");
   if(i < 80 || i > 120)  setValue("tia.aspectn", "90");
   i = getInt("tia.aspectp");
@@ -300,6 +316,14 @@ void Settings::validate()
   if(i < 0)        setValue("joydeadzone", "0");
   else if(i > 29)  setValue("joydeadzone", "29");
 
+  s = getString("inputlatch");
+  if(s != "poll" && s != "vsync")
+    setValue("inputlatch", "poll");
+
+  i = getInt("runahead");
+  if(i < 0)       setValue("runahead", "0");
+  else if(i > 5)  setValue("runahead", "5");
+
   i = getInt("cursor");
   if(i < 0 || i > 3)
     setValue("cursor", "2");
@@ -369,6 +393,8 @@ void Settings::usage() const
     << "                 z26|\n"
     << "                 user>\n"
     << "  -speed        <number>       Run emulation at the given speed\n"
+    << "  -turbospeed   <number>       Run turbo mode at the given speed (0 = unlimited,\n"
+    << "                                max. 100)\n"
     << "  -uimessages   <1|0>          Show onscreen UI messages for different events\n"
     << endl
   #ifdef SOUND_SUPPORT
@@ -420,9 +446,16 @@ void Settings::usage() const
     << "  -loglevel     <0|1|2>        Set level of logging during application run\n"
     << endl
     << "  -logtoconsole <1|0>          Log output to console/commandline\n"
+    << "  -trace        <file>         Record host-side timing events and write them\n"
+    << "                                to the file as Chrome trace JSON on exit\n"
     << "  -joydeadzone  <number>       Sets 'deadzone' area for analog joysticks (0-29)\n"
     << "  -joyallow4    <1|0>          Allow all 4 directions on a joystick to be\n"
     << "                                pressed simultaneously\n"
+    << "  -inputlatch   <poll|vsync>   Update controllers once per event poll, or\n"
+    << "                                at the start of every emulated frame with\n"
+    << "                                input collected while emulating\n"
+    << "  -runahead     <0-5>          Show frames emulated the given number of frames\n"
+    << "                                ahead to hide input latency\n"
     << "  -usemouse     <always|\n"
     << "                 analog|\n"
     << "                 never>        Use mouse as a controller as specified by ROM\n"
@@ -484,6 +517,9 @@ void Settings::usage() const
     << "                                direction/fire button held down\n"
     << "  -holdjoy1     <U,D,L,R,F>    Start the emulator with the right joystick\n"
     << "                                direction/fire button held down\n"
+    << "  -recordmovie  <file>         Record a movie of the ROM into the given file\n"
+    << "  -playmovie    <file>         Play back the movie from the given file\n"
+    << "  -movieturbo   <1|0>          Play back movies in turbo mode\n"
     << "  -maxres       <WxH>          Used by developers to force the maximum size of\n"
     << "                                the application window\n"
     << "  -help                        Show the text you're now reading\n"
@@ -507,6 +543,8 @@ void Settings::usage() const
     << "   -dbg.ghostreadstrap <1|0>     Debugger traps on 'ghost' reads\n"
     << "   -dbg.uhex      <0|1>          lower-/uppercase HEX display\n"
     << "   -break         <address>      Set a breakpoint at 'address'\n"
+    << "   -cputrace      <file>         Record the executed instructions and write\n"
+    << "                                  the most recent ones to the file on exit\n"
     << "   -debug                        Start in debugger mode\n"
     << endl
     << "   -bs          <arg>          Sets the 'Cartridge.Type' (bankswitch) property\n"
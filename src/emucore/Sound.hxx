@@ -98,6 +98,13 @@ class Sound
     */
     virtual string about() const = 0;
 
+    /**
+      Returns the real time (in seconds) spent generating audio since the
+      last call, for the frame time breakdown. Audio is typically produced
+      on a separate thread, so the default implementation reports nothing.
+    */
+    virtual double consumeCallbackTime() { return 0; }
+
   protected:
     // The OSystem for this sound object
     OSystem& myOSystem;
@@ -25,7 +25,9 @@ Switches::Switches(const Event& event, const Properties& properties,
                    const Settings& settings)
   : myEvent(event),
     mySwitches(0xFF),
-    myIs7800(false)
+    myIs7800(false),
+    myGenerationSwitches(0),
+    myStateGeneration(0)
 {
   if(properties.get(PropType::Console_RightDiff) == "B")
   {
@@ -172,6 +174,17 @@ bool Switches::save(Serializer& out) const
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 Switches::stateGeneration() const
+{
+  if(myStateGeneration == 0 || mySwitches != myGenerationSwitches)
+  {
+    myGenerationSwitches = mySwitches;
+    myStateGeneration = nextStateGeneration();
+  }
+  return myStateGeneration;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Switches::load(Serializer& in)
 {
@@ -78,6 +78,12 @@ class Switches : public Serializable
     */
     bool load(Serializer& in) override;
 
+    /**
+      Answer the state generation (see Serializable), which changes
+      whenever any of the switches has changed.
+    */
+    uInt64 stateGeneration() const override;
+
     /**
       Query the 'Console_TelevisionType' switches bit.
 
@@ -132,6 +138,10 @@ class Switches : public Serializable
     // Are we in 7800 or 2600 mode?
     bool myIs7800;
 
+    // The switches when the state generation was last determined
+    mutable uInt8 myGenerationSwitches;
+    mutable uInt64 myStateGeneration;
+
   private:
     // Following constructors and assignment operators not supported
     Switches() = delete;
@@ -45,7 +45,13 @@ System::System(Random& random, M6502& m6502, M6532& m6532,
   {
     myPageAccessTable[page] = access;
     myPageIsDirtyTable[page] = false;
+#ifdef DEBUGGER_SUPPORT
+    myPageRedirect[page] = nullptr;
+#endif
   }
+#ifdef DEBUGGER_SUPPORT
+  myNumRedirectedPages = 0;
+#endif
 
   // Bus starts out unlocked (in other words, peek() changes myDataBusState)
   myDataBusLocked = false;
@@ -106,65 +112,57 @@ void System::clearDirtyPages()
     myPageIsDirtyTable[i] = false;
 }
 
+#ifdef DEBUGGER_SUPPORT
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt8 System::peek(uInt16 addr, uInt8 flags)
+void System::setPageRedirect(uInt16 addr, Device* device)
 {
-  const PageAccess& access = getPageAccess(addr);
+  const uInt16 page = (addr & ADDRESS_MASK) >> PAGE_SHIFT;
+  if(myPageRedirect[page] == device)
+    return;
 
-#ifdef DEBUGGER_SUPPORT
-  // Set access type
-  if(access.codeAccessBase)
-    *(access.codeAccessBase + (addr & PAGE_MASK)) |= flags;
-  else
-    access.device->setAccessFlags(addr, flags);
-#endif
+  // Restore the accessing methods set by the device
+  if(myPageRedirect[page])
+  {
+    myPageAccessTable[page] = myInstalledPageAccess[page];
+    --myNumRedirectedPages;
+  }
 
-  // See if this page uses direct accessing or not
-  uInt8 result;
-  if(access.directPeekBase)
-    result = *(access.directPeekBase + (addr & PAGE_MASK));
-  else
-    result = access.device->peek(addr);
+  myPageRedirect[page] = device;
+  if(device)
+  {
+    ++myNumRedirectedPages;
+    keepRedirects(page, 1);
+  }
+}
 
-#ifdef DEBUGGER_SUPPORT
-  if(!myDataBusLocked)
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::keepRedirects(uInt16 page, uInt16 numPages)
+{
+  for(const uInt16 end = page + numPages; page < end; ++page)
+  {
+    if(!myPageRedirect[page])
+      continue;
+
+    // All accesses go to the redirected device; only the code access flags
+    // are still set directly by peek() and poke()
+    const PageAccess& installed = myInstalledPageAccess[page] = myPageAccessTable[page];
+    PageAccess access(myPageRedirect[page], installed.type);
+    access.codeAccessBase = installed.codeAccessBase;
+    myPageAccessTable[page] = access;
+  }
+}
 #endif
-    myDataBusState = result;
 
-  return result;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 System::peek(uInt16 addr, uInt8 flags)
+{
+  return peek<Cartridge>(addr, flags);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void System::poke(uInt16 addr, uInt8 value, uInt8 flags)
 {
-  uInt16 page = (addr & ADDRESS_MASK) >> PAGE_SHIFT;
-  const PageAccess& access = myPageAccessTable[page];
-
-#ifdef DEBUGGER_SUPPORT
-  // Set access type
-  if (access.codeAccessBase)
-    *(access.codeAccessBase + (addr & PAGE_MASK)) |= flags;
-  else
-    access.device->setAccessFlags(addr, flags);
-#endif
-
-  // See if this page uses direct accessing or not
-  if(access.directPokeBase)
-  {
-    // Since we have direct access to this poke, we can dirty its page
-    *(access.directPokeBase + (addr & PAGE_MASK)) = value;
-    myPageIsDirtyTable[page] = true;
-  }
-  else
-  {
-    // The specific device informs us if the poke succeeded
-    myPageIsDirtyTable[page] = access.device->poke(addr, value);
-  }
-
-#ifdef DEBUGGER_SUPPORT
-  if(!myDataBusLocked)
-#endif
-    myDataBusState = value;
+  poke<Cartridge>(addr, value, flags);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -210,7 +208,7 @@ bool System::save(Serializer& out) const
       return false;
     if(!myTIA.save(out))
       return false;
-    if(!myCart.save(out))
+    if(!myCartCache.save(myCart, out))
       return false;
     if(!randGenerator().save(out))
       return false;
@@ -219,6 +219,19 @@ class System : public Serializable
     */
     void poke(uInt16 address, uInt8 value, uInt8 flags = 0);
 
+    /**
+      Variants of peek() and poke() for a known type of the cartridge,
+      which are inlined into the caller.  If the cartridge class is final,
+      its peek() and poke() are called without virtual dispatch.
+
+      @param address  The address of the access
+      @param value    The value to be stored at the address
+      @param flags    Indicates that this address has the given flags
+                      for type of access (CODE, DATA, GFX, etc)
+    */
+    template<class CART> uInt8 peek(uInt16 address, uInt8 flags = 0);
+    template<class CART> void poke(uInt16 address, uInt8 value, uInt8 flags = 0);
+
     /**
       Lock/unlock the data bus. When the bus is locked, peek() and
       poke() don't update the bus state. The bus should be unlocked
@@ -314,19 +327,60 @@ class System : public Serializable
       @param access The accessing methods to be used by the page
     */
     void setPageAccess(uInt16 addr, const PageAccess& access) {
-      myPageAccessTable[(addr & ADDRESS_MASK) >> PAGE_SHIFT] = access;
+      const uInt16 page = (addr & ADDRESS_MASK) >> PAGE_SHIFT;
+      myPageAccessTable[page] = access;
+#ifdef DEBUGGER_SUPPORT
+      if(myNumRedirectedPages)
+        keepRedirects(page, 1);
+#endif
     }
 
     /**
-      Get the page accessing method for the specified address.
+      Set the page accessing methods for consecutive pages at once.
+
+      @param addr      The address of the first page
+      @param access    The accessing methods to be used by the pages
+      @param numPages  The number of pages (must not exceed the address space)
+    */
+    void setPageAccess(uInt16 addr, const PageAccess* access, uInt16 numPages) {
+      const uInt16 page = (addr & ADDRESS_MASK) >> PAGE_SHIFT;
+      std::copy_n(access, numPages, &myPageAccessTable[page]);
+#ifdef DEBUGGER_SUPPORT
+      if(myNumRedirectedPages)
+        keepRedirects(page, numPages);
+#endif
+    }
+
+    /**
+      Get the page accessing method for the specified address, as set by
+      the device installed there (even if the page is redirected).
 
       @param addr  The address/page to get accessing methods for
       @return The accessing methods used by the page
     */
     const PageAccess& getPageAccess(uInt16 addr) const {
-      return myPageAccessTable[(addr & ADDRESS_MASK) >> PAGE_SHIFT];
+      const uInt16 page = (addr & ADDRESS_MASK) >> PAGE_SHIFT;
+#ifdef DEBUGGER_SUPPORT
+      if(myPageRedirect[page])
+        return myInstalledPageAccess[page];
+#endif
+      return myPageAccessTable[page];
     }
 
+#ifdef DEBUGGER_SUPPORT
+    /**
+      Redirect all accesses to the page of the specified address to the
+      given device, or remove the redirection if the device is the null
+      pointer.  This is used by the debugger to check the pages containing
+      traps only.  The accessing methods set by the devices are kept (see
+      getPageAccess()), so the device can forward the accesses to them.
+
+      @param addr    The address/page to redirect
+      @param device  The device to redirect to, or the null pointer
+    */
+    void setPageRedirect(uInt16 addr, Device* device);
+#endif
+
     /**
       Get the page type for the given address.
 
@@ -376,6 +430,15 @@ class System : public Serializable
     */
     bool load(Serializer& in) override;
 
+  private:
+#ifdef DEBUGGER_SUPPORT
+    /**
+      Keep the redirection of the given pages after their accessing methods
+      were changed.
+    */
+    void keepRedirects(uInt16 page, uInt16 numPages);
+#endif
+
   private:
     // The system RNG
     Random& myRandom;
@@ -392,6 +455,9 @@ class System : public Serializable
     // Cartridge device attached to the system
     Cartridge& myCart;
 
+    // Reuses the cartridge state while it is unchanged
+    mutable SerializableCache myCartCache;
+
     // Number of system cycles executed since last reset
     uInt64 myCycles;
 
@@ -404,6 +470,15 @@ class System : public Serializable
     // The list of dirty pages
     bool myPageIsDirtyTable[NUM_PAGES];
 
+#ifdef DEBUGGER_SUPPORT
+    // The device each page is redirected to (or the null pointer), the
+    // accessing methods set for the redirected pages by their devices, and
+    // the number of redirected pages (see setPageRedirect())
+    Device* myPageRedirect[NUM_PAGES];
+    PageAccess myInstalledPageAccess[NUM_PAGES];
+    uInt32 myNumRedirectedPages;
+#endif
+
     // The current state of the Data Bus
     uInt8 myDataBusState;
 
@@ -426,4 +501,72 @@ class System : public Serializable
     System& operator=(System&&) = delete;
 };
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<class CART>
+inline uInt8 System::peek(uInt16 addr, uInt8 flags)
+{
+  const PageAccess& access = myPageAccessTable[(addr & ADDRESS_MASK) >> PAGE_SHIFT];
+  CART& cart = static_cast<CART&>(myCart);
+
+#ifdef DEBUGGER_SUPPORT
+  // Set access type
+  if(access.codeAccessBase)
+    *(access.codeAccessBase + (addr & PAGE_MASK)) |= flags;
+  else
+    access.device->setAccessFlags(addr, flags);
+#endif
+
+  // See if this page uses direct accessing or not
+  uInt8 result;
+  if(access.directPeekBase)
+    result = *(access.directPeekBase + (addr & PAGE_MASK));
+  else if(access.device == &cart)
+    result = cart.peek(addr);
+  else
+    result = access.device->peek(addr);
+
+#ifdef DEBUGGER_SUPPORT
+  if(!myDataBusLocked)
+#endif
+    myDataBusState = result;
+
+  return result;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<class CART>
+inline void System::poke(uInt16 addr, uInt8 value, uInt8 flags)
+{
+  uInt16 page = (addr & ADDRESS_MASK) >> PAGE_SHIFT;
+  const PageAccess& access = myPageAccessTable[page];
+  CART& cart = static_cast<CART&>(myCart);
+
+#ifdef DEBUGGER_SUPPORT
+  // Set access type
+  if (access.codeAccessBase)
+    *(access.codeAccessBase + (addr & PAGE_MASK)) |= flags;
+  else
+    access.device->setAccessFlags(addr, flags);
+#endif
+
+  // See if this page uses direct accessing or not
+  if(access.directPokeBase)
+  {
+    // Since we have direct access to this poke, we can dirty its page
+    *(access.directPokeBase + (addr & PAGE_MASK)) = value;
+    myPageIsDirtyTable[page] = true;
+  }
+  else
+  {
+    // The specific device informs us if the poke succeeded
+    myPageIsDirtyTable[page] = access.device == &cart ?
+      cart.poke(addr, value) : access.device->poke(addr, value);
+  }
+
+#ifdef DEBUGGER_SUPPORT
+  if(!myDataBusLocked)
+#endif
+    myDataBusState = value;
+}
+
 #endif
@@ -23,6 +23,7 @@
 #include "Console.hxx"
 #include "TIA.hxx"
 #include "PNGLibrary.hxx"
+#include "Tracer.hxx"
 #include "TIASurface.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -321,6 +322,8 @@ inline uInt32 TIASurface::averageBuffers(uInt32 bufOfs)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIASurface::render()
 {
+  TRACE_SCOPE("TIASurface::render");
+
   uInt32 width  = myTIA->width();
   uInt32 height = myTIA->height();
 
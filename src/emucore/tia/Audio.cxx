@@ -36,7 +36,9 @@ namespace {
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Audio::Audio()
   : myAudioQueue(nullptr),
-    myCurrentFragment(nullptr)
+    myCurrentFragment(nullptr),
+    mySampleIndex(0),
+    myOutputEnabled(true)
 {
   for (uInt8 i = 0; i <= 0x1e; ++i) myMixingTableSum[i] = mixingTableEntry(i, 0x1e);
   for (uInt8 i = 0; i <= 0x0f; ++i) myMixingTableIndividual[i] = mixingTableEntry(i, 0x0f);
@@ -89,7 +91,7 @@ void Audio::phase1()
   uInt8 sample0 = myChannel0.phase1();
   uInt8 sample1 = myChannel1.phase1();
 
-  if (!myAudioQueue) return;
+  if (!myAudioQueue || !myOutputEnabled) return;
 
   if (myAudioQueue->isStereo()) {
     myCurrentFragment[2*mySampleIndex] = myMixingTableIndividual[sample0];
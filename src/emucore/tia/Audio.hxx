@@ -33,6 +33,8 @@ class Audio : public Serializable
 
     void setAudioQueue(shared_ptr<AudioQueue> queue);
 
+    void enableOutput(bool enabled) { myOutputEnabled = enabled; }
+
     void tick();
 
     AudioChannel& channel0();
@@ -62,6 +64,9 @@ class Audio : public Serializable
     Int16* myCurrentFragment;
     uInt32 mySampleIndex;
 
+    // If disabled, samples are generated but not pushed to the queue
+    bool myOutputEnabled;
+
   private:
     Audio(const Audio&) = delete;
     Audio(Audio&&) = delete;
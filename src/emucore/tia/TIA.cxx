@@ -17,6 +17,7 @@
 
 #include "TIA.hxx"
 #include "M6502.hxx"
+#include "M6532.hxx"
 #include "Control.hxx"
 #include "Paddles.hxx"
 #include "DelayQueueIteratorImpl.hxx"
@@ -24,6 +25,7 @@
 #include "frame-manager/FrameManager.hxx"
 #include "AudioQueue.hxx"
 #include "DispatchResult.hxx"
+#include "Tracer.hxx"
 
 #ifdef DEBUGGER_SUPPORT
   #include "CartDebug.hxx"
@@ -88,6 +90,8 @@ TIA::TIA(ConsoleIO& console, ConsoleTimingProvider timingProvider, Settings& set
   myMissile1.setTIA(this);
   myBall.setTIA(this);
 
+  myLatchInputOnVsync = settings.getString("inputlatch") == "vsync";
+
   reset();
 }
 
@@ -873,6 +877,8 @@ void TIA::applyDeveloperSettings()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::update(DispatchResult& result, uInt64 maxCycles)
 {
+  TRACE_SCOPE("TIA::update");
+
   mySystem->m6502().execute(maxCycles, result);
 
   updateEmulation();
@@ -1208,6 +1214,12 @@ void TIA::onFrameStart()
 {
   myXAtRenderingStart = 0;
 
+  // Pick up the input state published by the event handler right at VSYNC
+  // (which keeps collecting input while the emulation runs), instead of
+  // relying only on the latch at the start of the timeslice
+  if (myLatchInputOnVsync)
+    mySystem->m6532().update();
+
   // Check for colour-loss emulation
   if (myColorLossEnabled)
   {
@@ -131,6 +131,19 @@ class TIA : public Device
     */
     void setAudioQueue(shared_ptr<AudioQueue> audioQueue);
 
+    /**
+      Enable or disable pushing audio samples to the audio queue (used to
+      keep speculative emulation, e.g. run-ahead, inaudible).
+    */
+    void enableAudioOutput(bool enabled) { myAudio.enableOutput(enabled); }
+
+    /**
+      Enable or disable updating the controllers and switches at the start
+      of each frame (initially taken from the 'inputlatch' setting).
+    */
+    void setInputLatchOnVsync(bool enabled) { myLatchInputOnVsync = enabled; }
+    bool inputLatchOnVsync() const { return myLatchInputOnVsync; }
+
     /**
       Clear the configured frame manager and deteach the lifecycle callbacks.
      */
@@ -875,6 +888,12 @@ class TIA : public Device
     bool myColorLossEnabled;
     bool myColorLossActive;
 
+    /**
+     * Indicates if controllers and switches are updated at the start of each
+     * frame on the emulation thread (see 'inputlatch').
+     */
+    bool myLatchInputOnVsync;
+
     /**
      * System cycles at the end of the previous frame / beginning of next frame.
      */
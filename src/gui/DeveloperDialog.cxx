@@ -471,6 +471,16 @@ void DeveloperDialog::addTimeMachineTab(const GUI::Font& font)
   myStateHorizonWidget = new PopUpWidget(myTab, font, HBORDER + INDENT * 2, ypos, pwidth,
                                          lineHeight, items, "Horizon         ~ ", 0, kHorizonChanged);
   wid.push_back(myStateHorizonWidget);
+  ypos += lineHeight + VGAP;
+
+  myStateReplayWidget = new CheckboxWidget(myTab, font, HBORDER + INDENT * 2, ypos + 1,
+                                           "Replay input between keyframes (*)");
+  wid.push_back(myStateReplayWidget);
+  ypos += lineHeight + VGAP;
+
+  myStatePersistWidget = new CheckboxWidget(myTab, font, HBORDER + INDENT * 2, ypos + 1,
+                                            "Keep buffer across sessions");
+  wid.push_back(myStatePersistWidget);
 
   // Add message concerning usage
   const GUI::Font& infofont = instance().frameBuffer().infoFont();
@@ -625,6 +635,8 @@ void DeveloperDialog::loadSettings(SettingsSet set)
   myUncompressed[set] = instance().settings().getInt(prefix + "tm.uncompressed");
   myStateInterval[set] = instance().settings().getString(prefix + "tm.interval");
   myStateHorizon[set] = instance().settings().getString(prefix + "tm.horizon");
+  myStateReplay[set] = instance().settings().getBool(prefix + "tm.replay");
+  myStatePersist[set] = instance().settings().getBool(prefix + "tm.persist");
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -686,6 +698,8 @@ void DeveloperDialog::saveSettings(SettingsSet set)
   instance().settings().setValue(prefix + "tm.uncompressed", myUncompressed[set]);
   instance().settings().setValue(prefix + "tm.interval", myStateInterval[set]);
   instance().settings().setValue(prefix + "tm.horizon", myStateHorizon[set]);
+  instance().settings().setValue(prefix + "tm.replay", myStateReplay[set]);
+  instance().settings().setValue(prefix + "tm.persist", myStatePersist[set]);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -738,6 +752,8 @@ void DeveloperDialog::getWidgetStates(SettingsSet set)
   myStateInterval[set] = myStateIntervalWidget->getSelected();
   myStateInterval[set] = myStateIntervalWidget->getSelectedTag().toString();
   myStateHorizon[set] = myStateHorizonWidget->getSelectedTag().toString();
+  myStateReplay[set] = myStateReplayWidget->getState();
+  myStatePersist[set] = myStatePersistWidget->getState();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -785,6 +801,8 @@ void DeveloperDialog::setWidgetStates(SettingsSet set)
   myUncompressedWidget->setValue(myUncompressed[set]);
   myStateIntervalWidget->setSelected(myStateInterval[set]);
   myStateHorizonWidget->setSelected(myStateHorizon[set]);
+  myStateReplayWidget->setState(myStateReplay[set]);
+  myStatePersistWidget->setState(myStatePersist[set]);
 
   handleTimeMachine();
   handleSize();
@@ -973,6 +991,8 @@ void DeveloperDialog::setDefaults()
       myUncompressed[set] = devSettings ? 600 : 60;
       myStateInterval[set] = devSettings ? "1f" : "30f";
       myStateHorizon[set] = devSettings ? "30s" : "10m";
+      myStateReplay[set] = false;
+      myStatePersist[set] = false;
 
       setWidgetStates(set);
       break;
@@ -1198,6 +1218,8 @@ void DeveloperDialog::handleTimeMachine()
   myStateSizeWidget->setEnabled(enable);
   myUncompressedWidget->setEnabled(enable);
   myStateIntervalWidget->setEnabled(enable);
+  myStateReplayWidget->setEnabled(enable);
+  myStatePersistWidget->setEnabled(enable);
 
   uInt32 size = myStateSizeWidget->getValue();
   uInt32 uncompressed = myUncompressedWidget->getValue();
@@ -134,6 +134,8 @@ class DeveloperDialog : public Dialog
     SliderWidget*       myUncompressedWidget;
     PopUpWidget*        myStateIntervalWidget;
     PopUpWidget*        myStateHorizonWidget;
+    CheckboxWidget*     myStateReplayWidget;
+    CheckboxWidget*     myStatePersistWidget;
 
 #ifdef DEBUGGER_SUPPORT
     // Debugger UI widgets
@@ -176,6 +178,8 @@ class DeveloperDialog : public Dialog
     int     myUncompressed[2];
     string  myStateInterval[2];
     string  myStateHorizon[2];
+    bool    myStateReplay[2];
+    bool    myStatePersist[2];
 
   private:
     void addEmulationTab(const GUI::Font& font);
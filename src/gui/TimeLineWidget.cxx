@@ -27,6 +27,7 @@
 
 const int HANDLE_W = 3;
 const int HANDLE_H = 3; // size above/below the slider
+const int THUMB_GAP = 4; // space between/below the thumbnails
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TimeLineWidget::TimeLineWidget(GuiObject* boss, const GUI::Font& font,
@@ -37,7 +38,10 @@ TimeLineWidget::TimeLineWidget(GuiObject* boss, const GUI::Font& font,
     _valueMin(0),
     _valueMax(0),
     _isDragging(false),
-    _labelWidth(labelWidth)
+    _labelWidth(labelWidth),
+    _thumbW(0),
+    _thumbH(0),
+    _thumbAreaH(0)
 {
   _flags = Widget::FLAG_ENABLED | Widget::FLAG_TRACK_MOUSE;
   _bgcolor = kDlgColor;
@@ -102,6 +106,43 @@ void TimeLineWidget::setStepValues(const IntArray& steps)
     _stepValue.push_back(0);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TimeLineWidget::setThumbnailSize(uInt32 w, uInt32 h)
+{
+  _thumbW = w;
+  _thumbH = h;
+  _thumbAreaH = thumbnailAreaHeight(h);
+
+  uInt32 slots = (_w - _labelWidth + THUMB_GAP) / (w * 2 + 2 + THUMB_GAP);
+  _thumbnails.assign(slots, ByteArray());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 TimeLineWidget::thumbnailAreaHeight(uInt32 h)
+{
+  // Thumbnail, its frame and the gap to the timeline
+  return h * 2 + 2 + THUMB_GAP;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 TimeLineWidget::getThumbnailValue(uInt32 slot)
+{
+  // Use the state closest to the center of the slot
+  uInt32 slotW = (_w - _labelWidth) / numThumbnails();
+
+  return posToValue(slot * slotW + slotW / 2);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TimeLineWidget::setThumbnail(uInt32 slot, const ByteArray& pixels)
+{
+  if(slot < _thumbnails.size() && pixels != _thumbnails[slot])
+  {
+    _thumbnails[slot] = pixels;
+    setDirty();
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TimeLineWidget::handleMouseMoved(int x, int y)
 {
@@ -147,30 +188,65 @@ void TimeLineWidget::drawWidget(bool hilite)
 
   // Draw the label, if any
   if(_labelWidth > 0)
-    s.drawString(_font, _label, _x, _y + 2, _labelWidth,
+    s.drawString(_font, _label, _x, _y + _thumbAreaH + 2, _labelWidth,
                  isEnabled() ? kTextColor : kColor, TextAlign::Left);
 
   int p = valueToPos(_value),
     x = _x + _labelWidth,
-    w = _w - _labelWidth;
+    w = _w - _labelWidth,
+    // The timeline itself is drawn below the thumbnails
+    y = _y + _thumbAreaH,
+    h = _h - _thumbAreaH;
+
+  // Draw the thumbnails, skipping slots which show the same state as the
+  // previous one; the one of the current state is framed
+  if(numThumbnails() > 0)
+  {
+    const int tw = _thumbW * 2, th = _thumbH * 2;
+    const int slotW = w / numThumbnails();
+    uInt32 prevValue = _valueMax + 1;
+
+    for(uInt32 i = 0; i < numThumbnails(); ++i)
+    {
+      const uInt32 value = getThumbnailValue(i);
+      if(value == prevValue)
+        continue;
+      prevValue = value;
+
+      const int tx = x + i * slotW + (slotW - tw) / 2;
+      const ByteArray& pixels = _thumbnails[i];
+
+      if(pixels.size() == _thumbW * _thumbH)
+      {
+        for(uInt32 ty = 0; ty < _thumbH; ++ty)
+          for(uInt32 px = 0; px < _thumbW; ++px)
+            s.fillRect(tx + px * 2, _y + 1 + ty * 2, 2, 2, ColorId(pixels[ty * _thumbW + px]));
+      }
+      else
+        s.fillRect(tx, _y + 1, tw, th, kBGColorLo);
+
+      if(value == _value)
+        s.frameRect(tx - 1, _y, tw + 2, th + 2, kColorInfo);
+    }
+  }
 
   // Frame the handle
   const int HANDLE_W2 = (HANDLE_W + 1) / 2;
-  s.hLine(x + p - HANDLE_W2, _y + 0, x + p - HANDLE_W2 + HANDLE_W, kColorInfo);
-  s.vLine(x + p - HANDLE_W2, _y + 1, _y + _h - 2, kColorInfo);
-  s.hLine(x + p - HANDLE_W2 + 1, _y + _h - 1, x + p - HANDLE_W2 + 1 + HANDLE_W, kBGColor);
-  s.vLine(x + p - HANDLE_W2 + 1 + HANDLE_W, _y + 1, _y + _h - 2, kBGColor);
+  s.hLine(x + p - HANDLE_W2, y + 0, x + p - HANDLE_W2 + HANDLE_W, kColorInfo);
+  s.vLine(x + p - HANDLE_W2, y + 1, y + h - 2, kColorInfo);
+  s.hLine(x + p - HANDLE_W2 + 1, y + h - 1, x + p - HANDLE_W2 + 1 + HANDLE_W, kBGColor);
+  s.vLine(x + p - HANDLE_W2 + 1 + HANDLE_W, y + 1, y + h - 2, kBGColor);
   // Frame the box
-  s.hLine(x, _y + HANDLE_H, x + w - 2, kColorInfo);
-  s.vLine(x, _y + HANDLE_H, _y + _h - 2 - HANDLE_H, kColorInfo);
-  s.hLine(x + 1, _y + _h - 1 - HANDLE_H, x + w - 1, kBGColor);
-  s.vLine(x + w - 1, _y + 1 + HANDLE_H, _y + _h - 2 - HANDLE_H, kBGColor);
+  s.hLine(x, y + HANDLE_H, x + w - 2, kColorInfo);
+  s.vLine(x, y + HANDLE_H, y + h - 2 - HANDLE_H, kColorInfo);
+  s.hLine(x + 1, y + h - 1 - HANDLE_H, x + w - 1, kBGColor);
+  s.vLine(x + w - 1, y + 1 + HANDLE_H, y + h - 2 - HANDLE_H, kBGColor);
 
   // Fill the box
-  s.fillRect(x + 1, _y + 1 + HANDLE_H, w - 2, _h - 2 - HANDLE_H * 2,
+  s.fillRect(x + 1, y + 1 + HANDLE_H, w - 2, h - 2 - HANDLE_H * 2,
              !isEnabled() ? kSliderBGColorLo : hilite ? kSliderBGColorHi : kSliderBGColor);
   // Draw the 'bar'
-  s.fillRect(x + 1, _y + 1 + HANDLE_H, p, _h - 2 - HANDLE_H * 2,
+  s.fillRect(x + 1, y + 1 + HANDLE_H, p, h - 2 - HANDLE_H * 2,
              !isEnabled() ? kColor : hilite ? kSliderColorHi : kSliderColor);
 
   // Add 4 tickmarks for 5 intervals
@@ -197,11 +273,11 @@ void TimeLineWidget::drawWidget(bool hilite)
         else
           color = kSliderBGColorLo;
       }
-      s.vLine(xt, _y + _h / 2, _y + _h - 2 - HANDLE_H, color);
+      s.vLine(xt, y + h / 2, y + h - 2 - HANDLE_H, color);
     }
   }
   // Draw the handle
-  s.fillRect(x + p + 1 - HANDLE_W2, _y + 1, HANDLE_W, _h - 2,
+  s.fillRect(x + p + 1 - HANDLE_W2, y + 1, HANDLE_W, h - 2,
              !isEnabled() ? kColor : hilite ? kSliderColorHi : kSliderColor);
 }
 
@@ -41,6 +41,31 @@ class TimeLineWidget : public ButtonWidget
     */
     void setStepValues(const IntArray& steps);
 
+    /**
+      Use the top of the widget for thumbnails of some states, evenly
+      spread over the timeline.  Each thumbnail pixel is drawn as 2x2 pixels.
+
+      @param w  The width of a thumbnail, in thumbnail pixels
+      @param h  The height of a thumbnail, in thumbnail pixels
+    */
+    void setThumbnailSize(uInt32 w, uInt32 h);
+
+    /**
+      Get the height needed above the timeline for thumbnails of height h.
+    */
+    static uInt32 thumbnailAreaHeight(uInt32 h);
+
+    /**
+      Get the number of thumbnails shown, and the value (state) of each.
+    */
+    uInt32 numThumbnails() const { return uInt32(_thumbnails.size()); }
+    uInt32 getThumbnailValue(uInt32 slot);
+
+    /**
+      Set the thumbnail of a slot, as w * h palette indices (or none at all).
+    */
+    void setThumbnail(uInt32 slot, const ByteArray& pixels);
+
   protected:
     void handleMouseMoved(int x, int y) override;
     void handleMouseDown(int x, int y, MouseButton b, int clickCount) override;
@@ -60,6 +85,10 @@ class TimeLineWidget : public ButtonWidget
 
     uIntArray _stepValue;
 
+    uInt32  _thumbW, _thumbH;
+    uInt32  _thumbAreaH;  // height of the thumbnail area above the timeline
+    vector<ByteArray> _thumbnails;
+
   private:
     // Following constructors and assignment operators not supported
     TimeLineWidget() = delete;
@@ -169,19 +169,20 @@ TimeMachineDialog::TimeMachineDialog(OSystem& osystem, DialogContainer& parent,
   const int H_BORDER = 6, BUTTON_GAP = 4, V_BORDER = 4;
   const int buttonWidth = BUTTON_W + 10,
             buttonHeight = BUTTON_H + 10,
-            rowHeight = font.getLineHeight();
+            rowHeight = font.getLineHeight(),
+            thumbHeight = TimeLineWidget::thumbnailAreaHeight(RewindManager::THUMBNAIL_H);
 
   int xpos, ypos;
 
   // Set real dimensions
   _w = width;  // Parent determines our width (based on window size)
-  _h = V_BORDER * 2 + rowHeight + buttonHeight + 2;
+  _h = V_BORDER * 2 + thumbHeight + rowHeight + buttonHeight + 2;
 
   this->clearFlags(Widget::FLAG_CLEARBG); // does only work combined with blending (0..100)!
   this->clearFlags(Widget::FLAG_BORDER);
 
   xpos = H_BORDER;
-  ypos = V_BORDER;
+  ypos = V_BORDER + thumbHeight;
 
   // Add index info
   myCurrentIdxWidget = new StaticTextWidget(this, font, xpos, ypos, "1000", TextAlign::Left, kBGColor);
@@ -195,8 +196,10 @@ TimeMachineDialog::TimeMachineDialog(OSystem& osystem, DialogContainer& parent,
     tl_x = xpos + myCurrentIdxWidget->getWidth() + 8,
     tl_y = ypos + (myCurrentIdxWidget->getHeight() - tl_h) / 2 - 1,
     tl_w = myLastIdxWidget->getAbsX() - tl_x - 8;
-  myTimeline = new TimeLineWidget(this, font, tl_x, tl_y, tl_w, tl_h, "", 0, kTimeline);
+  myTimeline = new TimeLineWidget(this, font, tl_x, tl_y - thumbHeight, tl_w, tl_h + thumbHeight,
+                                  "", 0, kTimeline);
   myTimeline->setMinValue(0);
+  myTimeline->setThumbnailSize(RewindManager::THUMBNAIL_W, RewindManager::THUMBNAIL_H);
   ypos += rowHeight;
 
   // Add time info
@@ -257,6 +260,7 @@ void TimeMachineDialog::loadConfig()
   uInt32 maxValue = cycles.size() > 1 ? uInt32(cycles.size() - 1) : 0;
   myTimeline->setMaxValue(maxValue);
   myTimeline->setStepValues(cycles);
+  updateThumbnails();
 
   // Enable blending (only once is necessary)
   if(!surface().attributes().blending)
@@ -418,6 +422,20 @@ void TimeMachineDialog::handleWinds(Int32 numWinds)
   myUnwind1Widget->setEnabled(!r.atLast());
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TimeMachineDialog::updateThumbnails()
+{
+  RewindManager& r = instance().state().rewindManager();
+  ByteArray thumb;
+
+  for(uInt32 i = 0; i < myTimeline->numThumbnails(); ++i)
+  {
+    if(!r.getThumbnail(myTimeline->getThumbnailValue(i), thumb))
+      thumb.clear();
+    myTimeline->setThumbnail(i, thumb);
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TimeMachineDialog::handleToggle()
 {
@@ -49,6 +49,8 @@ class TimeMachineDialog : public Dialog
     void handleWinds(Int32 numWinds = 0);
     /** toggle Time Machine mode */
     void handleToggle();
+    /** update the thumbnails shown in the timeline */
+    void updateThumbnails();
 
   private:
     enum
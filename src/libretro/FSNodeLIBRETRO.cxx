@@ -32,6 +32,13 @@ FilesystemNodeLIBRETRO::FilesystemNodeLIBRETRO()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 FilesystemNodeLIBRETRO::FilesystemNodeLIBRETRO(const string& p)
 {
+  _displayName = p;
+  _path = p;
+
+  _isDirectory = false;
+  _isFile = true;
+  _isPseudoRoot = false;
+  _isValid = true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -98,6 +98,11 @@ class FrameBufferLIBRETRO : public FrameBuffer
     */
     void clear() override { }
 
+    /**
+      The frontend controls the display, its refresh rate is unknown here
+    */
+    uInt32 refreshRate() const override { return 0; }
+
   protected:
     //////////////////////////////////////////////////////////////////////
     // The following are derived from protected methods in FrameBuffer.hxx
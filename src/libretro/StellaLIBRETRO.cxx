@@ -52,6 +52,8 @@ StellaLIBRETRO::StellaLIBRETRO()
 
   rom_image = make_unique<uInt8[]>(getROMMax());
 
+  state_size = 0;
+
   system_ready = false;
 }
 
@@ -151,6 +153,7 @@ void StellaLIBRETRO::destroy()
 
   video_ready = false;
   audio_samples = 0;
+  state_size = 0;
 
   myOSystem.reset();
 }
@@ -210,6 +213,7 @@ void StellaLIBRETRO::updateVideo()
 
     tia.renderToFrameBuffer();
     frame.updateInEmulationMode(0);
+    myOSystem->fpsMeter().commitFrameTimes();
   }
 }
 
@@ -222,9 +226,7 @@ void StellaLIBRETRO::updateAudio()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool StellaLIBRETRO::loadState(const void* data, size_t size)
 {
-  Serializer state;
-
-  state.putByteArray(reinterpret_cast<const uInt8*>(data), static_cast<uInt32>(size));
+  Serializer state(static_cast<const uInt8*>(data), size);
 
   if(!myOSystem->state().loadState(state))
     return false;
@@ -236,27 +238,32 @@ bool StellaLIBRETRO::loadState(const void* data, size_t size)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool StellaLIBRETRO::saveState(void* data, size_t size)
 {
-  Serializer state;
+  Serializer state(static_cast<uInt8*>(data), size);
 
   if (!myOSystem->state().saveState(state))
     return false;
 
-  if (state.size() > size)
-    return false;
-
-  state.getByteArray(reinterpret_cast<uInt8*>(data), static_cast<uInt32>(state.size()));
+  // keep the unused rest deterministic, frontends may compare states
+  memset(static_cast<uInt8*>(data) + state.size(), 0, size - state.size());
   return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 size_t StellaLIBRETRO::getStateSize()
 {
-  Serializer state;
+  if (!state_size)
+  {
+    // the state size only depends on the cart type and devices, so it is
+    // determined once per console; the padding covers variable-sized parts
+    Serializer state;
 
-  if (!myOSystem->state().saveState(state))
-    return 0;
+    if (!myOSystem->state().saveState(state))
+      return 0;
+
+    state_size = (state.size() + STATE_SIZE_PADDING + 1023) & ~size_t(1023);
+  }
 
-  return state.size();
+  return state_size;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
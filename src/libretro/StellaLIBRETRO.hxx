@@ -155,6 +155,10 @@ class StellaLIBRETRO
 
     uInt8 system_ram[128];
 
+    // upper bound of the state size, 0 until determined
+    size_t state_size;
+    static constexpr size_t STATE_SIZE_PADDING = 1024;
+
   private:
     string video_palette;
     string video_phosphor;
@@ -0,0 +1,168 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+/**
+  Records a movie of a mouse controlled paddle and plays it back, checking
+  that the paddle moves while recording and is replayed exactly.  Built
+  and run with 'make test' in src/libretro, against the core objects of
+  the libretro port (which needs no display or input devices).
+*/
+
+#include <cstdio>
+#include <cstring>
+
+#include "bspf.hxx"
+#include "OSystemLIBRETRO.hxx"
+#include "Console.hxx"
+#include "Control.hxx"
+#include "DispatchResult.hxx"
+#include "EmulationTiming.hxx"
+#include "EventHandler.hxx"
+#include "FSNode.hxx"
+#include "Settings.hxx"
+#include "StateManager.hxx"
+#include "TIA.hxx"
+
+namespace {
+  // A 2K ROM which only generates frames:
+  //   sei / cld / ldx #$ff / txs
+  //   frame: lda #2 / sta VSYNC / sta WSYNC (3x) / lda #0 / sta VSYNC
+  //          ldx #0 / line: sta WSYNC / dex / bne line / jmp frame
+  const uInt8 ourCode[] = {
+    0x78, 0xd8, 0xa2, 0xff, 0x9a,
+    0xa9, 0x02, 0x85, 0x00, 0x85, 0x02, 0x85, 0x02, 0x85, 0x02,
+    0xa9, 0x00, 0x85, 0x00,
+    0xa2, 0x00, 0x85, 0x02, 0xca, 0xd0, 0xfb, 0x4c, 0x05, 0xf8
+  };
+  constexpr uInt32 ROM_SIZE = 2048;
+
+  constexpr uInt32 FRAMES = 60;
+
+  // Makes the input methods of the event handler accessible
+  struct EventInput : public EventHandler {
+    using EventHandler::handleMouseMotionEvent;
+  };
+
+  int failures = 0;
+
+  void check(bool condition, const string& message)
+  {
+    if(!condition)
+    {
+      cerr << "FAILED: " << message << endl;
+      ++failures;
+    }
+  }
+
+  // Emulate up to the end of the current frame
+  void runFrame(Console& console)
+  {
+    TIA& tia = console.tia();
+    DispatchResult result;
+
+    while(!tia.newFramePending())
+      tia.update(result, console.emulationTiming().maxCyclesPerTimeslice());
+    tia.renderToFrameBuffer();
+  }
+
+  Int32 paddle(Console& console)
+  {
+    return console.leftController().read(Controller::AnalogPin::Nine);
+  }
+}
+
+// The libretro file system node reads the ROM through this function
+uInt32 libretro_read_rom(void* data)
+{
+  uInt8* rom = static_cast<uInt8*>(data);
+
+  memset(rom, 0xea, ROM_SIZE);
+  memcpy(rom, ourCode, sizeof(ourCode));
+  rom[0x7fc] = rom[0x7fe] = 0x00;  // reset and break vectors: $f800
+  rom[0x7fd] = rom[0x7ff] = 0xf8;
+
+  return ROM_SIZE;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int main()
+{
+  const string movie = "movietest.stm";
+
+  OSystemLIBRETRO osystem;
+  osystem.create();
+  osystem.settings().setValue("lc", "PADDLES");
+  osystem.settings().setValue("usemouse", "always");
+
+  if(osystem.createConsole(FilesystemNode("rom")) != EmptyString)
+  {
+    cerr << "FAILED: couldn't create the console" << endl;
+    return 1;
+  }
+  Console& console = osystem.console();
+  EventHandler& handler = osystem.eventHandler();
+  auto moveMouse = &EventInput::handleMouseMotionEvent;
+
+  // The first motion after a video mode change is discarded
+  (handler.*moveMouse)(0, 0, 1, 0);
+  handler.poll(0);
+  runFrame(console);
+
+  check(osystem.state().startMovieRecording(movie), "start recording");
+
+  // Move the mouse in two polls per frame, as happens when the frame rate
+  // of the display is higher than the one of the game
+  vector<Int32> recorded;
+  for(uInt32 frame = 0; frame < FRAMES; ++frame)
+  {
+    const int dx = frame < FRAMES / 2 ? 3 : -2;
+    for(int poll = 0; poll < 2; ++poll)
+    {
+      (handler.*moveMouse)(0, 0, dx, 0);
+      handler.poll(0);
+    }
+    runFrame(console);
+    recorded.push_back(paddle(console));
+  }
+  osystem.state().stopMovie();
+
+  check(recorded[FRAMES / 2 - 1] != recorded[0], "the paddle moves while recording");
+  check(recorded[FRAMES - 1] != recorded[FRAMES / 2 - 1], "the paddle moves back");
+
+  // Played back without any mouse motion, the paddle must follow the
+  // recording exactly
+  check(osystem.state().startMoviePlayback(movie), "start playback");
+  for(uInt32 frame = 0; frame < FRAMES; ++frame)
+  {
+    handler.poll(0);
+    runFrame(console);
+    if(paddle(console) != recorded[frame])
+    {
+      check(false, "paddle replayed in frame " + std::to_string(frame));
+      break;
+    }
+  }
+  osystem.state().stopMovie();
+
+  std::remove(movie.c_str());
+
+  if(failures)
+    return 1;
+
+  cout << "movie test passed" << endl;
+  return 0;
+}
@@ -0,0 +1,102 @@
+/**
+  Simple program that converts a binary CPU trace, as written by the
+  debugger's 'savecputrace' command or the '-cputrace' commandline option,
+  into text (one executed instruction per line)
+*/
+
+#include <iomanip>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <cstring>
+#include <cctype>
+using namespace std;
+
+using uInt8 = unsigned char;
+using uInt32 = unsigned int;
+using uInt64 = unsigned long long;
+
+// Read a little endian value
+uInt64 get(const uInt8* in, int size)
+{
+  uInt64 value = 0;
+  for(int i = size - 1; i >= 0; --i)
+    value = (value << 8) | in[i];
+
+  return value;
+}
+
+int main(int ac, char* av[])
+{
+  if(ac < 2)
+  {
+    cout << av[0] << " <INPUT_FILE>" << endl
+         << endl
+         << "  Read a CPU trace recorded by Stella from INPUT_FILE, and write" << endl
+         << "  the executed instructions to standard output, oldest first." << endl
+         << endl;
+    return 0;
+  }
+
+  ifstream in(av[1], ios::binary);
+  if(!in.is_open())
+  {
+    cerr << "Couldn't open '" << av[1] << "'" << endl;
+    return 1;
+  }
+
+  uInt8 header[32];
+  if(!in.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+     memcmp(header, "STCT", 4) != 0 || get(header + 4, 2) != 1)
+  {
+    cerr << "'" << av[1] << "' is not a CPU trace (version 1)" << endl;
+    return 1;
+  }
+
+  const uInt32 recordSize = uInt32(get(header + 6, 2));
+  const uInt64 records = get(header + 8, 8);
+  const uInt64 dropped = get(header + 16, 8);
+  uInt64 cycles = get(header + 24, 8);
+
+  cout << "; " << records << " instructions";
+  if(dropped)
+    cout << " (" << dropped << " older ones were overwritten)";
+  cout << endl
+       << ";       cycle scanline clock bank   PC  A  X  Y SP NV-BDIZC" << endl;
+
+  unique_ptr<uInt8[]> record = make_unique<uInt8[]>(recordSize);
+  uInt32 lastCycles = uInt32(cycles);
+
+  for(uInt64 i = 0; i < records; ++i)
+  {
+    if(!in.read(reinterpret_cast<char*>(record.get()), recordSize))
+    {
+      cerr << "Trace ends after " << i << " instructions" << endl;
+      return 1;
+    }
+
+    // Only the lower 32 bits of the cycle count are stored
+    const uInt32 low = uInt32(get(record.get(), 4));
+    cycles += uInt32(low - lastCycles);
+    lastCycles = low;
+
+    const uInt8 ps = record[15];
+    char flags[9] = "NV-BDIZC";
+    for(int bit = 0; bit < 8; ++bit)
+      if(!(ps & (0x80 >> bit)) && flags[bit] != '-')
+        flags[bit] = char(tolower(flags[bit]));
+
+    cout << dec << setfill(' ')
+         << setw(13) << cycles
+         << setw(9) << get(record.get() + 8, 2)
+         << setw(6) << get(record.get() + 10, 1)
+         << setw(5) << get(record.get() + 6, 2)
+         << hex << setfill('0')
+         << " $" << setw(4) << get(record.get() + 4, 2);
+    for(int reg = 11; reg < 15; ++reg)
+      cout << " " << setw(2) << int(record[reg]);
+    cout << " " << flags << endl;
+  }
+
+  return 0;
+}